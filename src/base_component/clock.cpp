@@ -4,10 +4,14 @@
 
 #include "clock.h"
 
+#include <algorithm>
+
 namespace pimsim {
 
 Clock::Clock(const sc_core::sc_module_name& name, double period)
-    : sc_core::sc_module(name), period_(period) {
+    : sc_core::sc_module(name), period_(period, sc_core::SC_NS) {
+    pos_edge_events_.reserve(64);
+
     SC_THREAD(process)
 
     SC_METHOD(endPosEdge)
@@ -16,11 +20,15 @@ Clock::Clock(const sc_core::sc_module_name& name, double period)
 
 void Clock::process() {
     while (true) {
-        wait(period_, sc_core::SC_NS);
+        // no register needs a positive edge, sleep until one asks for it instead of ticking every period
+        if (pos_edge_events_.empty()) {
+            wait(wake_up_);
+        }
+        wait(getNextPosEdgeTime() - sc_core::sc_time_stamp());
 
         // at positive edge
         is_pos_edge_ = true;
-        for (const auto& event : pos_edge_events_) {
+        for (auto* event : pos_edge_events_) {
             event->notify();
         }
         pos_edge_events_.clear();
@@ -33,7 +41,13 @@ void Clock::process() {
 }
 
 void Clock::notifyNextPosEdge(sc_core::sc_event* event) {
-    pos_edge_events_.insert(event);
+    if (std::find(pos_edge_events_.begin(), pos_edge_events_.end(), event) != pos_edge_events_.end()) {
+        return;
+    }
+    pos_edge_events_.push_back(event);
+    if (pos_edge_events_.size() == 1) {
+        wake_up_.notify();
+    }
 }
 
 bool Clock::posEdge() const {
@@ -44,4 +58,14 @@ void Clock::endPosEdge() {
     is_pos_edge_ = false;
 }
 
+// A register asking exactly at a positive edge is served at the following one. The former clock ticked in the first
+// evaluation phase of every edge time, so it served a request made there at the same edge only if the requester
+// happened to run before it, while a request from any later delta cycle went to the following edge. The registers
+// and FSMs ask from methods triggered by signal updates or delta notifications, which always run in a later delta
+// cycle, so they see the same edges as before.
+sc_core::sc_time Clock::getNextPosEdgeTime() const {
+    auto cycle = sc_core::sc_time_stamp().value() / period_.value();
+    return period_ * static_cast<double>(cycle + 1);
+}
+
 }  // namespace pim
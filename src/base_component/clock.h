@@ -3,7 +3,7 @@
 //
 
 #pragma once
-#include <set>
+#include <vector>
 
 #include "systemc.h"
 
@@ -27,11 +27,16 @@ public:
 private:
     void endPosEdge();
 
+    // the first positive edge strictly after current time, positive edges are at whole multiples of period
+    sc_core::sc_time getNextPosEdgeTime() const;
+
 private:
-    std::set<sc_core::sc_event*> pos_edge_events_;
+    // events to notify at next positive edge, cleared without releasing its storage
+    std::vector<sc_core::sc_event*> pos_edge_events_;
+    sc_core::sc_event wake_up_;
     sc_core::sc_event end_pos_edge_;
     bool is_pos_edge_ = false;
-    double period_;
+    sc_core::sc_time period_;
 };
 
 }  // namespace pim
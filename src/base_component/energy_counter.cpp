@@ -8,39 +8,63 @@ namespace pimsim {
 
 double EnergyCounter::running_time_ = 0.0;
 bool EnergyCounter::set_running_time_ = false;
+std::unordered_map<const double*, std::string> EnergyCounter::power_parameter_names_{};
 
 EnergyCounter::EnergyCounter(const EnergyCounter& another)
     : static_power_(another.static_power_)
     , dynamic_energy_(another.dynamic_energy_)
-    , activity_time_(another.activity_time_) {}
+    , activity_time_(another.activity_time_)
+    , static_activity_(another.static_activity_)
+    , dynamic_activity_(another.dynamic_activity_)
+    , untracked_static_power_(another.untracked_static_power_)
+    , untracked_dynamic_energy_(another.untracked_dynamic_energy_) {}
 
 void EnergyCounter::clear() {
     static_power_ = 0.0;
     dynamic_energy_ = 0.0;
     activity_time_ = 0.0;
     dynamic_time_tag_map_.clear();
+    static_activity_.clear();
+    dynamic_activity_.clear();
+    untracked_static_power_ = 0.0;
+    untracked_dynamic_energy_ = 0.0;
 }
 
-void EnergyCounter::setStaticPowerMW(double power) {
-    static_power_ = power;
+void EnergyCounter::setStaticPowerMW(const double& unit_power, double unit_cnt) {
+    static_power_ = unit_power * unit_cnt;
+    static_activity_.clear();
+    untracked_static_power_ = 0.0;
+    recordStaticActivity(unit_power, unit_cnt);
+}
+
+void EnergyCounter::addStaticPowerMW(const double& unit_power, double unit_cnt) {
+    static_power_ += unit_power * unit_cnt;
+    recordStaticActivity(unit_power, unit_cnt);
 }
 
 void EnergyCounter::addDynamicEnergyPJ(double energy) {
     dynamic_energy_ += energy;
+    if (isRecordingActivity()) {
+        untracked_dynamic_energy_ += energy;
+    }
 }
 
-void EnergyCounter::addDynamicEnergyPJ(double latency, double power) {
+void EnergyCounter::addDynamicEnergyPJ(double latency, const double& unit_power, double unit_cnt) {
     activity_time_ += latency;
-    dynamic_energy_ += latency * power;
+    dynamic_energy_ += latency * (unit_power * unit_cnt);
+    recordDynamicActivity(unit_power, latency * unit_cnt);
 }
 
-void EnergyCounter::addDynamicEnergyPJ(double latency, double power, const sc_core::sc_time& time_tag, int id_tag) {
+void EnergyCounter::addDynamicEnergyPJ(double latency, const double& unit_power, const sc_core::sc_time& time_tag,
+                                       int id_tag) {
     auto found = dynamic_time_tag_map_.find(id_tag);
     if (found == dynamic_time_tag_map_.end()) {
-        dynamic_energy_ += latency * power;
+        dynamic_energy_ += latency * unit_power;
+        recordDynamicActivity(unit_power, latency);
         dynamic_time_tag_map_.emplace(id_tag, time_tag);
     } else if (found->second != time_tag) {
-        dynamic_energy_ += latency * power;
+        dynamic_energy_ += latency * unit_power;
+        recordDynamicActivity(unit_power, latency);
         dynamic_time_tag_map_[id_tag] = time_tag;
     }
 
@@ -50,15 +74,20 @@ void EnergyCounter::addDynamicEnergyPJ(double latency, double power, const sc_co
     }
 }
 
+void EnergyCounter::addEventDynamicEnergyPJ(const double& unit_energy, double event_cnt) {
+    dynamic_energy_ += unit_energy * event_cnt;
+    recordDynamicActivity(unit_energy, event_cnt);
+}
+
 void EnergyCounter::addPipelineDynamicEnergyPJ(int unit_latency_cycle, int pipeline_length, double period,
-                                               double power) {
+                                               const double& unit_power, double unit_cnt) {
     if (pipeline_length <= 0) {
         return;
     }
 
     int total_cycle = (unit_latency_cycle == 0) ? pipeline_length : (unit_latency_cycle - 1 + pipeline_length);
     double total_latency = total_cycle * period;
-    addDynamicEnergyPJ(total_latency, power);
+    addDynamicEnergyPJ(total_latency, unit_power, unit_cnt);
 }
 
 void EnergyCounter::setRunningTimeNS(double time) {
@@ -70,6 +99,14 @@ void EnergyCounter::setRunningTimeNS(const sc_core::sc_time& time) {
     setRunningTimeNS(time.to_seconds() * 1e9);
 }
 
+void EnergyCounter::setPowerParameterNames(std::unordered_map<const double*, std::string> names) {
+    power_parameter_names_ = std::move(names);
+}
+
+bool EnergyCounter::isRecordingActivity() {
+    return !power_parameter_names_.empty();
+}
+
 double EnergyCounter::getRunningTimeNS() {
     if (!set_running_time_) {
         throw std::runtime_error("No running time has been set yet");
@@ -97,11 +134,61 @@ double EnergyCounter::getAveragePowerMW() const {
     return getTotalEnergyPJ() / getRunningTimeNS();  // pJ / ns = mW
 }
 
+std::map<std::string, double> EnergyCounter::getStaticActivity() const {
+    std::map<std::string, double> activity;
+    for (const auto& [power, unit_cnt] : static_activity_) {
+        activity[power_parameter_names_.at(power)] += unit_cnt;
+    }
+    return std::move(activity);
+}
+
+std::map<std::string, double> EnergyCounter::getDynamicActivity() const {
+    std::map<std::string, double> activity;
+    for (const auto& [power, latency] : dynamic_activity_) {
+        activity[power_parameter_names_.at(power)] += latency;
+    }
+    return std::move(activity);
+}
+
+double EnergyCounter::getUntrackedEnergyPJ() const {
+    return untracked_static_power_ * getRunningTimeNS() + untracked_dynamic_energy_;
+}
+
 EnergyCounter& EnergyCounter::operator+=(const EnergyCounter& another) {
     activity_time_ = std::max(activity_time_, another.activity_time_);
     dynamic_energy_ += another.dynamic_energy_;
     static_power_ += another.static_power_;
+    for (const auto& [power, unit_cnt] : another.static_activity_) {
+        static_activity_[power] += unit_cnt;
+    }
+    for (const auto& [power, latency] : another.dynamic_activity_) {
+        dynamic_activity_[power] += latency;
+    }
+    untracked_static_power_ += another.untracked_static_power_;
+    untracked_dynamic_energy_ += another.untracked_dynamic_energy_;
     return *this;
 }
 
+void EnergyCounter::recordStaticActivity(const double& unit_power, double unit_cnt) {
+    if (!isRecordingActivity()) {
+        return;
+    }
+    if (power_parameter_names_.count(&unit_power) != 0) {
+        static_activity_[&unit_power] += unit_cnt;
+    } else {
+        untracked_static_power_ += unit_power * unit_cnt;
+    }
+}
+
+void EnergyCounter::recordDynamicActivity(const double& unit_power, double activity) {
+    if (!isRecordingActivity()) {
+        return;
+    }
+    if (power_parameter_names_.count(&unit_power) != 0) {
+        dynamic_activity_[&unit_power] += activity;
+    } else {
+        untracked_dynamic_energy_ += unit_power * activity;
+    }
+}
+
 }  // namespace pimsim
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <map>
+#include <string>
 #include <unordered_map>
 
 #include "systemc.h"
@@ -24,19 +26,38 @@ private:
     static double running_time_;  // ns
     static bool set_running_time_;
 
+public:
+    // Activity is recorded against the config power parameters registered here, keyed by the address of the config
+    // field, so that the energy can be recomputed for other power values without simulating again. Nothing is
+    // recorded while no parameter is registered.
+    static void setPowerParameterNames(std::unordered_map<const double*, std::string> names);
+    static bool isRecordingActivity();
+
+private:
+    static std::unordered_map<const double*, std::string> power_parameter_names_;
+
 public:
     EnergyCounter() = default;
     EnergyCounter(const EnergyCounter& another);
 
     void clear();
 
-    void setStaticPowerMW(double power);
+    // the power is 'unit_power' * 'unit_cnt', pass the config field itself as 'unit_power' so that the activity can
+    // be recorded against it
+    void setStaticPowerMW(const double& unit_power, double unit_cnt = 1.0);
+    void addStaticPowerMW(const double& unit_power, double unit_cnt = 1.0);
 
+    // energy that is not booked against a power parameter, it is recorded as untracked
     void addDynamicEnergyPJ(double energy);
-    void addDynamicEnergyPJ(double latency, double power);
-    void addDynamicEnergyPJ(double latency, double power, const sc_core::sc_time& time_tag, int id_tag);
+    void addDynamicEnergyPJ(double latency, const double& unit_power, double unit_cnt = 1.0);
+    void addDynamicEnergyPJ(double latency, const double& unit_power, const sc_core::sc_time& time_tag, int id_tag);
+
+    // 'event_cnt' events of 'unit_energy' pJ each, without activity time. pass the config field itself as
+    // 'unit_energy' so that the activity can be recorded against it
+    void addEventDynamicEnergyPJ(const double& unit_energy, double event_cnt);
 
-    void addPipelineDynamicEnergyPJ(int unit_latency_cycle, int pipeline_length, double period, double power);
+    void addPipelineDynamicEnergyPJ(int unit_latency_cycle, int pipeline_length, double period,
+                                    const double& unit_power, double unit_cnt = 1.0);
 
     [[nodiscard]] double getStaticEnergyPJ() const;
     [[nodiscard]] double getDynamicEnergyPJ() const;
@@ -44,6 +65,13 @@ public:
     [[nodiscard]] double getTotalEnergyPJ() const;
     [[nodiscard]] double getAveragePowerMW() const;
 
+    // unit count of each power parameter, by parameter name
+    [[nodiscard]] std::map<std::string, double> getStaticActivity() const;
+    // latency * unit count of each power parameter, by parameter name
+    [[nodiscard]] std::map<std::string, double> getDynamicActivity() const;
+    // energy booked with a power that is not a registered parameter
+    [[nodiscard]] double getUntrackedEnergyPJ() const;
+
     EnergyCounter& operator+=(const EnergyCounter& another);
 
 private:
@@ -53,6 +81,16 @@ private:
 
     std::unordered_map<int, sc_core::sc_time> dynamic_time_tag_map_{};
     sc_core::sc_time activity_time_tag_{0.0, SC_NS};
+
+    // activity of the registered power parameters, only filled while activity is recorded
+    std::unordered_map<const double*, double> static_activity_{};
+    std::unordered_map<const double*, double> dynamic_activity_{};
+    double untracked_static_power_ = 0.0;    // mW
+    double untracked_dynamic_energy_ = 0.0;  // pJ
+
+private:
+    void recordStaticActivity(const double& unit_power, double unit_cnt);
+    void recordDynamicActivity(const double& unit_power, double activity);
 };
 
 }  // namespace pimsim
@@ -31,6 +31,22 @@ void MemorySocket::writeData(const pimsim::InstructionPayload &ins, int address_
     local_memory_unit_->write_data(ins, address_byte, size_byte, std::move(data), finish_write_);
 }
 
+DataView MemorySocket::readView(const pimsim::InstructionPayload &ins, int address_byte, int size_byte) {
+    if (local_memory_unit_ == nullptr) {
+        std::cerr << "Not yet bound local memory unit" << std::endl;
+        return {};
+    }
+    return local_memory_unit_->read_view(ins, address_byte, size_byte, finish_read_);
+}
+
+void MemorySocket::writeView(const pimsim::InstructionPayload &ins, int address_byte, int size_byte, DataView data) {
+    if (local_memory_unit_ == nullptr) {
+        std::cerr << "Not yet bound local memory unit" << std::endl;
+        return;
+    }
+    local_memory_unit_->write_view(ins, address_byte, size_byte, data, finish_write_);
+}
+
 int MemorySocket::getLocalMemoryIdByAddress(int address_byte) const {
     return local_memory_unit_->getLocalMemoryIdByAddress(address_byte);
 }
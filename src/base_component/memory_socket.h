@@ -23,6 +23,10 @@ public:
 
     void writeData(const InstructionPayload& ins, int address_byte, int size_byte, std::vector<uint8_t> data);
 
+    DataView readView(const InstructionPayload& ins, int address_byte, int size_byte);
+
+    void writeView(const InstructionPayload& ins, int address_byte, int size_byte, DataView data);
+
     int getLocalMemoryIdByAddress(int address_byte) const;
 
     int getMemoryDataWidthById(int memory_id, MemoryAccessType access_type) const;
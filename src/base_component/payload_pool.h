@@ -0,0 +1,101 @@
+//
+// Created by wyk on 2024/11/13.
+//
+
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace pimsim {
+
+// Free lists of the blocks of the shared payloads made by one owner, such as a core. A released block is kept in the
+// list of its size and handed out again by the next payload of the same type, so once the simulation is in steady
+// state, making a payload does no heap allocation. The lists are shared with the allocators in the control blocks,
+// so a payload may outlive the pool that made it. The payloads are handed out as shared_ptrs rather than handles of
+// the pool, since the switches, memory queues and network payloads already take and hold them as shared_ptrs, and a
+// payload is released by whichever of them drops it last.
+class PayloadPool {
+public:
+    PayloadPool() : free_lists_(std::make_shared<FreeLists>()) {}
+
+    template <typename T>
+    std::shared_ptr<T> make(T payload) {
+        return std::allocate_shared<T>(Allocator<T>{free_lists_}, std::move(payload));
+    }
+
+    // the number of blocks taken from the heap, payloads made from recycled blocks are not counted
+    [[nodiscard]] long long getAllocationCount() const {
+        return free_lists_->allocation_cnt;
+    }
+
+private:
+    struct FreeLists {
+        std::unordered_map<std::size_t, std::vector<void*>> blocks;  // by block size
+        long long allocation_cnt{0};
+
+        FreeLists() = default;
+        FreeLists(const FreeLists&) = delete;
+        FreeLists& operator=(const FreeLists&) = delete;
+
+        ~FreeLists() {
+            for (auto& [size, block_list] : blocks) {
+                for (auto* block : block_list) {
+                    ::operator delete(block);
+                }
+            }
+        }
+
+        void* allocate(std::size_t size) {
+            auto& block_list = blocks[size];
+            if (block_list.empty()) {
+                allocation_cnt++;
+                return ::operator new(size);
+            }
+            auto* block = block_list.back();
+            block_list.pop_back();
+            return block;
+        }
+
+        void deallocate(void* block, std::size_t size) {
+            blocks[size].push_back(block);
+        }
+    };
+
+    template <typename T>
+    struct Allocator {
+        using value_type = T;
+
+        std::shared_ptr<FreeLists> free_lists;
+
+        explicit Allocator(std::shared_ptr<FreeLists> free_lists) : free_lists(std::move(free_lists)) {}
+
+        template <typename U>
+        Allocator(const Allocator<U>& other) : free_lists(other.free_lists) {}  // NOLINT(*-explicit-constructor)
+
+        T* allocate(std::size_t n) {
+            return static_cast<T*>(free_lists->allocate(n * sizeof(T)));
+        }
+
+        void deallocate(T* p, std::size_t n) {
+            free_lists->deallocate(p, n * sizeof(T));
+        }
+
+        template <typename U>
+        bool operator==(const Allocator<U>& other) const {
+            return free_lists == other.free_lists;
+        }
+
+        template <typename U>
+        bool operator!=(const Allocator<U>& other) const {
+            return free_lists != other.free_lists;
+        }
+    };
+
+    std::shared_ptr<FreeLists> free_lists_;
+};
+
+}  // namespace pimsim
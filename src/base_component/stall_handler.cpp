@@ -20,6 +20,14 @@ StallHandler::StallHandler(sc_core::sc_event& decode_new_ins_trigger) : sc_core:
     sensitive << trigger_ << busy_ << decode_new_ins_trigger;
 }
 
+bool StallHandler::hasInsInFlight() const {
+    return !ins_data_conflict_info_map_.empty() || busy_.read();
+}
+
+const sc_core::sc_event& StallHandler::getDrainEvent() const {
+    return drain_;
+}
+
 void StallHandler::processAddUnitDataConflict() {
     const auto& unit_conflict_payload = data_conflict_.read();
     if (unit_conflict_payload.ins_id != -1) {
@@ -54,6 +62,11 @@ void StallHandler::processUnitDataConflict() {
     bool unit_conflict = DataConflictPayload::checkDataConflict(*cur_ins_conflict_info_, unit_data_conflict_info_) ||
                          (cur_ins_conflict_info_->unit_type == unit_data_conflict_info_.unit_type && busy);
     conflict_.write(unit_conflict);
+
+    // runs whenever an instruction leaves the unit or the unit goes idle
+    if (!hasInsInFlight()) {
+        drain_.notify(SC_ZERO_TIME);
+    }
 }
 
 }  // namespace pimsim
@@ -29,6 +29,10 @@ public:
         this->cur_ins_conflict_info_ = cur_ins_conflict_info;
     }
 
+    [[nodiscard]] bool hasInsInFlight() const;
+    // notified when the unit may have no instruction in flight any more, check 'hasInsInFlight' again
+    [[nodiscard]] const sc_core::sc_event& getDrainEvent() const;
+
 private:
     void processAddUnitDataConflict();
     void processDeleteUnitDataConflict();
@@ -48,6 +52,7 @@ private:
     std::unordered_map<int, DataConflictPayload> ins_data_conflict_info_map_{};
     DataConflictPayload unit_data_conflict_info_{};
     sc_core::sc_event trigger_;
+    sc_core::sc_event drain_;
 };
 
 }  // namespace pimsim
@@ -0,0 +1,83 @@
+//
+// Created by wyk on 2024/11/13.
+//
+
+#include "barrier_manager.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include "fmt/format.h"
+#include "util/log.h"
+
+namespace pimsim {
+
+BarrierManager::BarrierManager(const BarrierConfig& config, const SimConfig& sim_config, Network* network,
+                               bool parallel)
+    : config_(config), sim_config_(sim_config), network_(network), parallel_(parallel) {}
+
+void BarrierManager::arrive(int core_id, int barrier_id, int core_cnt) {
+    LOG(fmt::format("core {} arrives at barrier {} of {} cores", core_id, barrier_id, core_cnt));
+    if (core_cnt <= 0) {
+        std::cerr << fmt::format("BarrierManager: barrier {} of {} cores, ignored", barrier_id, core_cnt)
+                  << std::endl;
+        return;
+    }
+
+    // a message up the tree and the release down it, or the wire of the core
+    if (config_.type == +BarrierType::tree) {
+        energy_counter_.addEventDynamicEnergyPJ(config_.hop_energy_pJ, 2);
+    } else {
+        energy_counter_.addEventDynamicEnergyPJ(config_.wire_energy_pJ, 1);
+    }
+
+    auto& barrier = barrier_map_[barrier_id];
+    if (parallel_) {
+        network_->sendToRemote(RemoteNetworkPayload{.src_id = core_id,
+                                                    .dst_id = core_id,
+                                                    .mode = NetworkTransferMode::barrier,
+                                                    .arrival_time = sc_core::sc_time_stamp().value(),
+                                                    .barrier_id = barrier_id,
+                                                    .barrier_core_cnt = core_cnt});
+    }
+    addArrival(barrier_id, core_cnt, sc_core::sc_time_stamp());
+    wait(barrier.release);
+    LOG(fmt::format("core {} leaves barrier {}", core_id, barrier_id));
+}
+
+void BarrierManager::receiveRemoteArrival(const RemoteNetworkPayload& payload) {
+    addArrival(payload.barrier_id, payload.barrier_core_cnt, sc_core::sc_time::from_value(payload.arrival_time));
+}
+
+void BarrierManager::addArrival(int barrier_id, int core_cnt, const sc_core::sc_time& arrival_time) {
+    auto& barrier = barrier_map_[barrier_id];
+    barrier.arrived_cnt++;
+    barrier.last_arrival_time = std::max(barrier.last_arrival_time, arrival_time);
+    if (barrier.arrived_cnt < core_cnt) {
+        return;
+    }
+
+    auto release_time = barrier.last_arrival_time + getReleaseLatency(config_, sim_config_, core_cnt);
+    barrier.release.notify(std::max(release_time, sc_core::sc_time_stamp()) - sc_core::sc_time_stamp());
+    barrier.arrived_cnt = 0;
+    barrier.last_arrival_time = sc_core::SC_ZERO_TIME;
+}
+
+sc_core::sc_time BarrierManager::getReleaseLatency(const BarrierConfig& config, const SimConfig& sim_config,
+                                                   int core_cnt) {
+    if (config.type == +BarrierType::wire) {
+        return {config.wire_latency_cycle * sim_config.period_ns, sc_core::SC_NS};
+    }
+
+    int level_cnt = 1;
+    for (long long covered_cnt = config.tree_fanout; covered_cnt < core_cnt; covered_cnt *= config.tree_fanout) {
+        level_cnt++;
+    }
+    return {2 * level_cnt * config.hop_latency_cycle * sim_config.period_ns, sc_core::SC_NS};
+}
+
+EnergyReporter BarrierManager::getEnergyReporter() const {
+    return EnergyReporter{energy_counter_};
+}
+
+}  // namespace pimsim
@@ -0,0 +1,54 @@
+//
+// Created by wyk on 2024/11/13.
+//
+
+#pragma once
+#include <unordered_map>
+
+#include "base_component/energy_counter.h"
+#include "config/config.h"
+#include "network/network.h"
+#include "systemc.h"
+#include "util/reporter.h"
+
+namespace pimsim {
+
+// The barrier hardware of the chip, see BarrierConfig. A barrier only counts its arrivals, and when the last of its
+// cores arrives, a single event releases all of them after the latency of the barrier hardware, so a barrier of n
+// cores costs n arrivals and n wake-ups in the simulator. In a parallel simulation the arrivals are also told to the
+// other partitions, whose barriers count them as well, see ParallelChip.
+class BarrierManager {
+public:
+    BarrierManager(const BarrierConfig& config, const SimConfig& sim_config, Network* network, bool parallel);
+
+    // blocks the calling core until 'core_cnt' cores have arrived at the barrier and the release has reached it
+    void arrive(int core_id, int barrier_id, int core_cnt);
+    // an arrival in another partition of a parallel simulation
+    void receiveRemoteArrival(const RemoteNetworkPayload& payload);
+
+    // from the last arrival to the release of the cores
+    static sc_core::sc_time getReleaseLatency(const BarrierConfig& config, const SimConfig& sim_config, int core_cnt);
+
+    [[nodiscard]] EnergyReporter getEnergyReporter() const;
+
+private:
+    struct Barrier {
+        int arrived_cnt{0};
+        sc_core::sc_time last_arrival_time{sc_core::SC_ZERO_TIME};
+        sc_core::sc_event release;
+    };
+
+    void addArrival(int barrier_id, int core_cnt, const sc_core::sc_time& arrival_time);
+
+private:
+    const BarrierConfig& config_;
+    const SimConfig& sim_config_;
+    Network* network_;
+    const bool parallel_;
+
+    std::unordered_map<int, Barrier> barrier_map_;
+
+    EnergyCounter energy_counter_;
+};
+
+}  // namespace pimsim
@@ -4,48 +4,193 @@
 
 #include "chip.h"
 
+#include <algorithm>
+
 #include "core/core.h"
 #include "fmt/format.h"
 
 namespace pimsim {
 
+namespace {
+
+ChipPartition getWholeChipPartition(int core_cnt) {
+    ChipPartition partition{.global_memory = true, .parallel = false};
+    for (int core_id = 0; core_id < core_cnt; core_id++) {
+        partition.core_id_list.push_back(core_id);
+    }
+    return partition;
+}
+
+}  // namespace
+
 Chip::Chip(const char* name, const Config& config, const std::vector<std::vector<Instruction>>& core_ins_list)
+    : Chip(name, config, core_ins_list, getWholeChipPartition(config.chip_config.core_cnt)) {}
+
+Chip::Chip(const char* name, const Config& config, const std::vector<std::vector<Instruction>>& core_ins_list,
+           const ChipPartition& partition)
     : BaseModule(name, config.sim_config, nullptr, nullptr)
+    , parallel_(partition.parallel)
     , clk_("Clock", config.sim_config.period_ns)
-    , global_memory_("GlobalMemory", config.chip_config.global_memory_config, config.sim_config, &clk_)
-    , network_("Network", config.chip_config.network_config, config.sim_config) {
-    for (int core_id = 0; core_id < config.chip_config.core_cnt; core_id++) {
+    , network_("Network", config.chip_config.network_config, config.sim_config,
+               config.chip_config.global_memory_config.global_memory_switch_id)
+    , barrier_manager_(config.chip_config.barrier_config, config.sim_config, &network_, partition.parallel) {
+    for (int core_id : partition.core_id_list) {
         std::string core_name = fmt::format("Core_{}", core_id);
-        auto core = std::make_shared<Core>(core_id, core_name.c_str(), config, &clk_,
-                                                       core_ins_list[core_id], [this]() { this->processFinishRun(); });
+        auto core = std::make_shared<Core>(core_id, core_name.c_str(), config, &clk_, core_ins_list[core_id],
+                                           [this]() { this->processFinishRun(); });
         core->bindNetwork(&network_);
+        core->bindBarrierManager(&barrier_manager_);
         core_list_.emplace_back(std::move(core));
     }
-    global_memory_.bindNetwork(&network_);
+
+    const auto& global_memory_config = config.chip_config.global_memory_config;
+    if (partition.global_memory) {
+        global_memory_ =
+            std::make_shared<GlobalMemory>("GlobalMemory", global_memory_config, config.sim_config, &clk_);
+        global_memory_->bindNetwork(&network_);
+    } else {
+        network_.registerRemoteSwitch(global_memory_config.global_memory_switch_id);
+    }
+
+    if (parallel_) {
+        for (int core_id = 0; core_id < config.chip_config.core_cnt; core_id++) {
+            if (std::find(partition.core_id_list.begin(), partition.core_id_list.end(), core_id) ==
+                partition.core_id_list.end()) {
+                std::string remote_switch_name = fmt::format("RemoteSwitch_{}", core_id);
+                auto remote_switch =
+                    std::make_shared<RemoteSwitch>(remote_switch_name.c_str(), config.sim_config, &clk_, core_id);
+                remote_switch->bindNetwork(&network_);
+                remote_switch_map_.emplace(core_id, std::move(remote_switch));
+            }
+        }
+    }
 }
 
 Reporter Chip::report(std::ostream& os) {
     EnergyCounter::setRunningTimeNS(running_time_);
     Reporter reporter{running_time_.to_seconds() * 1000, getName(), getEnergyReporter(), 0};
+    reporter.setPayloadAllocationCount(getPayloadAllocationCount());
+    reporter.setMemoryBankReports(getMemoryBankReports());
+    reporter.setNetworkLinkReports(getNetworkLinkReports());
+    reporter.setMemoryQueueReports(getMemoryQueueReports());
     reporter.report(os);
     return std::move(reporter);
 }
 
+void Chip::fastForward(const FastForwardTarget& target) {
+    for (auto& core : core_list_) {
+        core->fastForward(target);
+    }
+}
+
+std::vector<CoreState> Chip::getCoreStates() {
+    std::vector<CoreState> core_states;
+    for (auto& core : core_list_) {
+        core_states.push_back(core->getState());
+    }
+    return core_states;
+}
+
 EnergyReporter Chip::getEnergyReporter() {
     EnergyReporter energy_reporter;
-    for (auto& core : core_list_) {
-        energy_reporter.addSubModule(core->getName(), core->getEnergyReporter());
+    for (auto& [name, sub_module_reporter] : getSubModuleEnergyReporters()) {
+        energy_reporter.addSubModule(name, std::move(sub_module_reporter));
     }
-    energy_reporter.addSubModule("GlobalMemory", global_memory_.getEnergyReporter());
-    energy_reporter.addSubModule("Network", network_.getEnergyReporter());
     return std::move(energy_reporter);
 }
 
+std::vector<std::pair<std::string, EnergyReporter>> Chip::getSubModuleEnergyReporters() {
+    std::vector<std::pair<std::string, EnergyReporter>> sub_module_reporters;
+    for (auto& core : core_list_) {
+        sub_module_reporters.emplace_back(core->getName(), core->getEnergyReporter());
+    }
+    if (global_memory_ != nullptr) {
+        sub_module_reporters.emplace_back("GlobalMemory", global_memory_->getEnergyReporter());
+    }
+    sub_module_reporters.emplace_back("Network", network_.getEnergyReporter());
+    sub_module_reporters.emplace_back("Barrier", barrier_manager_.getEnergyReporter());
+    return sub_module_reporters;
+}
+
+long long Chip::getPayloadAllocationCount() const {
+    long long payload_allocation_cnt = 0;
+    for (const auto& core : core_list_) {
+        payload_allocation_cnt += core->getPayloadAllocationCount();
+    }
+    for (const auto& [switch_id, remote_switch] : remote_switch_map_) {
+        payload_allocation_cnt += remote_switch->getPayloadAllocationCount();
+    }
+    return payload_allocation_cnt;
+}
+
+std::vector<MemoryBankReport> Chip::getMemoryBankReports() const {
+    std::vector<MemoryBankReport> memory_bank_reports;
+    for (const auto& core : core_list_) {
+        auto core_memory_bank_reports = core->getMemoryBankReports();
+        memory_bank_reports.insert(memory_bank_reports.end(), core_memory_bank_reports.begin(),
+                                   core_memory_bank_reports.end());
+    }
+    if (global_memory_ != nullptr) {
+        auto global_memory_bank_reports = global_memory_->getMemoryBankReports();
+        memory_bank_reports.insert(memory_bank_reports.end(), global_memory_bank_reports.begin(),
+                                   global_memory_bank_reports.end());
+    }
+    return memory_bank_reports;
+}
+
+std::vector<NetworkLinkReport> Chip::getNetworkLinkReports() const {
+    return network_.getLinkReports();
+}
+
+std::vector<MemoryQueueReport> Chip::getMemoryQueueReports() const {
+    if (global_memory_ == nullptr) {
+        return {};
+    }
+    return {global_memory_->getQueueReport()};
+}
+
+const NetworkFlitCount& Chip::getNetworkFlitCount() const {
+    return network_.getFlitCount();
+}
+
+void Chip::receiveRemote(const std::vector<RemoteNetworkPayload>& payload_list) {
+    for (const auto& payload : payload_list) {
+        if (payload.mode == +NetworkTransferMode::barrier) {
+            barrier_manager_.receiveRemoteArrival(payload);
+        } else if (payload.response) {
+            network_.getSwitch(payload.dst_id)->receiveRemoteResponse(payload);
+        } else {
+            remote_switch_map_[payload.src_id]->receive(payload);
+        }
+    }
+}
+
+std::vector<RemoteNetworkPayload> Chip::takeRemoteOutbox() {
+    return network_.takeRemoteOutbox();
+}
+
+void Chip::setPauseOnFinish(bool pause_on_finish) {
+    pause_on_finish_ = pause_on_finish;
+}
+
+bool Chip::isFinished() const {
+    return finished_;
+}
+
+const sc_core::sc_time& Chip::getRunningTime() const {
+    return running_time_;
+}
+
 void Chip::processFinishRun() {
     finish_run_core_cnt_++;
     if (finish_run_core_cnt_ == core_list_.size()) {
         running_time_ = sc_core::sc_time_stamp();
-        sc_stop();
+        finished_ = true;
+        if (!parallel_) {
+            sc_stop();
+        } else if (pause_on_finish_) {
+            sc_core::sc_pause();
+        }
     }
 }
 
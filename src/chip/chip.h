@@ -3,32 +3,69 @@
 //
 
 #pragma once
+#include "barrier_manager.h"
 #include "base_component/base_module.h"
+#include "core/core.h"
 #include "isa/instruction.h"
 #include "memory/global_memory.h"
+#include "network/remote_switch.h"
 
 namespace pimsim {
 
+// the part of the chip simulated by one process of a parallel simulation, see ParallelChip
+struct ChipPartition {
+    std::vector<int> core_id_list{};
+    bool global_memory{true};
+    bool parallel{false};
+};
+
 class Chip : public BaseModule {
 public:
     Chip(const char* name, const Config& config, const std::vector<std::vector<Instruction>>& core_ins_list);
+    Chip(const char* name, const Config& config, const std::vector<std::vector<Instruction>>& core_ins_list,
+         const ChipPartition& partition);
 
     Reporter report(std::ostream& os);
 
+    // fast-forwards every core functionally before the simulation starts, see Core::fastForward
+    void fastForward(const FastForwardTarget& target);
+    // of the cores of this partition, by core id
+    std::vector<CoreState> getCoreStates();
+
     EnergyReporter getEnergyReporter() override;
+    std::vector<std::pair<std::string, EnergyReporter>> getSubModuleEnergyReporters();
+    [[nodiscard]] long long getPayloadAllocationCount() const;
+    [[nodiscard]] std::vector<MemoryBankReport> getMemoryBankReports() const;
+    [[nodiscard]] std::vector<NetworkLinkReport> getNetworkLinkReports() const;
+    // empty if the global memory is simulated by another partition
+    [[nodiscard]] std::vector<MemoryQueueReport> getMemoryQueueReports() const;
+    [[nodiscard]] const NetworkFlitCount& getNetworkFlitCount() const;
+
+    // parallel simulation
+    void receiveRemote(const std::vector<RemoteNetworkPayload>& payload_list);
+    std::vector<RemoteNetworkPayload> takeRemoteOutbox();
+    void setPauseOnFinish(bool pause_on_finish);
+    [[nodiscard]] bool isFinished() const;
+    [[nodiscard]] const sc_core::sc_time& getRunningTime() const;
 
 private:
     void processFinishRun();
 
 private:
+    const bool parallel_;
+
     Clock clk_;
     std::vector<std::shared_ptr<Core>> core_list_;
-    GlobalMemory global_memory_;
+    std::shared_ptr<GlobalMemory> global_memory_;
     Network network_;
+    std::unordered_map<int, std::shared_ptr<RemoteSwitch>> remote_switch_map_;
+    BarrierManager barrier_manager_;
 
     EnergyCounter energy_counter_;
 
     int finish_run_core_cnt_{0};
+    bool finished_{false};
+    bool pause_on_finish_{false};
     sc_core::sc_time running_time_{};
 };
 
@@ -0,0 +1,500 @@
+//
+// Created by wyk on 2024/11/13.
+//
+
+#include "parallel_chip.h"
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include "fmt/format.h"
+#include "isa/isa.h"
+
+namespace pimsim {
+
+namespace {
+
+using TimeValue = sc_core::sc_time::value_type;
+
+constexpr TimeValue NO_ACTIVITY = std::numeric_limits<TimeValue>::max();
+
+struct PartitionCommand {
+    TimeValue run_until{0};
+    bool pause_on_finish{false};
+    bool finish{false};
+    TimeValue running_time{0};
+    uint64_t payload_cnt{0};
+};
+
+struct PartitionStatus {
+    bool finished{false};
+    TimeValue finish_time{0};
+    TimeValue now{0};
+    bool pending_activity{false};
+    TimeValue next_activity_time{0};
+    uint64_t payload_cnt{0};
+};
+
+void writeAll(int fd, const void* data, size_t size, int partition_id) {
+    const auto* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        auto written = write(fd, bytes, size);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            throw std::runtime_error(fmt::format("ParallelChip: write to the pipe of partition {} failed, {}",
+                                                 partition_id, std::strerror(errno)));
+        }
+        bytes += written;
+        size -= written;
+    }
+}
+
+void readAll(int fd, void* data, size_t size, int partition_id) {
+    auto* bytes = static_cast<char*>(data);
+    while (size > 0) {
+        auto read_size = read(fd, bytes, size);
+        if (read_size < 0 && errno == EINTR) {
+            continue;
+        }
+        if (read_size == 0) {
+            throw std::runtime_error(fmt::format("ParallelChip: the pipe of partition {} is closed", partition_id));
+        }
+        if (read_size < 0) {
+            throw std::runtime_error(fmt::format("ParallelChip: read from the pipe of partition {} failed, {}",
+                                                 partition_id, std::strerror(errno)));
+        }
+        bytes += read_size;
+        size -= read_size;
+    }
+}
+
+void writePayloads(int fd, const std::vector<RemoteNetworkPayload>& payload_list, int partition_id) {
+    if (!payload_list.empty()) {
+        writeAll(fd, payload_list.data(), payload_list.size() * sizeof(RemoteNetworkPayload), partition_id);
+    }
+}
+
+std::vector<RemoteNetworkPayload> readPayloads(int fd, uint64_t payload_cnt, int partition_id) {
+    std::vector<RemoteNetworkPayload> payload_list(payload_cnt);
+    if (!payload_list.empty()) {
+        readAll(fd, payload_list.data(), payload_list.size() * sizeof(RemoteNetworkPayload), partition_id);
+    }
+    return payload_list;
+}
+
+// a json is sent as its size followed by its dump
+void writeJson(int fd, const nlohmann::json& j, int partition_id) {
+    auto str = j.dump();
+    uint64_t size = str.size();
+    writeAll(fd, &size, sizeof(size), partition_id);
+    writeAll(fd, str.data(), size, partition_id);
+}
+
+nlohmann::json readJson(int fd, int partition_id) {
+    uint64_t size;
+    readAll(fd, &size, sizeof(size), partition_id);
+    std::string str(size, '\0');
+    readAll(fd, str.data(), size, partition_id);
+    return nlohmann::json::parse(str);
+}
+
+}  // namespace
+
+ParallelChip::ParallelChip(std::string name, const Config& config,
+                           const std::vector<std::vector<Instruction>>& core_ins_list)
+    : name_(std::move(name)), config_(config), core_ins_list_(core_ins_list) {
+    const int core_cnt = config_.chip_config.core_cnt;
+    const int partition_cnt = std::min(config_.sim_config.parallel_partition_cnt, core_cnt);
+
+    core_partition_map_.resize(core_cnt);
+    for (int partition_id = 0; partition_id < partition_cnt; partition_id++) {
+        ChipPartition partition{.global_memory = (partition_id == 0), .parallel = (partition_cnt > 1)};
+        for (int core_id = partition_id * core_cnt / partition_cnt;
+             core_id < (partition_id + 1) * core_cnt / partition_cnt; core_id++) {
+            partition.core_id_list.push_back(core_id);
+            core_partition_map_[core_id] = partition_id;
+        }
+        partition_list_.emplace_back(std::move(partition));
+    }
+
+    if (partition_list_.size() > 1) {
+        window_ticks_ = getWindowTicks();
+    }
+}
+
+bool ParallelChip::checkValid() const {
+    if (partition_list_.size() > 1 && window_ticks_ == 0) {
+        std::cerr << "ParallelChip not valid, the network latency between switches of different partitions must be "
+                     "positive with 'parallel_partition_cnt' above 1"
+                  << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void ParallelChip::setFastForwardTarget(const FastForwardTarget& target) {
+    fast_forward_ = true;
+    fast_forward_target_ = target;
+}
+
+void ParallelChip::run() {
+    if (partition_list_.size() == 1) {
+        chip_ = std::make_shared<Chip>(name_.c_str(), config_, core_ins_list_);
+        if (fast_forward_) {
+            chip_->fastForward(fast_forward_target_);
+        }
+        if (config_.sim_config.sim_mode == +SimMode::run_until_time) {
+            sc_start(config_.sim_config.sim_time_ms, sc_core::SC_MS);
+        } else {
+            sc_start();
+        }
+        return;
+    }
+
+    startPartitionProcesses();
+
+    std::vector<int> running_partition_list;
+    std::vector<int> finished_partition_list;
+    TimeValue window_start = 0;
+    while (true) {
+        const TimeValue window_end = window_start + window_ticks_ - 1;
+
+        // partitions still running pause when their cores finish, so that they can stop at the finish time of the
+        // whole chip if it falls into this window
+        running_partition_list.clear();
+        for (int partition_id = 0; partition_id < process_list_.size(); partition_id++) {
+            if (!process_list_[partition_id].finished) {
+                running_partition_list.push_back(partition_id);
+            }
+        }
+        runPartitions(running_partition_list, window_end, true);
+
+        if (std::all_of(process_list_.begin(), process_list_.end(), [](auto& process) { return process.finished; })) {
+            auto finish_time = std::max_element(process_list_.begin(), process_list_.end(), [](auto& p1, auto& p2) {
+                                   return p1.finish_time < p2.finish_time;
+                               })->finish_time;
+            running_time_ = sc_core::sc_time::from_value(finish_time);
+
+            std::vector<int> behind_partition_list;
+            for (int partition_id = 0; partition_id < process_list_.size(); partition_id++) {
+                if (process_list_[partition_id].now < finish_time) {
+                    behind_partition_list.push_back(partition_id);
+                }
+            }
+            runPartitions(behind_partition_list, finish_time, false);
+            break;
+        }
+
+        // payloads sent by partitions in this window arrive after it, so finished partitions can run it afterwards
+        finished_partition_list.clear();
+        for (int partition_id = 0; partition_id < process_list_.size(); partition_id++) {
+            if (process_list_[partition_id].finished) {
+                finished_partition_list.push_back(partition_id);
+            }
+        }
+        runPartitions(finished_partition_list, window_end, false);
+
+        // skip the time no partition has anything to do, stop if all are blocked like the sequential kernel does
+        TimeValue next_activity_time = NO_ACTIVITY;
+        for (const auto& process : process_list_) {
+            if (process.pending_activity) {
+                next_activity_time = std::min(next_activity_time, process.next_activity_time);
+            }
+            for (const auto& payload : process.inbox) {
+                next_activity_time = std::min(next_activity_time, payload.arrival_time);
+            }
+        }
+        if (next_activity_time == NO_ACTIVITY) {
+            break;
+        }
+        window_start = std::max(next_activity_time, window_end);
+    }
+
+    finishPartitions();
+}
+
+Reporter ParallelChip::report(std::ostream& os) {
+    if (chip_ != nullptr) {
+        return chip_->report(os);
+    }
+
+    Reporter reporter{running_time_.to_seconds() * 1000, name_, energy_reporter_, 0};
+    reporter.setPayloadAllocationCount(payload_allocation_cnt_);
+    reporter.setMemoryBankReports(memory_bank_reports_);
+    reporter.setNetworkLinkReports(network_link_reports_);
+    reporter.setMemoryQueueReports(memory_queue_reports_);
+    reporter.report(os);
+    return std::move(reporter);
+}
+
+std::vector<CoreState> ParallelChip::getCoreStates() {
+    if (chip_ != nullptr) {
+        return chip_->getCoreStates();
+    }
+    return core_states_;
+}
+
+int ParallelChip::getPartitionId(int switch_id) const {
+    if (switch_id == config_.chip_config.global_memory_config.global_memory_switch_id) {
+        return 0;
+    }
+    return core_partition_map_[switch_id];
+}
+
+// every payload crossing partitions travels at least one flit, so the window is bounded by the minimum per flit
+// latency between two switches of different partitions that payloads can go between
+TimeValue ParallelChip::getWindowTicks() const {
+    Network network{"Network", config_.chip_config.network_config, config_.sim_config,
+                    config_.chip_config.global_memory_config.global_memory_switch_id};
+
+    std::vector<int> switch_id_list;
+    for (int core_id = 0; core_id < config_.chip_config.core_cnt; core_id++) {
+        switch_id_list.push_back(core_id);
+    }
+    switch_id_list.push_back(config_.chip_config.global_memory_config.global_memory_switch_id);
+
+    TimeValue window_ticks = NO_ACTIVITY;
+    for (int src_id : switch_id_list) {
+        for (int dst_id : switch_id_list) {
+            if (getPartitionId(src_id) != getPartitionId(dst_id) && network.hasPair(src_id, dst_id)) {
+                sc_core::sc_time latency{network.getLatencyCycle(src_id, dst_id) * config_.sim_config.period_ns,
+                                         sc_core::SC_NS};
+                window_ticks = std::min(window_ticks, latency.value());
+            }
+        }
+    }
+
+    // an arrival at a barrier reaches the other partitions by the end of its window, which must be before the release
+    bool has_barrier = std::any_of(core_ins_list_.begin(), core_ins_list_.end(), [](const auto& ins_list) {
+        return std::any_of(ins_list.begin(), ins_list.end(), [](const Instruction& ins) {
+            return ins.class_code == InstClass::control && ins.type == ControlInstType::barrier;
+        });
+    });
+    if (has_barrier) {
+        auto release_latency =
+            BarrierManager::getReleaseLatency(config_.chip_config.barrier_config, config_.sim_config, 1);
+        window_ticks = std::min(window_ticks, release_latency.value());
+    }
+    return window_ticks;
+}
+
+void ParallelChip::startPartitionProcesses() {
+    // a partition process that has exited fails the writes to its pipe instead of killing the writer
+    std::signal(SIGPIPE, SIG_IGN);
+    std::cout.flush();
+    std::cerr.flush();
+
+    for (int partition_id = 0; partition_id < partition_list_.size(); partition_id++) {
+        int command_pipe[2];
+        int status_pipe[2];
+        if (pipe(command_pipe) != 0 || pipe(status_pipe) != 0) {
+            throw std::runtime_error("ParallelChip: create partition pipe failed");
+        }
+
+        int pid = fork();
+        if (pid < 0) {
+            throw std::runtime_error("ParallelChip: fork partition process failed");
+        }
+        if (pid == 0) {
+            close(command_pipe[1]);
+            close(status_pipe[0]);
+            for (auto& process : process_list_) {
+                close(process.command_fd);
+                close(process.status_fd);
+            }
+            runPartitionProcess(partition_id, command_pipe[0], status_pipe[1]);
+        }
+
+        close(command_pipe[0]);
+        close(status_pipe[1]);
+        process_list_.push_back({.pid = pid, .command_fd = command_pipe[1], .status_fd = status_pipe[0]});
+    }
+}
+
+void ParallelChip::runPartitionProcess(int partition_id, int command_fd, int status_fd) {
+    int exit_code = EXIT_SUCCESS;
+    try {
+        Chip chip{name_.c_str(), config_, core_ins_list_, partition_list_[partition_id]};
+        if (fast_forward_) {
+            chip.fastForward(fast_forward_target_);
+        }
+        while (true) {
+            PartitionCommand command;
+            readAll(command_fd, &command, sizeof(command), partition_id);
+            if (command.finish) {
+                EnergyCounter::setRunningTimeNS(sc_core::sc_time::from_value(command.running_time));
+                writeJson(status_fd, chip.getSubModuleEnergyReporters(), partition_id);
+                long long payload_allocation_cnt = chip.getPayloadAllocationCount();
+                writeAll(status_fd, &payload_allocation_cnt, sizeof(payload_allocation_cnt), partition_id);
+                writeJson(status_fd, chip.getMemoryBankReports(), partition_id);
+                writeJson(status_fd, chip.getNetworkLinkReports(), partition_id);
+                writeJson(status_fd, chip.getMemoryQueueReports(), partition_id);
+                writeJson(status_fd, chip.getNetworkFlitCount(), partition_id);
+                writeJson(status_fd, chip.getCoreStates(), partition_id);
+                break;
+            }
+
+            chip.receiveRemote(readPayloads(command_fd, command.payload_cnt, partition_id));
+            chip.setPauseOnFinish(command.pause_on_finish);
+            if (auto now = sc_core::sc_time_stamp().value(); command.run_until > now) {
+                sc_start(sc_core::sc_time::from_value(command.run_until - now));
+            }
+
+            auto outbox = chip.takeRemoteOutbox();
+            auto now = sc_core::sc_time_stamp().value();
+            PartitionStatus status{.finished = chip.isFinished(),
+                                   .finish_time = chip.getRunningTime().value(),
+                                   .now = now,
+                                   .pending_activity = sc_core::sc_pending_activity(),
+                                   .next_activity_time = now + sc_core::sc_time_to_pending_activity().value(),
+                                   .payload_cnt = outbox.size()};
+            writeAll(status_fd, &status, sizeof(status), partition_id);
+            writePayloads(status_fd, outbox, partition_id);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << fmt::format("ParallelChip: partition {} failed, {}", partition_id, e.what()) << std::endl;
+        exit_code = EXIT_FAILURE;
+    }
+
+    std::cout.flush();
+    std::cerr.flush();
+    _exit(exit_code);
+}
+
+void ParallelChip::runPartitions(const std::vector<int>& partition_id_list, TimeValue run_until,
+                                 bool pause_on_finish) {
+    for (int partition_id : partition_id_list) {
+        auto& process = process_list_[partition_id];
+        PartitionCommand command{.run_until = run_until,
+                                 .pause_on_finish = pause_on_finish,
+                                 .payload_cnt = process.inbox.size()};
+        writeAll(process.command_fd, &command, sizeof(command), partition_id);
+        writePayloads(process.command_fd, process.inbox, partition_id);
+        process.inbox.clear();
+    }
+
+    for (int partition_id : partition_id_list) {
+        auto& process = process_list_[partition_id];
+        PartitionStatus status;
+        readAll(process.status_fd, &status, sizeof(status), partition_id);
+        process.finished = status.finished;
+        process.finish_time = status.finish_time;
+        process.now = status.now;
+        process.pending_activity = status.pending_activity;
+        process.next_activity_time = status.next_activity_time;
+
+        for (const auto& payload : readPayloads(process.status_fd, status.payload_cnt, partition_id)) {
+            if (payload.mode == +NetworkTransferMode::barrier) {
+                // every partition counts the arrivals of all cores at a barrier
+                for (int other_partition_id = 0; other_partition_id < process_list_.size(); other_partition_id++) {
+                    if (other_partition_id != partition_id) {
+                        process_list_[other_partition_id].inbox.push_back(payload);
+                    }
+                }
+            } else {
+                process_list_[getPartitionId(payload.dst_id)].inbox.push_back(payload);
+            }
+        }
+    }
+}
+
+void ParallelChip::waitPartitionProcess(int partition_id) {
+    int status;
+    while (waitpid(process_list_[partition_id].pid, &status, 0) < 0) {
+        if (errno != EINTR) {
+            throw std::runtime_error(
+                fmt::format("ParallelChip: wait for partition {} failed, {}", partition_id, std::strerror(errno)));
+        }
+    }
+    if (WIFSIGNALED(status)) {
+        throw std::runtime_error(
+            fmt::format("ParallelChip: partition {} was killed by signal {}", partition_id, WTERMSIG(status)));
+    }
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+        throw std::runtime_error(
+            fmt::format("ParallelChip: partition {} exited with status {}", partition_id, WEXITSTATUS(status)));
+    }
+}
+
+// the energy reports are added in the order of the sequential simulation. the network energy is computed once from
+// the flits of all partitions, so it is the sequential one. each partition reserves the mesh links only for the
+// messages it sends, so the traffic of a link is the sum over the partitions, while messages of different partitions
+// do not wait for each other
+void ParallelChip::finishPartitions() {
+    std::vector<std::pair<std::string, EnergyReporter>> core_reporters;
+    std::vector<std::pair<std::string, EnergyReporter>> other_reporters;
+    Network network{"Network", config_.chip_config.network_config, config_.sim_config,
+                    config_.chip_config.global_memory_config.global_memory_switch_id};
+    for (int partition_id = 0; partition_id < process_list_.size(); partition_id++) {
+        auto& process = process_list_[partition_id];
+        PartitionCommand command{.finish = true, .running_time = running_time_.value()};
+        writeAll(process.command_fd, &command, sizeof(command), partition_id);
+
+        auto energy_reporter_json = readJson(process.status_fd, partition_id);
+        long long payload_allocation_cnt;
+        readAll(process.status_fd, &payload_allocation_cnt, sizeof(payload_allocation_cnt), partition_id);
+        payload_allocation_cnt_ += payload_allocation_cnt;
+        auto memory_bank_reports = readJson(process.status_fd, partition_id).get<std::vector<MemoryBankReport>>();
+        memory_bank_reports_.insert(memory_bank_reports_.end(), memory_bank_reports.begin(),
+                                    memory_bank_reports.end());
+        for (const auto& link : readJson(process.status_fd, partition_id).get<std::vector<NetworkLinkReport>>()) {
+            auto found = std::find_if(network_link_reports_.begin(), network_link_reports_.end(),
+                                      [&](const NetworkLinkReport& other) { return other.name == link.name; });
+            if (found == network_link_reports_.end()) {
+                network_link_reports_.push_back(link);
+            } else {
+                found->flit_cnt += link.flit_cnt;
+                found->busy_time += link.busy_time;
+                found->stall_time += link.stall_time;
+            }
+        }
+        // only the partition of the global memory has a memory queue
+        auto memory_queue_reports = readJson(process.status_fd, partition_id).get<std::vector<MemoryQueueReport>>();
+        memory_queue_reports_.insert(memory_queue_reports_.end(), memory_queue_reports.begin(),
+                                     memory_queue_reports.end());
+        network.addFlitCount(readJson(process.status_fd, partition_id).get<NetworkFlitCount>());
+        // the partitions hold consecutive cores
+        auto core_states = readJson(process.status_fd, partition_id).get<std::vector<CoreState>>();
+        core_states_.insert(core_states_.end(), core_states.begin(), core_states.end());
+
+        auto sub_module_reporters = energy_reporter_json.get<std::vector<std::pair<std::string, EnergyReporter>>>();
+        for (auto& [name, sub_module_reporter] : sub_module_reporters) {
+            if (name == "Network") {
+                continue;
+            }
+            if (name == "GlobalMemory" || name == "Barrier") {
+                other_reporters.emplace_back(std::move(name), std::move(sub_module_reporter));
+            } else {
+                core_reporters.emplace_back(std::move(name), std::move(sub_module_reporter));
+            }
+        }
+
+        close(process.command_fd);
+        close(process.status_fd);
+        waitPartitionProcess(partition_id);
+    }
+
+    auto network_position =
+        std::stable_partition(other_reporters.begin(), other_reporters.end(),
+                              [](const auto& reporter) { return reporter.first == "GlobalMemory"; });
+    EnergyCounter::setRunningTimeNS(running_time_);
+    other_reporters.emplace(network_position, "Network", network.getEnergyReporter());
+    for (auto& [name, sub_module_reporter] : core_reporters) {
+        energy_reporter_.addSubModule(name, std::move(sub_module_reporter));
+    }
+    for (auto& [name, sub_module_reporter] : other_reporters) {
+        energy_reporter_.addSubModule(name, std::move(sub_module_reporter));
+    }
+}
+
+}  // namespace pimsim
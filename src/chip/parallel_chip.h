@@ -0,0 +1,87 @@
+//
+// Created by wyk on 2024/11/13.
+//
+
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "chip.h"
+
+namespace pimsim {
+
+// Simulates the chip split into partitions of consecutive cores. A SystemC kernel can not be shared by host threads,
+// so every partition runs its own kernel in a forked process. All partitions advance by windows shorter than the
+// minimum network latency between two partitions, and the payloads crossing partitions are exchanged between
+// windows, so each payload reaches its target before its arrival time and the result equals the sequential one.
+// With a single partition the chip is simulated in this process as before.
+class ParallelChip {
+public:
+    ParallelChip(std::string name, const Config& config, const std::vector<std::vector<Instruction>>& core_ins_list);
+
+    // the partitions need a positive network latency between them to advance by windows
+    [[nodiscard]] bool checkValid() const;
+
+    // cores are fast-forwarded functionally to the target before the detailed simulation, see Core::fastForward
+    void setFastForwardTarget(const FastForwardTarget& target);
+
+    void run();
+
+    Reporter report(std::ostream& os);
+
+    // of all cores by core id, after the run
+    std::vector<CoreState> getCoreStates();
+
+private:
+    struct PartitionProcess {
+        int pid{-1};
+        int command_fd{-1};
+        int status_fd{-1};
+
+        bool finished{false};
+        sc_core::sc_time::value_type finish_time{0};
+        sc_core::sc_time::value_type now{0};
+        bool pending_activity{true};
+        sc_core::sc_time::value_type next_activity_time{0};
+
+        std::vector<RemoteNetworkPayload> inbox{};
+    };
+
+    [[nodiscard]] int getPartitionId(int switch_id) const;
+    [[nodiscard]] sc_core::sc_time::value_type getWindowTicks() const;
+
+    void startPartitionProcesses();
+    [[noreturn]] void runPartitionProcess(int partition_id, int command_fd, int status_fd);
+
+    // runs the partitions to 'run_until' at the same time, then routes the payloads they sent
+    void runPartitions(const std::vector<int>& partition_id_list, sc_core::sc_time::value_type run_until,
+                       bool pause_on_finish);
+    void finishPartitions();
+    void waitPartitionProcess(int partition_id);
+
+private:
+    std::string name_;
+    const Config& config_;
+    const std::vector<std::vector<Instruction>> core_ins_list_;
+
+    bool fast_forward_{false};
+    FastForwardTarget fast_forward_target_{};
+
+    std::vector<ChipPartition> partition_list_;
+    std::vector<int> core_partition_map_;  // indexed by core id
+    sc_core::sc_time::value_type window_ticks_{0};
+
+    std::shared_ptr<Chip> chip_;
+    std::vector<PartitionProcess> process_list_;
+
+    sc_core::sc_time running_time_{};
+    EnergyReporter energy_reporter_;
+    long long payload_allocation_cnt_{0};
+    std::vector<MemoryBankReport> memory_bank_reports_;
+    std::vector<NetworkLinkReport> network_link_reports_;
+    std::vector<MemoryQueueReport> memory_queue_reports_;
+    std::vector<CoreState> core_states_;
+};
+
+}  // namespace pimsim
@@ -444,6 +444,11 @@ bool PimUnitConfig::checkValid() const {
         return false;
     }
 
+    if (macro_sim_mode == +PimMacroSimMode::other) {
+        std::cerr << "PimUnitConfig not valid, 'macro_sim_mode' must be 'event_driven' or 'analytic'" << std::endl;
+        return false;
+    }
+
     if (const int total_byte_size = macro_total_cnt * macro_size.compartment_cnt_per_macro *
                                     macro_size.element_cnt_per_compartment * macro_size.row_cnt_per_element *
                                     macro_size.bit_width_per_row / BYTE_TO_BIT;
@@ -473,11 +478,13 @@ void to_json(nlohmann::ordered_json& j, const PimUnitConfig& t) {
         j["bit_sparse_config"] = t.bit_sparse_config;
     }
     j["input_bit_sparse"] = t.input_bit_sparse;
+    j["macro_sim_mode"] = t.macro_sim_mode;
 }
 
 DEFINE_TYPE_FROM_JSON_FUNCTION_WITH_DEFAULT(PimUnitConfig, macro_total_cnt, macro_group_size, macro_size, address_space,
                                             ipu, sram, adder_tree, shift_adder, result_adder, value_sparse,
-                                            value_sparse_config, bit_sparse, bit_sparse_config, input_bit_sparse)
+                                            value_sparse_config, bit_sparse, bit_sparse_config, input_bit_sparse,
+                                            macro_sim_mode)
 
 // LocalMemoryUnit
 bool RAMConfig::checkValid() const {
@@ -500,6 +507,15 @@ bool RAMConfig::checkValid() const {
         std::cerr << "RAMConfig not valid, 'image_file' must be non-empty when RAM has a image file." << std::endl;
         return false;
     }
+    if (!check_positive(bank_cnt, port_cnt) || bank_cnt > 64) {
+        std::cerr << "RAMConfig not valid, 'bank_cnt, port_cnt' must be positive and 'bank_cnt' at most 64"
+                  << std::endl;
+        return false;
+    }
+    if (!check_not_negative(bank_interleave_byte)) {
+        std::cerr << "RAMConfig not valid, 'bank_interleave_byte' must be non-negative" << std::endl;
+        return false;
+    }
     return true;
 }
 
@@ -515,11 +531,14 @@ void to_json(nlohmann::ordered_json& j, const RAMConfig& t) {
     if (t.has_image) {
         j["image_file"] = t.image_file;
     }
+    j["bank_cnt"] = t.bank_cnt;
+    j["port_cnt"] = t.port_cnt;
+    j["bank_interleave_byte"] = t.bank_interleave_byte;
 }
 
 DEFINE_TYPE_FROM_JSON_FUNCTION_WITH_DEFAULT(RAMConfig, size_byte, width_byte, write_latency_cycle, read_latency_cycle,
                                             static_power_mW, write_dynamic_power_mW, read_dynamic_power_mW, has_image,
-                                            image_file)
+                                            image_file, bank_cnt, port_cnt, bank_interleave_byte)
 
 bool RegBufferConfig::checkValid() const {
     if (!check_positive(size_byte, read_max_width_byte, write_max_width_byte, rw_min_unit_byte)) {
@@ -630,16 +649,31 @@ bool LocalMemoryUnitConfig::checkValid() const {
         std::cerr << "LocalMemoryUnitConfig not valid" << std::endl;
         return false;
     }
+    if (local_memory_list.size() > LOCAL_MEMORY_MAX_CNT) {
+        std::cerr << fmt::format("LocalMemoryUnitConfig not valid, local memory count must not exceed {}",
+                                 LOCAL_MEMORY_MAX_CNT)
+                  << std::endl;
+        return false;
+    }
     return true;
 }
 
 DEFINE_TYPE_FROM_TO_JSON_FUNCTION_WITH_DEFAULT(LocalMemoryUnitConfig, local_memory_list)
 
 bool TransferUnitConfig::checkValid() const {
+    if (!check_positive(max_outstanding_load_cnt)) {
+        std::cerr << "TransferUnitConfig not valid, 'max_outstanding_load_cnt' must be positive" << std::endl;
+        return false;
+    }
+    if (!check_not_negative(load_batch_size_byte)) {
+        std::cerr << "TransferUnitConfig not valid, 'load_batch_size_byte' must be non-negative" << std::endl;
+        return false;
+    }
     return true;
 }
 
-DEFINE_TYPE_FROM_TO_JSON_FUNCTION_WITH_DEFAULT(TransferUnitConfig, pipeline)
+DEFINE_TYPE_FROM_TO_JSON_FUNCTION_WITH_DEFAULT(TransferUnitConfig, pipeline, max_outstanding_load_cnt,
+                                               load_batch_size_byte)
 
 // CoreConfig
 bool CoreConfig::checkValid() const {
@@ -678,28 +712,171 @@ DEFINE_TYPE_FROM_TO_JSON_FUNCTION_WITH_DEFAULT(CoreConfig, control_unit_config,
                                                scalar_unit_config, simd_unit_config, pim_unit_config,
                                                local_memory_unit_config, transfer_unit_config)
 
+// MeshConfig
+int MeshConfig::getRouterCount() const {
+    return x_cnt * y_cnt;
+}
+
+bool MeshConfig::checkValid() const {
+    if (!check_positive(x_cnt, y_cnt, link_width_byte, router_pipeline_cycle)) {
+        std::cerr << "MeshConfig not valid, 'x_cnt, y_cnt, link_width_byte, router_pipeline_cycle' must be positive"
+                  << std::endl;
+        return false;
+    }
+    if (!check_not_negative(link_latency_cycle, link_energy_pJ, router_energy_pJ)) {
+        std::cerr << "MeshConfig not valid, 'link_latency_cycle, link_energy_pJ, router_energy_pJ' must be non-negative"
+                  << std::endl;
+        return false;
+    }
+    if (global_memory_router_id < 0 || global_memory_router_id >= getRouterCount()) {
+        std::cerr << "MeshConfig not valid, 'global_memory_router_id' must be a router of the mesh" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+DEFINE_TYPE_FROM_TO_JSON_FUNCTION_WITH_DEFAULT(MeshConfig, x_cnt, y_cnt, link_width_byte, router_pipeline_cycle,
+                                               link_latency_cycle, link_energy_pJ, router_energy_pJ,
+                                               global_memory_router_id)
+
 // NetworkConfig
 bool NetworkConfig::checkValid() const {
-    if (const bool valid = bus_width_byte > 0 && !network_config_file_path.empty(); !valid) {
-        std::cerr << "NetworkConfig not valid, 'bus_width_byte' must be positive and 'network_config_file_path' must "
-                     "not be empty"
+    if (model == +NetworkModel::other) {
+        std::cerr << "NetworkConfig not valid, 'model' must be 'table' or 'mesh'" << std::endl;
+        return false;
+    }
+    if (model == +NetworkModel::table) {
+        if (const bool valid = bus_width_byte > 0 && (generate_table || !network_config_file_path.empty()); !valid) {
+            std::cerr << "NetworkConfig not valid, 'bus_width_byte' must be positive and 'network_config_file_path' "
+                         "must not be empty without 'generate_table'"
+                      << std::endl;
+            return false;
+        }
+    }
+    if (usesMesh() && !mesh_config.checkValid()) {
+        std::cerr << "NetworkConfig not valid" << std::endl;
+        return false;
+    }
+    if (!check_not_negative(multicast_fanout, flit_interval_cycle)) {
+        std::cerr << "NetworkConfig not valid, 'multicast_fanout, flit_interval_cycle' must be non-negative"
+                  << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool NetworkConfig::usesMesh() const {
+    return model == +NetworkModel::mesh || generate_table;
+}
+
+DEFINE_TYPE_FROM_TO_JSON_FUNCTION_WITH_DEFAULT(NetworkConfig, model, bus_width_byte, network_config_file_path,
+                                               generate_table, table_override_file_path, pipelined_flit,
+                                               flit_interval_cycle, mesh_config, multicast_fanout);
+
+bool BarrierConfig::checkValid() const {
+    if (type == +BarrierType::other) {
+        std::cerr << "BarrierConfig not valid, 'type' must be 'tree' or 'wire'" << std::endl;
+        return false;
+    }
+    if (!check_positive(hop_latency_cycle, wire_latency_cycle) || tree_fanout < 2) {
+        std::cerr << "BarrierConfig not valid, 'hop_latency_cycle, wire_latency_cycle' must be positive and "
+                     "'tree_fanout' at least 2"
+                  << std::endl;
+        return false;
+    }
+    if (!check_not_negative(hop_energy_pJ, wire_energy_pJ)) {
+        std::cerr << "BarrierConfig not valid, 'hop_energy_pJ, wire_energy_pJ' must be non-negative" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+DEFINE_TYPE_FROM_TO_JSON_FUNCTION_WITH_DEFAULT(BarrierConfig, type, tree_fanout, hop_latency_cycle, hop_energy_pJ,
+                                               wire_latency_cycle, wire_energy_pJ)
+
+bool DRAMConfig::checkValid() const {
+    if (!check_positive(size_byte, channel_cnt, bank_cnt, row_size_byte, burst_size_byte, burst_cycle)) {
+        std::cerr << "DRAMConfig not valid, 'size_byte, channel_cnt, bank_cnt, row_size_byte, burst_size_byte, "
+                     "burst_cycle' must be positive"
+                  << std::endl;
+        return false;
+    }
+    if (channel_cnt * bank_cnt > 64) {
+        std::cerr << "DRAMConfig not valid, 'channel_cnt * bank_cnt' must not exceed 64" << std::endl;
+        return false;
+    }
+    if (row_size_byte % burst_size_byte != 0) {
+        std::cerr << "DRAMConfig not valid, 'burst_size_byte' cannot divide 'row_size_byte'" << std::endl;
+        return false;
+    }
+    if (!check_not_negative(row_hit_latency_cycle, row_miss_latency_cycle, refresh_interval_cycle, refresh_cycle,
+                            static_power_mW, activate_dynamic_power_mW, write_dynamic_power_mW,
+                            read_dynamic_power_mW)) {
+        std::cerr << "DRAMConfig not valid, 'row_hit_latency_cycle, row_miss_latency_cycle, refresh_interval_cycle, "
+                     "refresh_cycle, static_power_mW, activate_dynamic_power_mW, write_dynamic_power_mW, "
+                     "read_dynamic_power_mW' must be non-negative"
                   << std::endl;
         return false;
     }
+    if (refresh_interval_cycle != 0 && refresh_cycle >= refresh_interval_cycle) {
+        std::cerr << "DRAMConfig not valid, 'refresh_cycle' must be less than 'refresh_interval_cycle'" << std::endl;
+        return false;
+    }
+    if (has_image && image_file.empty()) {
+        std::cerr << "DRAMConfig not valid, 'image_file' must be non-empty when DRAM has a image file." << std::endl;
+        return false;
+    }
     return true;
 }
 
-DEFINE_TYPE_FROM_TO_JSON_FUNCTION_WITH_DEFAULT(NetworkConfig, bus_width_byte, network_config_file_path);
+DEFINE_TYPE_FROM_TO_JSON_FUNCTION_WITH_DEFAULT(DRAMConfig, size_byte, channel_cnt, bank_cnt, row_size_byte,
+                                               burst_size_byte, burst_cycle, row_hit_latency_cycle,
+                                               row_miss_latency_cycle, refresh_interval_cycle, refresh_cycle,
+                                               static_power_mW, activate_dynamic_power_mW, write_dynamic_power_mW,
+                                               read_dynamic_power_mW, has_image, image_file)
 
 bool GlobalMemoryConfig::checkValid() const {
-    if (const bool valid = hardware_config.checkValid() && addressing.checkValid(); !valid) {
+    if (type == +GlobalMemoryType::other) {
+        std::cerr << "GlobalMemoryConfig not valid, 'type' must be 'ram' or 'dram'" << std::endl;
+        return false;
+    }
+    if (!check_not_negative(service_engine_cnt)) {
+        std::cerr << "GlobalMemoryConfig not valid, 'service_engine_cnt' must be non-negative" << std::endl;
+        return false;
+    }
+    const bool hardware_valid = (type == +GlobalMemoryType::ram && hardware_config.checkValid()) ||
+                                (type == +GlobalMemoryType::dram && dram_config.checkValid());
+    if (const bool valid = hardware_valid && addressing.checkValid(); !valid) {
         std::cerr << "GlobalMemoryConfig not valid" << std::endl;
         return false;
     }
     return true;
 }
 
-DEFINE_TYPE_FROM_TO_JSON_FUNCTION_WITH_DEFAULT(GlobalMemoryConfig, hardware_config, addressing, global_memory_switch_id)
+void to_json(nlohmann::ordered_json& j, const GlobalMemoryConfig& config) {
+    j["type"] = config.type;
+    if (config.type == +GlobalMemoryType::dram) {
+        j["hardware_config"] = config.dram_config;
+    } else {
+        j["hardware_config"] = config.hardware_config;
+    }
+    j["addressing"] = config.addressing;
+    j["global_memory_switch_id"] = config.global_memory_switch_id;
+    j["service_engine_cnt"] = config.service_engine_cnt;
+}
+
+void from_json(const nlohmann::ordered_json& j, GlobalMemoryConfig& config) {
+    const GlobalMemoryConfig default_obj{};
+    config.type = j.value("type", default_obj.type);
+    if (config.type == +GlobalMemoryType::dram) {
+        config.dram_config = j.value("hardware_config", default_obj.dram_config);
+    } else {
+        config.hardware_config = j.value("hardware_config", default_obj.hardware_config);
+    }
+    config.addressing = j.value("addressing", default_obj.addressing);
+    config.global_memory_switch_id = j.value("global_memory_switch_id", default_obj.global_memory_switch_id);
+    config.service_engine_cnt = j.value("service_engine_cnt", default_obj.service_engine_cnt);
+}
 
 // ChipConfig
 bool ChipConfig::checkValid() const {
@@ -707,15 +884,25 @@ bool ChipConfig::checkValid() const {
         std::cerr << "ChipConfig not valid, 'core_cnt' must be positive" << std::endl;
         return false;
     }
-    if (const bool valid = core_config.checkValid() && global_memory_config.checkValid() && network_config.checkValid();
+    if (const bool valid = core_config.checkValid() && global_memory_config.checkValid() &&
+                           network_config.checkValid() && barrier_config.checkValid();
         !valid) {
         std::cerr << "ChipConfig not valid" << std::endl;
         return false;
     }
+    if (network_config.usesMesh() && network_config.mesh_config.getRouterCount() < core_cnt) {
+        std::cerr << "ChipConfig not valid, the mesh must have a router for each core" << std::endl;
+        return false;
+    }
+    if (network_config.usesMesh() && global_memory_config.global_memory_switch_id >= 0) {
+        std::cerr << "ChipConfig not valid, 'global_memory_switch_id' must be negative with the mesh" << std::endl;
+        return false;
+    }
     return true;
 }
 
-DEFINE_TYPE_FROM_TO_JSON_FUNCTION_WITH_DEFAULT(ChipConfig, core_cnt, core_config, global_memory_config, network_config)
+DEFINE_TYPE_FROM_TO_JSON_FUNCTION_WITH_DEFAULT(ChipConfig, core_cnt, core_config, global_memory_config, network_config,
+                                               barrier_config)
 
 // SimConfig
 bool SimConfig::checkValid() const {
@@ -735,10 +922,19 @@ bool SimConfig::checkValid() const {
         std::cerr << "SimConfig not valid, 'sim_time_ms' must be positive" << std::endl;
         return false;
     }
+    if (!check_positive(parallel_partition_cnt)) {
+        std::cerr << "SimConfig not valid, 'parallel_partition_cnt' must be positive" << std::endl;
+        return false;
+    }
+    if (parallel_partition_cnt > 1 && sim_mode != +SimMode::run_one_round) {
+        std::cerr << "SimConfig not valid, parallel simulation only supports 'run_one_round' mode" << std::endl;
+        return false;
+    }
     return true;
 }
 
-DEFINE_TYPE_FROM_TO_JSON_FUNCTION_WITH_DEFAULT(SimConfig, period_ns, sim_mode, data_mode, sim_time_ms)
+DEFINE_TYPE_FROM_TO_JSON_FUNCTION_WITH_DEFAULT(SimConfig, period_ns, sim_mode, data_mode, sim_time_ms,
+                                               parallel_partition_cnt, loop_fast_forward)
 
 // Config
 bool Config::checkValid() const {
@@ -746,9 +942,109 @@ bool Config::checkValid() const {
         std::cerr << "Config not valid" << std::endl;
         return false;
     }
+    // each partition would own its own mesh, so the links would not be shared by the traffic between partitions
+    if (chip_config.network_config.model == +NetworkModel::mesh && sim_config.parallel_partition_cnt > 1) {
+        std::cerr << "Config not valid, the mesh network model does not support 'parallel_partition_cnt' > 1"
+                  << std::endl;
+        return false;
+    }
     return true;
 }
 
 DEFINE_TYPE_FROM_TO_JSON_FUNCTION_WITH_DEFAULT(Config, chip_config, sim_config)
 
+std::unordered_map<const double*, std::string> Config::getPowerParameterNames() const {
+    std::unordered_map<const double*, std::string> names;
+    auto add = [&names](const std::string& path, const double& power) { names.emplace(&power, path); };
+    auto add_pim_module = [&add](const std::string& path, const PimModuleConfig& config) {
+        add(path + ".static_power_mW", config.static_power_mW);
+        add(path + ".dynamic_power_mW", config.dynamic_power_mW);
+    };
+    auto add_ram = [&add](const std::string& path, const RAMConfig& config) {
+        add(path + ".static_power_mW", config.static_power_mW);
+        add(path + ".write_dynamic_power_mW", config.write_dynamic_power_mW);
+        add(path + ".read_dynamic_power_mW", config.read_dynamic_power_mW);
+    };
+
+    const std::string core = "chip_config.core_config";
+    const auto& control_unit = chip_config.core_config.control_unit_config;
+    add(core + ".control_unit_config.controller_static_power_mW", control_unit.controller_static_power_mW);
+    add(core + ".control_unit_config.controller_dynamic_power_mW", control_unit.controller_dynamic_power_mW);
+    add(core + ".control_unit_config.fetch_static_power_mW", control_unit.fetch_static_power_mW);
+    add(core + ".control_unit_config.fetch_dynamic_power_mW", control_unit.fetch_dynamic_power_mW);
+    add(core + ".control_unit_config.decode_static_power_mW", control_unit.decode_static_power_mW);
+    add(core + ".control_unit_config.decode_dynamic_power_mW", control_unit.decode_dynamic_power_mW);
+
+    const auto& register_unit = chip_config.core_config.register_unit_config;
+    add(core + ".register_unit_config.static_power_mW", register_unit.static_power_mW);
+    add(core + ".register_unit_config.dynamic_power_mW", register_unit.dynamic_power_mW);
+
+    const auto& scalar_unit = chip_config.core_config.scalar_unit_config;
+    add(core + ".scalar_unit_config.default_functor_static_power_mW", scalar_unit.default_functor_static_power_mW);
+    add(core + ".scalar_unit_config.default_functor_dynamic_power_mW", scalar_unit.default_functor_dynamic_power_mW);
+    for (int i = 0; i < scalar_unit.functor_list.size(); i++) {
+        auto path = fmt::format("{}.scalar_unit_config.functor_list[{}]", core, i);
+        add(path + ".static_power_mW", scalar_unit.functor_list[i].static_power_mW);
+        add(path + ".dynamic_power_mW", scalar_unit.functor_list[i].dynamic_power_mW);
+    }
+
+    const auto& simd_unit = chip_config.core_config.simd_unit_config;
+    for (int i = 0; i < simd_unit.functor_list.size(); i++) {
+        auto path = fmt::format("{}.simd_unit_config.functor_list[{}]", core, i);
+        add(path + ".static_power_per_functor_mW", simd_unit.functor_list[i].static_power_per_functor_mW);
+        add(path + ".dynamic_power_per_functor_mW", simd_unit.functor_list[i].dynamic_power_per_functor_mW);
+    }
+
+    const auto& pim_unit = chip_config.core_config.pim_unit_config;
+    add_pim_module(core + ".pim_unit_config.ipu", pim_unit.ipu);
+    add(core + ".pim_unit_config.sram.static_power_mW", pim_unit.sram.static_power_mW);
+    add(core + ".pim_unit_config.sram.write_dynamic_power_per_bit_mW", pim_unit.sram.write_dynamic_power_per_bit_mW);
+    add(core + ".pim_unit_config.sram.read_dynamic_power_per_bit_mW", pim_unit.sram.read_dynamic_power_per_bit_mW);
+    add_pim_module(core + ".pim_unit_config.adder_tree", pim_unit.adder_tree);
+    add_pim_module(core + ".pim_unit_config.shift_adder", pim_unit.shift_adder);
+    add_pim_module(core + ".pim_unit_config.result_adder", pim_unit.result_adder);
+    add(core + ".pim_unit_config.value_sparse_config.static_power_mW", pim_unit.value_sparse_config.static_power_mW);
+    add(core + ".pim_unit_config.value_sparse_config.dynamic_power_mW", pim_unit.value_sparse_config.dynamic_power_mW);
+    const auto& bit_sparse = pim_unit.bit_sparse_config;
+    add(core + ".pim_unit_config.bit_sparse_config.static_power_mW", bit_sparse.static_power_mW);
+    add(core + ".pim_unit_config.bit_sparse_config.dynamic_power_mW", bit_sparse.dynamic_power_mW);
+    add(core + ".pim_unit_config.bit_sparse_config.reg_buffer_static_power_mW", bit_sparse.reg_buffer_static_power_mW);
+    add(core + ".pim_unit_config.bit_sparse_config.reg_buffer_dynamic_power_mW_per_unit",
+        bit_sparse.reg_buffer_dynamic_power_mW_per_unit);
+
+    const auto& local_memory_list = chip_config.core_config.local_memory_unit_config.local_memory_list;
+    for (int i = 0; i < local_memory_list.size(); i++) {
+        auto path = fmt::format("{}.local_memory_unit_config.local_memory_list[{}]", core, i);
+        const auto& local_memory = local_memory_list[i];
+        if (local_memory.type == +LocalMemoryType::ram) {
+            add_ram(path + ".hardware_config", local_memory.ram_config);
+        } else if (local_memory.type == +LocalMemoryType::reg_buffer) {
+            add(path + ".hardware_config.static_power_mW", local_memory.reg_buffer_config.static_power_mW);
+            add(path + ".hardware_config.rw_dynamic_power_per_unit_mW",
+                local_memory.reg_buffer_config.rw_dynamic_power_per_unit_mW);
+        }
+    }
+
+    const auto& global_memory = chip_config.global_memory_config;
+    if (global_memory.type == +GlobalMemoryType::dram) {
+        const std::string dram = "chip_config.global_memory_config.hardware_config";
+        add(dram + ".static_power_mW", global_memory.dram_config.static_power_mW);
+        add(dram + ".activate_dynamic_power_mW", global_memory.dram_config.activate_dynamic_power_mW);
+        add(dram + ".write_dynamic_power_mW", global_memory.dram_config.write_dynamic_power_mW);
+        add(dram + ".read_dynamic_power_mW", global_memory.dram_config.read_dynamic_power_mW);
+    } else {
+        add_ram("chip_config.global_memory_config.hardware_config", global_memory.hardware_config);
+    }
+
+    // energy per event rather than power, the activity is the event count
+    const auto& mesh = chip_config.network_config.mesh_config;
+    add("chip_config.network_config.mesh_config.link_energy_pJ", mesh.link_energy_pJ);
+    add("chip_config.network_config.mesh_config.router_energy_pJ", mesh.router_energy_pJ);
+    const auto& barrier = chip_config.barrier_config;
+    add("chip_config.barrier_config.hop_energy_pJ", barrier.hop_energy_pJ);
+    add("chip_config.barrier_config.wire_energy_pJ", barrier.wire_energy_pJ);
+
+    return std::move(names);
+}
+
 }  // namespace pimsim
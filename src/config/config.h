@@ -6,6 +6,7 @@
 
 #include <array>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "config_enum.h"
@@ -26,6 +27,8 @@ static constexpr int SIMD_INSTRUCTION_OPCODE_BIT_LENGTH = 8;
 static constexpr int BYTE_TO_BIT = 8;
 static constexpr unsigned char BYTE_MAX_VALUE = 0xff;
 
+static constexpr int LOCAL_MEMORY_MAX_CNT = 63;
+
 struct ControlUnitConfig {
     double controller_static_power_mW{0.0};   // mW
     double controller_dynamic_power_mW{0.0};  // mW
@@ -248,6 +251,11 @@ struct PimUnitConfig {
 
     bool input_bit_sparse{false};
 
+    // macro simulation mode, 'analytic' computes the macro pipeline schedule in closed form instead of
+    // stepping every input bit batch through the submodule processes, and a macro group then advances all of its
+    // macros from its own issue process
+    PimMacroSimMode macro_sim_mode{PimMacroSimMode::event_driven};
+
     [[nodiscard]] bool checkValid() const;
     DECLARE_TYPE_FROM_TO_JSON_FUNCTION_INTRUSIVE(PimUnitConfig)
 };
@@ -266,6 +274,12 @@ struct RAMConfig {
     bool has_image{false};     // whether RAM memory has an image file
     std::string image_file{};  // RAM memory image file path
 
+    // banking, an access holds the banks its bytes fall in and one port until it finishes, accesses that hold
+    // different banks are served at the same time
+    int bank_cnt{1};              // at most 64
+    int port_cnt{1};              // accesses served at the same time
+    int bank_interleave_byte{0};  // Byte, consecutive blocks of this size go to consecutive banks, 0 for 'width_byte'
+
     [[nodiscard]] bool checkValid() const;
     DECLARE_TYPE_FROM_TO_JSON_FUNCTION_INTRUSIVE(RAMConfig)
 };
@@ -309,6 +323,12 @@ struct LocalMemoryUnitConfig {
 struct TransferUnitConfig {
     bool pipeline{false};
 
+    // global loads, split into batches of 'load_batch_size_byte' that are loaded at most 'max_outstanding_load_cnt' at
+    // a time and written to the local memory in order. the switch of the core keeps as many transports in flight, so
+    // with one a global store and a global load still go one after the other
+    int max_outstanding_load_cnt{1};
+    int load_batch_size_byte{0};  // Byte, 0 for a single batch of the whole load
+
     [[nodiscard]] bool checkValid() const;
     DECLARE_TYPE_FROM_TO_JSON_FUNCTION_INTRUSIVE(TransferUnitConfig)
 };
@@ -326,19 +346,113 @@ struct CoreConfig {
     DECLARE_TYPE_FROM_TO_JSON_FUNCTION_INTRUSIVE(CoreConfig)
 };
 
+// A 2D mesh of 'x_cnt' * 'y_cnt' routers with XY routing. Core i attaches to router i in row-major order, and the
+// global memory to router 'global_memory_router_id'. Every node has its own injection and ejection port, and each
+// port or link between two routers moves one flit of 'link_width_byte' per cycle.
+struct MeshConfig {
+    int x_cnt{1};
+    int y_cnt{1};
+    int link_width_byte{16};  // Byte
+
+    int router_pipeline_cycle{1};  // cycle, per router passed by the head flit
+    int link_latency_cycle{1};     // cycle, per link between two routers passed by the head flit
+    double link_energy_pJ{0.0};    // pJ, per flit per link between two routers
+    double router_energy_pJ{0.0};  // pJ, per flit per router
+
+    int global_memory_router_id{0};
+
+    [[nodiscard]] int getRouterCount() const;
+
+    [[nodiscard]] bool checkValid() const;
+    DECLARE_TYPE_FROM_TO_JSON_FUNCTION_INTRUSIVE(MeshConfig)
+};
+
+// With the table model, the latency and energy per flit of each pair of switches are read from
+// 'network_config_file_path', and only the outgoing queue of each switch is serialized. With 'generate_table', the
+// tables are computed from 'mesh_config' at startup instead, as for a single flit on an idle mesh, and the pairs in
+// 'table_override_file_path', if given, override them. By default every flit of a message pays the latency of the
+// table in turn, with 'pipelined_flit' the flits follow the head flit through the network one every
+// 'flit_interval_cycle', so a message of n flits takes the latency of the table plus (n - 1) flit intervals. With the
+// mesh model, messages reserve the links along their route in 'mesh_config' and queue on the links taken by other
+// messages, and the flits are always pipelined.
+//
+// A multicast goes down a tree over the source and its destinations sorted by latency from the source, where each
+// node forwards to up to 'multicast_fanout' nodes one after another, so the nearer destinations forward to the farther
+// ones. With 'multicast_fanout' 0, the source sends to every destination itself.
 struct NetworkConfig {
-    int bus_width_byte{16};
+    NetworkModel model{NetworkModel::table};
 
+    int bus_width_byte{16};
     std::string network_config_file_path{"./network_config.json"};
+    bool generate_table{false};
+    std::string table_override_file_path{};  // in the format of 'network_config_file_path', may leave pairs out
+    bool pipelined_flit{false};
+    double flit_interval_cycle{1.0};  // cycle, between two flits of a message
+
+    MeshConfig mesh_config{};
+
+    int multicast_fanout{0};
 
     [[nodiscard]] bool checkValid() const;
+    // whether the switches are placed on the routers of 'mesh_config'
+    [[nodiscard]] bool usesMesh() const;
+
     DECLARE_TYPE_FROM_TO_JSON_FUNCTION_INTRUSIVE(NetworkConfig)
 };
 
+// Barrier instructions are served by the barrier hardware of the chip instead of the network. With a tree, the
+// arrivals are gathered up a tree of 'tree_fanout' and the release is sent back down, one hop each level. With wires,
+// a dedicated wired-and line releases the cores a fixed latency after the last arrival.
+struct BarrierConfig {
+    BarrierType type{BarrierType::tree};
+
+    int tree_fanout{4};
+    int hop_latency_cycle{1};   // cycle, per tree level and direction
+    double hop_energy_pJ{0.0};  // pJ, per message between two tree nodes
+
+    int wire_latency_cycle{1};   // cycle
+    double wire_energy_pJ{0.0};  // pJ, per arriving core
+
+    [[nodiscard]] bool checkValid() const;
+    DECLARE_TYPE_FROM_TO_JSON_FUNCTION_INTRUSIVE(BarrierConfig)
+};
+
+// Addresses are split into rows of 'row_size_byte', consecutive rows go to the channels in turn, then to the banks of
+// a channel. An access waits for the refresh of its channel, opens its row in the row buffer of the bank if not yet
+// open, then moves its bursts over the data bus of the channel, which is shared by all banks of the channel.
+struct DRAMConfig {
+    int size_byte{1048576};  // Byte, total dram size
+    int channel_cnt{1};
+    int bank_cnt{8};          // per channel, at most 64 banks in all channels
+    int row_size_byte{2048};  // Byte, size of the row buffer of a bank
+    int burst_size_byte{64};  // Byte, data moved by one burst
+    int burst_cycle{4};       // cycle, time a burst holds the data bus of its channel
+
+    int row_hit_latency_cycle{15};     // cycle, column access to an open row
+    int row_miss_latency_cycle{45};    // cycle, precharge, activate and column access
+    int refresh_interval_cycle{7800};  // cycle, 0 for no refresh
+    int refresh_cycle{350};            // cycle, time a channel is blocked by each refresh
+
+    double static_power_mW{1.0};            // mW, including the refresh
+    double activate_dynamic_power_mW{1.0};  // mW, while opening a row
+    double write_dynamic_power_mW{1.0};     // mW, while bursting
+    double read_dynamic_power_mW{1.0};      // mW, while bursting
+
+    bool has_image{false};     // whether DRAM memory has an image file
+    std::string image_file{};  // DRAM memory image file path
+
+    [[nodiscard]] bool checkValid() const;
+    DECLARE_TYPE_FROM_TO_JSON_FUNCTION_INTRUSIVE(DRAMConfig)
+};
+
 struct GlobalMemoryConfig {
+    GlobalMemoryType type{GlobalMemoryType::ram};
     RAMConfig hardware_config{};
+    DRAMConfig dram_config{};  // read from 'hardware_config' when the type is dram
     AddressSpaceConfig addressing{};
     int global_memory_switch_id{-10};
+    // the requests served at once, the others wait in the input queue of the memory, 0 for no limit
+    int service_engine_cnt{0};
 
     [[nodiscard]] bool checkValid() const;
     DECLARE_TYPE_FROM_TO_JSON_FUNCTION_INTRUSIVE(GlobalMemoryConfig)
@@ -349,6 +463,7 @@ struct ChipConfig {
     CoreConfig core_config{};
     GlobalMemoryConfig global_memory_config{};
     NetworkConfig network_config;
+    BarrierConfig barrier_config{};
 
     [[nodiscard]] bool checkValid() const;
     DECLARE_TYPE_FROM_TO_JSON_FUNCTION_INTRUSIVE(ChipConfig)
@@ -359,6 +474,11 @@ struct SimConfig {
     SimMode sim_mode{SimMode::run_one_round};
     DataMode data_mode{DataMode::real_data};
     double sim_time_ms{1.0};  // ms
+    // cores are split into this many partitions simulated by parallel processes, 1 for sequential simulation
+    int parallel_partition_cnt{1};
+    // skip the remaining iterations of loops that reach a steady state, their registers and local memories are updated
+    // by executing them functionally, while time and energy are extrapolated from the steady iterations
+    bool loop_fast_forward{false};
 
     [[nodiscard]] bool checkValid() const;
     DECLARE_TYPE_FROM_TO_JSON_FUNCTION_INTRUSIVE(SimConfig)
@@ -369,6 +489,8 @@ struct Config {
     SimConfig sim_config{};
 
     [[nodiscard]] bool checkValid() const;
+    // all power parameters by the address of their field, named by their path in the config
+    [[nodiscard]] std::unordered_map<const double*, std::string> getPowerParameterNames() const;
     DECLARE_TYPE_FROM_TO_JSON_FUNCTION_INTRUSIVE(Config)
 };
 
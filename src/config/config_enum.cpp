@@ -18,4 +18,12 @@ DEFINE_ENUM_FROM_TO_JSON_FUNCTION(SIMDInputType, vector, scalar, other)
 
 DEFINE_ENUM_FROM_TO_JSON_FUNCTION(PimSRAMAddressSpaceContinuousMode, intergroup, intragroup, other)
 
+DEFINE_ENUM_FROM_TO_JSON_FUNCTION(PimMacroSimMode, event_driven, analytic, other)
+
+DEFINE_ENUM_FROM_TO_JSON_FUNCTION(GlobalMemoryType, ram, dram, other)
+
+DEFINE_ENUM_FROM_TO_JSON_FUNCTION(BarrierType, tree, wire, other)
+
+DEFINE_ENUM_FROM_TO_JSON_FUNCTION(NetworkModel, table, mesh, other)
+
 }  // namespace pimsim
\ No newline at end of file
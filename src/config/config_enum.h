@@ -29,4 +29,20 @@ BETTER_ENUM(PimSRAMAddressSpaceContinuousMode, int,  // NOLINT(*-no-recursion, *
             intergroup = 1, intragroup = 2, other = 3)
 DECLARE_TYPE_FROM_TO_JSON_FUNCTION_NON_INTRUSIVE(PimSRAMAddressSpaceContinuousMode)
 
+BETTER_ENUM(PimMacroSimMode, int,  // NOLINT(*-no-recursion, *-explicit-constructor)
+            event_driven = 0, analytic = 1, other = 2)
+DECLARE_TYPE_FROM_TO_JSON_FUNCTION_NON_INTRUSIVE(PimMacroSimMode)
+
+BETTER_ENUM(GlobalMemoryType, int,  // NOLINT(*-no-recursion, *-explicit-constructor)
+            ram = 0, dram = 1, other = 2)
+DECLARE_TYPE_FROM_TO_JSON_FUNCTION_NON_INTRUSIVE(GlobalMemoryType)
+
+BETTER_ENUM(BarrierType, int,  // NOLINT(*-no-recursion, *-explicit-constructor)
+            tree = 0, wire = 1, other = 2)
+DECLARE_TYPE_FROM_TO_JSON_FUNCTION_NON_INTRUSIVE(BarrierType)
+
+BETTER_ENUM(NetworkModel, int,  // NOLINT(*-no-recursion, *-explicit-constructor)
+            table = 0, mesh = 1, other = 2)
+DECLARE_TYPE_FROM_TO_JSON_FUNCTION_NON_INTRUSIVE(NetworkModel)
+
 }  // namespace pimsim
\ No newline at end of file
@@ -4,14 +4,32 @@
 
 #include "core.h"
 
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
 #include <utility>
 
+#include "chip/barrier_manager.h"
 #include "fmt/format.h"
 #include "isa/isa.h"
 #include "util/log.h"
+#include "util/util.h"
 
 namespace pimsim {
 
+DEFINE_TYPE_FROM_TO_JSON_FUNCTION_WITH_DEFAULT(FastForwardTarget, to_pc, value);
+
+DEFINE_TYPE_FROM_TO_JSON_FUNCTION_WITH_DEFAULT(CoreState, general_regs, special_regs, local_memory_data,
+                                               macro_group_activation_element_column_cnt,
+                                               macro_group_activation_macro_cnt);
+
+bool CoreState::operator==(const CoreState &another) const {
+    return general_regs == another.general_regs && special_regs == another.special_regs &&
+           local_memory_data == another.local_memory_data &&
+           macro_group_activation_element_column_cnt == another.macro_group_activation_element_column_cnt &&
+           macro_group_activation_macro_cnt == another.macro_group_activation_macro_cnt;
+}
+
 Core::Core(int core_id, const char *name, const Config &config, Clock *clk, std::vector<Instruction> ins_list,
            std::function<void()> finish_run_call, bool check, std::ostream &reg_stat_os)
     : BaseModule(name, config.sim_config, this, clk)
@@ -22,6 +40,8 @@ Core::Core(int core_id, const char *name, const Config &config, Clock *clk, std:
     , check(check)
     , reg_stat_os_(reg_stat_os)
     , ins_list_(std::move(ins_list))
+    , loop_fast_forward_(config.sim_config.loop_fast_forward && !check)
+    , ins_decode_cnt_(ins_list_.size(), 0)
     , scalar_unit_("ScalarUnit", core_config_.scalar_unit_config, config.sim_config, this, clk)
     , simd_unit_("SIMDUnit", core_config_.simd_unit_config, config.sim_config, this, clk)
     , transfer_unit_("TransferUnit", core_config_.transfer_unit_config, config.sim_config, this, clk, core_id,
@@ -35,7 +55,8 @@ Core::Core(int core_id, const char *name, const Config &config, Clock *clk, std:
     , local_memory_unit_("LocalMemoryUnit", core_config_.local_memory_unit_config, config.sim_config,
                          core_config_.pim_unit_config, this, clk)
     , reg_unit_("RegUnit", core_config_.register_unit_config, config.sim_config, this, clk)
-    , core_switch_("CoreSwitch", config.sim_config, this, clk, core_id)
+    , core_switch_("CoreSwitch", config.sim_config, this, clk, core_id,
+                   core_config_.transfer_unit_config.max_outstanding_load_cnt)
 
     , scalar_stall_handler_(decode_new_ins_trigger_)
     , simd_stall_handler_(decode_new_ins_trigger_)
@@ -117,6 +138,10 @@ void Core::bindNetwork(Network *network) {
     core_switch_.bindNetwork(network);
 }
 
+void Core::bindBarrierManager(BarrierManager *barrier_manager) {
+    barrier_manager_ = barrier_manager;
+}
+
 EnergyReporter Core::getEnergyReporter() {
     EnergyReporter reporter;
     reporter.addSubModule("ScalarUnit", EnergyReporter{scalar_unit_.getEnergyReporter()});
@@ -126,9 +151,20 @@ EnergyReporter Core::getEnergyReporter() {
     reporter.addSubModule("PimOutput", EnergyReporter{pim_output_unit_.getEnergyReporter()});
     reporter.addSubModule("PimTransfer", EnergyReporter{pim_transfer_unit_.getEnergyReporter()});
     reporter.addSubModule("LocalMemoryUnit", EnergyReporter{local_memory_unit_.getEnergyReporter()});
+    if (fast_forward_ins_cnt_ > 0) {
+        reporter.accumulate(fast_forward_energy_, false);
+    }
     return std::move(reporter);
 }
 
+std::vector<MemoryBankReport> Core::getMemoryBankReports() const {
+    auto memory_bank_reports = local_memory_unit_.getMemoryBankReports();
+    for (auto &memory_bank_report : memory_bank_reports) {
+        memory_bank_report.name = fmt::format("{}.{}", getName(), memory_bank_report.name);
+    }
+    return memory_bank_reports;
+}
+
 bool Core::checkRegValues(const std::array<int, GENERAL_REG_NUM> &general_reg_expected_values,
                           const std::array<int, SPECIAL_REG_NUM> &special_reg_expected_values) {
     return reg_unit_.checkRegValues(general_reg_expected_values, special_reg_expected_values);
@@ -148,23 +184,129 @@ int Core::getCoreId() const {
     return core_id_;
 }
 
-[[noreturn]] void Core::issue() {
-    ScalarInsPayload scalar_nop{};
-    SIMDInsPayload simd_nop{};
-    TransferInsPayload transfer_nop{};
-    PimComputeInsPayload pim_compute_nop{};
-    PimLoadInsPayload pim_load_nop{};
-    PimOutputInsPayload pim_output_nop{};
-    PimSetInsPayload pim_set_nop{};
-    PimTransferInsPayload pim_transfer_nop{};
+PayloadPool &Core::getPayloadPool() {
+    return payload_pool_;
+}
+
+long long Core::getPayloadAllocationCount() const {
+    return payload_pool_.getAllocationCount();
+}
+
+long long Core::fastForward(const FastForwardTarget &target) {
+    // the instructions executed functionally are not simulated, so the statistics, instruction ids and decode counts
+    // are restored afterwards
+    const auto ins_stat = ins_stat_;
+    const int ins_id = ins_id_;
+    const long long decoded_ins_cnt = decoded_ins_cnt_;
+    const auto ins_decode_cnt = ins_decode_cnt_;
+    long long ins_cnt = 0;
+    while (ins_index_ + 1 < ins_list_.size()) {
+        if (target.to_pc ? (ins_index_ + 1 == target.value) : (ins_cnt >= target.value)) {
+            break;
+        }
+        const auto &ins = ins_list_[ins_index_];
+        if ((ins.class_code == InstClass::transfer && ins.type != TransferInstType::trans) ||
+            (ins.class_code == InstClass::control &&
+             (ins.type == ControlInstType::wait || ins.type == ControlInstType::barrier))) {
+            break;
+        }
 
+        int pc_increment = decodeAndGetPCIncrement();
+        executeDecodedInsFunctionally();
+        ins_index_ += pc_increment;
+        ins_cnt++;
+    }
+    cur_ins_conflict_info_ = DataConflictPayload{.ins_id = -1, .unit_type = ExecuteUnitType::none};
+    ins_stat_ = ins_stat;
+    ins_id_ = ins_id;
+    decoded_ins_cnt_ = decoded_ins_cnt;
+    ins_decode_cnt_ = ins_decode_cnt;
+
+    LOG(fmt::format("core {} fast-forward {} instructions to pc {}", core_id_, ins_cnt, ins_index_ + 1));
+    return ins_cnt;
+}
+
+CoreState Core::getState() {
+    CoreState state{.general_regs = reg_unit_.getGeneralRegisters(),
+                    .special_regs = reg_unit_.getSpecialRegisters(),
+                    .local_memory_data = local_memory_unit_.getMemoryDataList()};
+    const auto &pim_config = core_config_.pim_unit_config;
+    for (int group_id = 0; group_id < pim_config.macro_total_cnt / pim_config.macro_group_size; group_id++) {
+        state.macro_group_activation_element_column_cnt.push_back(
+            pim_compute_unit_.getMacroGroupActivationElementColumnCount(group_id));
+        state.macro_group_activation_macro_cnt.push_back(
+            pim_compute_unit_.getMacroGroupActivationMacroCount(group_id));
+    }
+    return state;
+}
+
+void Core::executeDecodedInsFunctionally() {
+    switch (cur_ins_conflict_info_.unit_type) {
+        case ExecuteUnitType::scalar: {
+            const auto &payload = scalar_payload_;
+            if (payload.op == +ScalarOperator::store) {
+                local_memory_unit_.writeDataFunctionally(payload.src1_value + payload.offset,
+                                                         IntToBytes(payload.src2_value, true));
+            } else if (payload.op == +ScalarOperator::load) {
+                auto data =
+                    local_memory_unit_.readDataFunctionally(payload.src1_value + payload.offset, WORD_BYTE_SIZE);
+                int value = data.size() < WORD_BYTE_SIZE ? 0 : BytesToInt(data, true);
+                reg_unit_.writeRegister({.reg_id = payload.dst_reg, .reg_value = value});
+            } else if (payload.op == +ScalarOperator::assign) {
+                RegUnitWriteRequest write_req{.reg_id = payload.dst_reg,
+                                              .reg_value = payload.src1_value,
+                                              .write_special_register = payload.write_special_register};
+                if (int special_bound_general_id = reg_unit_.getSpecialBoundGeneralId(payload.dst_reg);
+                    payload.write_special_register && special_bound_general_id != -1) {
+                    write_req.reg_id = special_bound_general_id;
+                    write_req.write_special_register = false;
+                }
+                reg_unit_.writeRegister(write_req);
+            } else {
+                reg_unit_.writeRegister(
+                    {.reg_id = payload.dst_reg,
+                     .reg_value = ScalarUnit::calculate(payload.op, payload.src1_value, payload.src2_value)});
+            }
+            break;
+        }
+        case ExecuteUnitType::transfer: {
+            // as in the detailed model, no data travels through the global memory
+            const auto &payload = transfer_payload_;
+            if (payload.type == +TransferType::local_trans) {
+                local_memory_unit_.writeDataFunctionally(
+                    payload.dst_address_byte,
+                    local_memory_unit_.readDataFunctionally(payload.src_address_byte, payload.size_byte));
+            }
+            break;
+        }
+        case ExecuteUnitType::pim_set: {
+            const auto &pim_config = core_config_.pim_unit_config;
+            int mask_size_byte = IntDivCeil(
+                pim_config.macro_size.element_cnt_per_compartment * pim_config.macro_group_size, BYTE_TO_BIT);
+            pim_compute_unit_.setMacroGroupActivationElementColumn(
+                local_memory_unit_.readDataFunctionally(pim_set_payload_.mask_addr_byte, mask_size_byte),
+                pim_set_payload_.group_broadcast, pim_set_payload_.group_id);
+            break;
+        }
+        default: {
+            // simd and pim results are not kept as data by the detailed model either
+            break;
+        }
+    }
+}
+
+void Core::issue() {
     wait(period_ns_ - 1, SC_NS);
 
     int pc_increment = 0;
+    ExecuteUnitType issued_unit_type = ExecuteUnitType::none;
     while (true) {
         if (cur_ins_conflict_info_.unit_type == +ExecuteUnitType::none) {
             if (ins_index_ < ins_list_.size()) {
                 pc_increment = decodeAndGetPCIncrement();
+                if (loop_fast_forward_ && ins_list_[ins_index_].class_code == InstClass::control) {
+                    pc_increment = fastForwardLoopAndGetPCIncrement(pc_increment);
+                }
                 decode_new_ins_trigger_.notify();
             } else {
                 pc_increment = 0;
@@ -172,32 +314,105 @@ int Core::getCoreId() const {
         }
         wait(0.1, SC_NS);
 
-        if (!id_stall_.read() && cur_ins_conflict_info_.unit_type != +ExecuteUnitType::none) {
-            scalar_signals_.id_ex_payload_.write(scalar_payload_);
-            simd_signals_.id_ex_payload_.write(simd_payload_);
-            transfer_signals_.id_ex_payload_.write(transfer_payload_);
-            pim_compute_signals_.id_ex_payload_.write(pim_compute_payload_);
-            pim_load_signals_.id_ex_payload_.write(pim_load_payload_);
-            pim_output_signals_.id_ex_payload_.write(pim_output_payload_);
-            pim_set_signals_.id_ex_payload_.write(pim_set_payload_);
-            pim_transfer_signals_.id_ex_payload_.write(pim_transfer_payload_);
+        // only the unit issued to in last cycle needs a nop, the payloads of other units are already nops
+        writeIdExPayload(issued_unit_type, false);
+        issued_unit_type = ExecuteUnitType::none;
+
+        // while stalled, sleep until the stall is released instead of checking every cycle, and go on at the first
+        // issue point after that
+        while (id_stall_.read() && cur_ins_conflict_info_.unit_type != +ExecuteUnitType::none) {
+            auto check_time = sc_core::sc_time_stamp();
+            wait(id_stall_.negedge_event());
+            wait(getNextIssueTime(check_time) - sc_core::sc_time_stamp());
+            stall_time_ += sc_core::sc_time_stamp() - check_time;
+        }
+
+        // a wait instruction stalls until the async transfers it waits for, issued before it, have finished
+        if (wait_async_transfer_) {
+            wait_async_transfer_ = false;
+            auto check_time = sc_core::sc_time_stamp();
+            transfer_unit_.waitAsyncTransfers(wait_async_transfer_key_,
+                                              async_transfer_issue_cnt_[wait_async_transfer_key_]);
+            if (sc_core::sc_time_stamp() != check_time) {
+                wait(getNextIssueTime(check_time) - sc_core::sc_time_stamp());
+                stall_time_ += sc_core::sc_time_stamp() - check_time;
+            }
+        }
+
+        // a barrier instruction stalls until all cores of the barrier have arrived, without a barrier manager, as in
+        // the tests of a single core, it does nothing
+        if (arrive_barrier_) {
+            arrive_barrier_ = false;
+            if (barrier_manager_ != nullptr) {
+                auto check_time = sc_core::sc_time_stamp();
+                barrier_manager_->arrive(core_id_, barrier_id_, barrier_core_cnt_);
+                wait(getNextIssueTime(check_time) - sc_core::sc_time_stamp());
+                stall_time_ += sc_core::sc_time_stamp() - check_time;
+            }
+        }
+
+        if (cur_ins_conflict_info_.unit_type != +ExecuteUnitType::none) {
+            issued_unit_type = cur_ins_conflict_info_.unit_type;
+            writeIdExPayload(issued_unit_type, true);
+            if (issued_unit_type == +ExecuteUnitType::transfer && transfer_payload_.async) {
+                async_transfer_issue_cnt_[transfer_unit_.getAsyncTransferKey(transfer_payload_)]++;
+            }
 
             ins_index_ += pc_increment;
             cur_ins_conflict_info_ = DataConflictPayload{.ins_id = -1, .unit_type = ExecuteUnitType::none};
-        } else {
-            scalar_signals_.id_ex_payload_.write(scalar_nop);
-            simd_signals_.id_ex_payload_.write(simd_nop);
-            transfer_signals_.id_ex_payload_.write(transfer_nop);
-            pim_compute_signals_.id_ex_payload_.write(pim_compute_nop);
-            pim_load_signals_.id_ex_payload_.write(pim_load_nop);
-            pim_output_signals_.id_ex_payload_.write(pim_output_nop);
-            pim_set_signals_.id_ex_payload_.write(pim_set_nop);
-            pim_transfer_signals_.id_ex_payload_.write(pim_transfer_nop);
+        } else if (ins_index_ >= ins_list_.size()) {
+            // all instructions have been issued
+            return;
         }
         wait(period_ns_ - 0.1, SC_NS);
     }
 }
 
+void Core::writeIdExPayload(ExecuteUnitType unit_type, bool valid) {
+    switch (unit_type) {
+        case ExecuteUnitType::scalar: {
+            scalar_signals_.id_ex_payload_.write(valid ? scalar_payload_ : ScalarInsPayload{});
+            break;
+        }
+        case ExecuteUnitType::simd: {
+            simd_signals_.id_ex_payload_.write(valid ? simd_payload_ : SIMDInsPayload{});
+            break;
+        }
+        case ExecuteUnitType::transfer: {
+            transfer_signals_.id_ex_payload_.write(valid ? transfer_payload_ : TransferInsPayload{});
+            break;
+        }
+        case ExecuteUnitType::pim_compute: {
+            pim_compute_signals_.id_ex_payload_.write(valid ? pim_compute_payload_ : PimComputeInsPayload{});
+            break;
+        }
+        case ExecuteUnitType::pim_load: {
+            pim_load_signals_.id_ex_payload_.write(valid ? pim_load_payload_ : PimLoadInsPayload{});
+            break;
+        }
+        case ExecuteUnitType::pim_output: {
+            pim_output_signals_.id_ex_payload_.write(valid ? pim_output_payload_ : PimOutputInsPayload{});
+            break;
+        }
+        case ExecuteUnitType::pim_set: {
+            pim_set_signals_.id_ex_payload_.write(valid ? pim_set_payload_ : PimSetInsPayload{});
+            break;
+        }
+        case ExecuteUnitType::pim_transfer: {
+            pim_transfer_signals_.id_ex_payload_.write(valid ? pim_transfer_payload_ : PimTransferInsPayload{});
+            break;
+        }
+        default: break;
+    }
+}
+
+sc_core::sc_time Core::getNextIssueTime(const sc_core::sc_time &last_issue_time) const {
+    const sc_core::sc_time period{period_ns_, SC_NS};
+    auto elapsed = (sc_core::sc_time_stamp() - last_issue_time).value();
+    auto cycles = std::max<sc_dt::uint64>(1, (elapsed + period.value() - 1) / period.value());
+    return last_issue_time + period * static_cast<double>(cycles);
+}
+
 void Core::processStall() {
     bool stall = scalar_conflict_.read() || simd_conflict_.read() || transfer_conflict_.read() ||
                  pim_compute_conflict_.read() || pim_load_conflict_.read() || pim_output_conflict_.read() ||
@@ -248,6 +463,8 @@ int Core::decodeAndGetPCIncrement() {
     }
 
     ins_stat_.addInsCount(ins.class_code, ins.type, ins.opcode, core_config_);
+    ins_decode_cnt_[ins_index_]++;
+    decoded_ins_cnt_++;
     if (ins.class_code == InstClass::control) {
         return decodeControlInsAndGetPCIncrement(ins, ins_payload);
     }
@@ -437,13 +654,20 @@ void Core::decodeTransferIns(const pimsim::Instruction &ins, const pimsim::Instr
             type = TransferType::global_store;
             dst_address_byte -= global_memory_addressing_.offset_byte;
         }
+        if (type != +TransferType::local_trans) {
+            network_ins_cnt_++;
+        }
+        // only the transfers with the global memory may be async, with the transfer id tag in 'reg_id'
+        bool async = type != +TransferType::local_trans && ins.sync == 1;
 
         transfer_payload_ = TransferInsPayload{
             .ins = {.pc = ins_payload.pc, .ins_id = ins_payload.ins_id, .unit_type = ExecuteUnitType::transfer},
             .type = type,
             .src_address_byte = src_address_byte,
             .dst_address_byte = dst_address_byte,
-            .size_byte = size_byte};
+            .size_byte = size_byte,
+            .transfer_id_tag = async ? reg_unit_.readRegister(ins.reg_id, false) : 0,
+            .async = async};
 
         cur_ins_conflict_info_ =
             DataConflictPayload{.ins_id = transfer_payload_.ins.ins_id, .unit_type = ExecuteUnitType::transfer};
@@ -455,7 +679,14 @@ void Core::decodeTransferIns(const pimsim::Instruction &ins, const pimsim::Instr
         }
         // }
     } else if (ins.type == +TransferInstType::send) {
+        network_ins_cnt_++;
         int src_address_byte = reg_unit_.readRegister(ins.rs1, false);
+        int dst_cnt = ins.multicast == 1 ? reg_unit_.readRegister(ins.rs2, false) : 1;
+        // no receiver would wait for the handshake of a send to no core
+        if (dst_cnt < 1) {
+            throw std::runtime_error(fmt::format("Core {}: multicast send at pc {} to {} cores", core_id_,
+                                                 ins_payload.pc, dst_cnt));
+        }
 
         transfer_payload_ = TransferInsPayload{
             .ins = {.pc = ins_payload.pc, .ins_id = ins_payload.ins_id, .unit_type = ExecuteUnitType::transfer},
@@ -465,11 +696,14 @@ void Core::decodeTransferIns(const pimsim::Instruction &ins, const pimsim::Instr
             .size_byte = reg_unit_.readRegister(ins.reg_len, false),
             .src_id = core_id_,
             .dst_id = reg_unit_.readRegister(ins.rd1, false),
-            .transfer_id_tag = reg_unit_.readRegister(ins.reg_id, false)};
+            .transfer_id_tag = reg_unit_.readRegister(ins.reg_id, false),
+            .async = (ins.sync == 1),
+            .dst_cnt = dst_cnt};
         cur_ins_conflict_info_ =
             DataConflictPayload{.ins_id = transfer_payload_.ins.ins_id, .unit_type = ExecuteUnitType::transfer};
         cur_ins_conflict_info_.addReadMemoryId(local_memory_unit_.getLocalMemoryIdByAddress(src_address_byte));
     } else if (ins.type == +TransferInstType::receive) {
+        network_ins_cnt_++;
         int dst_address_byte = reg_unit_.readRegister(ins.rd, false);
 
         transfer_payload_ = TransferInsPayload{
@@ -480,7 +714,8 @@ void Core::decodeTransferIns(const pimsim::Instruction &ins, const pimsim::Instr
             .size_byte = reg_unit_.readRegister(ins.reg_len, false),
             .src_id = reg_unit_.readRegister(ins.rs1, false),
             .dst_id = core_id_,
-            .transfer_id_tag = reg_unit_.readRegister(ins.reg_id, false)};
+            .transfer_id_tag = reg_unit_.readRegister(ins.reg_id, false),
+            .async = (ins.sync == 1)};
         cur_ins_conflict_info_ =
             DataConflictPayload{.ins_id = transfer_payload_.ins.ins_id, .unit_type = ExecuteUnitType::transfer};
         cur_ins_conflict_info_.addWriteMemoryId(local_memory_unit_.getLocalMemoryIdByAddress(dst_address_byte));
@@ -593,6 +828,18 @@ int Core::decodeControlInsAndGetPCIncrement(const pimsim::Instruction &ins, cons
     if (ins.type == ControlInstType::jmp) {
         return ins.offset;
     }
+    if (ins.type == ControlInstType::wait) {
+        wait_async_transfer_ = true;
+        wait_async_transfer_key_ = {reg_unit_.readRegister(ins.rs1, false), reg_unit_.readRegister(ins.rs2, false)};
+        return 1;
+    }
+    if (ins.type == ControlInstType::barrier) {
+        network_ins_cnt_++;
+        arrive_barrier_ = true;
+        barrier_id_ = reg_unit_.readRegister(ins.rs1, false);
+        barrier_core_cnt_ = reg_unit_.readRegister(ins.rs2, false);
+        return 1;
+    }
 
     int src_value1 = reg_unit_.readRegister(ins.rs1, false);
     int src_value2 = reg_unit_.readRegister(ins.rs2, false);
@@ -610,4 +857,190 @@ int Core::decodeControlInsAndGetPCIncrement(const pimsim::Instruction &ins, cons
     }
 }
 
+bool LoopIterationDelta::operator==(const LoopIterationDelta &another) const {
+    return duration == another.duration && stall_time == another.stall_time && ins_cnt == another.ins_cnt &&
+           body_ins_cnt == another.body_ins_cnt && general_regs == another.general_regs &&
+           special_regs == another.special_regs && src_value1 == another.src_value1 &&
+           src_value2 == another.src_value2;
+}
+
+// Called when a conditional branch is decoded. A taken backward branch ends an iteration of the loop from its target
+// to itself. Once two consecutive iterations show the same delta of time, stall time, executed instructions and
+// registers, the loop is taken as steady and the remaining iterations are skipped: time is advanced by their duration,
+// registers, local memories and instruction statistics are updated by executing them functionally, and their energy is
+// extrapolated from the steady iterations.
+int Core::fastForwardLoopAndGetPCIncrement(int pc_increment) {
+    const auto &ins = ins_list_[ins_index_];
+    if (ins.type == +ControlInstType::jmp || ins.type == +ControlInstType::wait ||
+        ins.type == +ControlInstType::barrier) {
+        return pc_increment;
+    }
+    if (pc_increment > 0) {
+        // loop exits, or a forward branch
+        loop_state_map_.erase(ins_index_);
+        return pc_increment;
+    }
+
+    int head_index = ins_index_ + pc_increment;
+    auto &loop = loop_state_map_[ins_index_];
+    if (loop.head_index != head_index) {
+        loop = LoopFastForwardState{.head_index = head_index};
+    }
+
+    auto record = getLoopIterationRecord(head_index);
+    if (!loop.has_last_record) {
+        loop.has_last_record = true;
+        loop.last_record = std::move(record);
+        return pc_increment;
+    }
+
+    const auto &last = loop.last_record;
+    LoopIterationDelta delta{.duration = record.time - last.time,
+                             .stall_time = record.stall_time - last.stall_time,
+                             .ins_cnt = record.decoded_ins_cnt - last.decoded_ins_cnt,
+                             .src_value1 = record.src_value1 - last.src_value1,
+                             .src_value2 = record.src_value2 - last.src_value2};
+    long long body_ins_cnt = 0;
+    for (int i = 0; i < record.body_ins_cnt.size(); i++) {
+        delta.body_ins_cnt.push_back(record.body_ins_cnt[i] - last.body_ins_cnt[i]);
+        body_ins_cnt += delta.body_ins_cnt.back();
+    }
+    for (int i = 0; i < GENERAL_REG_NUM; i++) {
+        delta.general_regs[i] = record.general_regs[i] - last.general_regs[i];
+    }
+    for (int i = 0; i < SPECIAL_REG_NUM; i++) {
+        delta.special_regs[i] = record.special_regs[i] - last.special_regs[i];
+    }
+
+    // instructions out of the loop body or accesses to the network make the iterations depend on more than the core
+    bool valid = (body_ins_cnt == delta.ins_cnt) && (record.network_ins_cnt == last.network_ins_cnt);
+    if (valid && loop.has_last_delta && delta == loop.last_delta) {
+        loop.steady_iteration_cnt++;
+    } else {
+        loop.steady_iteration_cnt = 0;
+    }
+    loop.has_last_delta = valid;
+    loop.last_delta = std::move(delta);
+    loop.last_record = std::move(record);
+
+    if (loop.steady_iteration_cnt == 1) {
+        // static energy follows the running time and is not taken from the difference
+        EnergyCounter::setRunningTimeNS(sc_core::sc_time_stamp());
+        loop.steady_energy = getEnergyReporter();
+    } else if (loop.steady_iteration_cnt >= 2) {
+        if (int iteration_cnt = getLoopRemainingIterationCount(loop.last_delta); iteration_cnt >= 2) {
+            pc_increment = skipLoopIterationsAndGetPCIncrement(loop, loop.last_delta, iteration_cnt);
+            loop_state_map_.erase(ins_index_);
+            return pc_increment;
+        }
+    }
+    return pc_increment;
+}
+
+LoopIterationRecord Core::getLoopIterationRecord(int head_index) {
+    const auto &ins = ins_list_[ins_index_];
+    return LoopIterationRecord{
+        .time = sc_core::sc_time_stamp(),
+        .stall_time = stall_time_,
+        .decoded_ins_cnt = decoded_ins_cnt_,
+        .network_ins_cnt = network_ins_cnt_,
+        .body_ins_cnt = {ins_decode_cnt_.begin() + head_index, ins_decode_cnt_.begin() + ins_index_ + 1},
+        .general_regs = reg_unit_.getGeneralRegisters(),
+        .special_regs = reg_unit_.getSpecialRegisters(),
+        .src_value1 = reg_unit_.readRegister(ins.rs1, false),
+        .src_value2 = reg_unit_.readRegister(ins.rs2, false)};
+}
+
+// the number of iterations the loop still runs, with branch operands changing by the delta each iteration. returns 0
+// if the loop does not end in a known number of iterations
+int Core::getLoopRemainingIterationCount(const LoopIterationDelta &delta) const {
+    const auto &ins = ins_list_[ins_index_];
+    // the branch is taken on 'diff' now, and on 'diff + i * step' after i more iterations
+    long long diff = static_cast<long long>(reg_unit_.getGeneralRegisters()[ins.rs1]) -
+                     static_cast<long long>(reg_unit_.getGeneralRegisters()[ins.rs2]);
+    long long step = static_cast<long long>(delta.src_value1) - static_cast<long long>(delta.src_value2);
+
+    long long iteration_cnt = 0;
+    if (ins.type == +ControlInstType::beq) {
+        iteration_cnt = (step == 0) ? 0 : 1;
+    } else if (ins.type == +ControlInstType::bne) {
+        iteration_cnt = (step != 0 && diff % step == 0 && -diff / step >= 1) ? -diff / step : 0;
+    } else if (ins.type == +ControlInstType::bgt) {
+        iteration_cnt = (step < 0) ? (diff - step - 1) / -step : 0;
+    } else if (ins.type == +ControlInstType::blt) {
+        iteration_cnt = (step > 0) ? (-diff + step - 1) / step : 0;
+    }
+    return iteration_cnt > std::numeric_limits<int>::max() ? 0 : static_cast<int>(iteration_cnt);
+}
+
+// returns the pc increment of the branch after the skipped iterations, which is 1 unless the loop did not end within
+// the expected iteration count
+int Core::skipLoopIterationsAndGetPCIncrement(LoopFastForwardState &loop, const LoopIterationDelta &delta,
+                                              int iteration_cnt) {
+    auto energy = getEnergyReporter();
+
+    // the issue stage clears the payload issued in the last cycle only after the decode, so it is cleared here, or the
+    // unit would execute it again in every cycle of the skip
+    for (auto unit_type : {ExecuteUnitType::scalar, ExecuteUnitType::simd, ExecuteUnitType::transfer,
+                           ExecuteUnitType::pim_compute, ExecuteUnitType::pim_load, ExecuteUnitType::pim_output,
+                           ExecuteUnitType::pim_set, ExecuteUnitType::pim_transfer}) {
+        writeIdExPayload(unit_type, false);
+    }
+
+    // let the last detailed iteration finish, so that the registers and local memories are written and no unit is busy
+    const sc_core::sc_time period{period_ns_, SC_NS};
+    auto start_time = sc_core::sc_time_stamp();
+    while (hasInsInFlight()) {
+        wait(scalar_stall_handler_.getDrainEvent() | simd_stall_handler_.getDrainEvent() |
+             transfer_stall_handler_.getDrainEvent() | pim_compute_stall_handler_.getDrainEvent() |
+             pim_load_stall_handler_.getDrainEvent() | pim_output_stall_handler_.getDrainEvent() |
+             pim_set_stall_handler_.getDrainEvent() | pim_transfer_stall_handler_.getDrainEvent());
+    }
+    wait(period);
+
+    // the skipped iterations run functionally from the loop head, which writes their registers and local memories and
+    // counts their instructions, and ends at the branch, decoded again as the last iteration leaves it
+    const int branch_index = ins_index_;
+    const long long start_decoded_ins_cnt = decoded_ins_cnt_;
+    int skipped_iteration_cnt = 0;
+    int pc_increment = 1;
+    ins_index_ = loop.head_index;
+    while (true) {
+        pc_increment = decodeAndGetPCIncrement();
+        executeDecodedInsFunctionally();
+        if (ins_index_ == branch_index && (++skipped_iteration_cnt == iteration_cnt || pc_increment > 0)) {
+            break;
+        }
+        ins_index_ += pc_increment;
+    }
+
+    // the skip ends at an issue point on the cycle grid of the branch, the drain ends at any time and may take longer
+    // than the skipped iterations
+    auto skip_end_time = std::max(start_time + delta.duration * static_cast<double>(skipped_iteration_cnt),
+                                  sc_core::sc_time_stamp());
+    auto skip_cycle_cnt = ((skip_end_time - start_time).value() + period.value() - 1) / period.value();
+    if (auto issue_time = start_time + period * static_cast<double>(skip_cycle_cnt);
+        issue_time > sc_core::sc_time_stamp()) {
+        wait(issue_time - sc_core::sc_time_stamp());
+    }
+    long long ins_cnt = decoded_ins_cnt_ - start_decoded_ins_cnt;
+    stall_time_ += delta.stall_time * static_cast<double>(skipped_iteration_cnt);
+    fast_forward_ins_cnt_ += ins_cnt;
+
+    // the steady energy was taken 'steady_iteration_cnt - 1' iterations ago
+    fast_forward_energy_.addDynamicDifference(
+        loop.steady_energy, energy, static_cast<double>(skipped_iteration_cnt) / (loop.steady_iteration_cnt - 1));
+
+    LOG(fmt::format("core {} fast-forward loop [{}, {}] for {} iterations, {} instructions", core_id_,
+                    loop.head_index + 1, ins_index_ + 1, skipped_iteration_cnt, ins_cnt));
+    return pc_increment;
+}
+
+bool Core::hasInsInFlight() const {
+    return scalar_stall_handler_.hasInsInFlight() || simd_stall_handler_.hasInsInFlight() ||
+           transfer_stall_handler_.hasInsInFlight() || pim_compute_stall_handler_.hasInsInFlight() ||
+           pim_load_stall_handler_.hasInsInFlight() || pim_output_stall_handler_.hasInsInFlight() ||
+           pim_set_stall_handler_.hasInsInFlight() || pim_transfer_stall_handler_.hasInsInFlight();
+}
+
 }  // namespace pimsim
@@ -3,10 +3,15 @@
 //
 
 #pragma once
+#include <array>
 #include <iostream>
+#include <map>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "base_component/base_module.h"
+#include "base_component/payload_pool.h"
 #include "base_component/stall_handler.h"
 #include "core/payload/execute_unit_payload.h"
 #include "core/pim_unit/pim_compute_unit.h"
@@ -25,6 +30,63 @@
 
 namespace pimsim {
 
+class BarrierManager;
+
+// where functional fast-forwarding stops, see Core::fastForward
+struct FastForwardTarget {
+    bool to_pc{false};
+    long long value{0};  // pc as in InstructionPayload, or number of executed instructions
+
+    DECLARE_TYPE_FROM_TO_JSON_FUNCTION_INTRUSIVE(FastForwardTarget);
+};
+
+// what a core computed, a fast-forwarded run must end in the same state as a detailed one
+struct CoreState {
+    std::array<int, GENERAL_REG_NUM> general_regs{};
+    std::array<int, SPECIAL_REG_NUM> special_regs{};
+    std::vector<std::vector<uint8_t>> local_memory_data{};  // by memory id, empty unless the data mode is real data
+    std::vector<int> macro_group_activation_element_column_cnt{};
+    std::vector<int> macro_group_activation_macro_cnt{};
+
+    DECLARE_TYPE_FROM_TO_JSON_FUNCTION_INTRUSIVE(CoreState);
+    bool operator==(const CoreState& another) const;
+};
+
+// state of the core when a loop jumps back to its head, only differences between iterations are used
+struct LoopIterationRecord {
+    sc_core::sc_time time{sc_core::SC_ZERO_TIME};
+    sc_core::sc_time stall_time{sc_core::SC_ZERO_TIME};
+    long long decoded_ins_cnt{0};
+    long long network_ins_cnt{0};
+    std::vector<long long> body_ins_cnt{};  // decode count of each instruction in the loop body
+    std::array<int, GENERAL_REG_NUM> general_regs{};
+    std::array<int, SPECIAL_REG_NUM> special_regs{};
+    int src_value1{0}, src_value2{0};  // operands of the branch
+};
+
+struct LoopIterationDelta {
+    sc_core::sc_time duration{sc_core::SC_ZERO_TIME};
+    sc_core::sc_time stall_time{sc_core::SC_ZERO_TIME};
+    long long ins_cnt{0};
+    std::vector<long long> body_ins_cnt{};
+    std::array<int, GENERAL_REG_NUM> general_regs{};
+    std::array<int, SPECIAL_REG_NUM> special_regs{};
+    int src_value1{0}, src_value2{0};
+
+    bool operator==(const LoopIterationDelta& another) const;
+};
+
+struct LoopFastForwardState {
+    int head_index{0};
+    bool has_last_record{false};
+    LoopIterationRecord last_record{};
+    bool has_last_delta{false};
+    LoopIterationDelta last_delta{};
+    // consecutive iterations with the same delta, the energy of the loop is taken from the first of them on
+    int steady_iteration_cnt{0};
+    EnergyReporter steady_energy{};
+};
+
 class Core : public BaseModule {
 public:
     SC_HAS_PROCESS(Core);
@@ -32,8 +94,11 @@ public:
     Core(int core_id, const char* name, const Config& config, Clock* clk, std::vector<Instruction> ins_list,
          std::function<void()> finish_run_call, bool check = false, std::ostream& reg_stat_os = std::cout);
     void bindNetwork(Network* network);
+    void bindBarrierManager(BarrierManager* barrier_manager);
 
     EnergyReporter getEnergyReporter() override;
+    // of the banked local memories, named after the core
+    std::vector<MemoryBankReport> getMemoryBankReports() const;
 
     bool checkRegValues(const std::array<int, GENERAL_REG_NUM>& general_reg_expected_values,
                         const std::array<int, SPECIAL_REG_NUM>& special_reg_expected_values);
@@ -42,8 +107,22 @@ public:
 
     [[nodiscard]] int getCoreId() const;
 
+    // the pool of memory access payloads and network messages made by the units of this core
+    PayloadPool& getPayloadPool();
+    [[nodiscard]] long long getPayloadAllocationCount() const;
+
+    // executes instructions functionally against the registers and local memories, without timing, energy or
+    // instruction statistics, until the target is reached. called before the simulation starts, which then goes on
+    // from there in detail. stops early before instructions that synchronize with other cores and before the last
+    // instruction, which finishes the run. returns the number of executed instructions
+    long long fastForward(const FastForwardTarget& target);
+
+    CoreState getState();
+
 private:
-    [[noreturn]] void issue();
+    void issue();
+    void writeIdExPayload(ExecuteUnitType unit_type, bool valid);
+    sc_core::sc_time getNextIssueTime(const sc_core::sc_time& last_issue_time) const;
     void processStall();
     void processIdExEnable();
     void processFinishRun();
@@ -58,6 +137,16 @@ private:
     void decodePimTransferIns(const Instruction& ins, const InstructionPayload& ins_payload);
     int decodeControlInsAndGetPCIncrement(const Instruction& ins, const InstructionPayload& ins_payload);
 
+    void executeDecodedInsFunctionally();
+
+    // loop fast-forwarding
+    int fastForwardLoopAndGetPCIncrement(int pc_increment);
+    LoopIterationRecord getLoopIterationRecord(int head_index);
+    [[nodiscard]] int getLoopRemainingIterationCount(const LoopIterationDelta& delta) const;
+    int skipLoopIterationsAndGetPCIncrement(LoopFastForwardState& loop, const LoopIterationDelta& delta,
+                                            int iteration_cnt);
+    [[nodiscard]] bool hasInsInFlight() const;
+
 private:
     const int core_id_;
     const CoreConfig& core_config_;
@@ -74,6 +163,27 @@ private:
     DataConflictPayload cur_ins_conflict_info_;
     sc_core::sc_event decode_new_ins_trigger_;
 
+    // async transfers, by the key of TransferUnit::getAsyncTransferKey
+    std::map<std::pair<int, int>, long long> async_transfer_issue_cnt_;
+    bool wait_async_transfer_{false};
+    std::pair<int, int> wait_async_transfer_key_{};
+
+    // barrier
+    BarrierManager* barrier_manager_{nullptr};
+    bool arrive_barrier_{false};
+    int barrier_id_{0};
+    int barrier_core_cnt_{0};
+
+    // loop fast-forwarding
+    const bool loop_fast_forward_;
+    sc_core::sc_time stall_time_{sc_core::SC_ZERO_TIME};
+    long long decoded_ins_cnt_{0};
+    long long network_ins_cnt_{0};
+    std::vector<long long> ins_decode_cnt_;
+    std::unordered_map<int, LoopFastForwardState> loop_state_map_;  // by index of the backward branch
+    EnergyReporter fast_forward_energy_;
+    long long fast_forward_ins_cnt_{0};
+
     // payloads to execute units
     ScalarInsPayload scalar_payload_;
     SIMDInsPayload simd_payload_;
@@ -84,6 +194,8 @@ private:
     PimSetInsPayload pim_set_payload_;
     PimTransferInsPayload pim_transfer_payload_;
 
+    PayloadPool payload_pool_;
+
     // modules
     // execute units
     ScalarUnit scalar_unit_;
@@ -0,0 +1,88 @@
+//
+// Created by wyk on 2024/11/13.
+//
+
+#include "address_decoder.h"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+#include "fmt/format.h"
+
+namespace pimsim {
+
+AddressDecoder::AddressDecoder(const std::vector<AddressSpaceConfig>& address_spaces) {
+    if (auto [first, second] = findOverlap(address_spaces); first != -1) {
+        throw std::runtime_error(fmt::format("address space {} [{}, {}) overlaps address space {} [{}, {})", first,
+                                             address_spaces[first].offset_byte, address_spaces[first].end(), second,
+                                             address_spaces[second].offset_byte, address_spaces[second].end()));
+    }
+
+    int min_size_byte = 0;
+    for (int i = 0; i < address_spaces.size(); i++) {
+        const auto& address_space = address_spaces[i];
+        if (address_space.size_byte <= 0) {
+            continue;
+        }
+        intervals_.push_back({.begin = address_space.offset_byte, .end = address_space.end(), .index = i});
+        min_size_byte =
+            (min_size_byte == 0) ? address_space.size_byte : std::min(min_size_byte, address_space.size_byte);
+    }
+    if (intervals_.empty()) {
+        return;
+    }
+    std::sort(intervals_.begin(), intervals_.end(),
+              [](const Interval& a, const Interval& b) { return a.begin < b.begin; });
+    begin_ = intervals_.front().begin;
+    end_ = intervals_.back().end;
+
+    // the largest page no larger than the smallest address space, unless the table would get too large
+    while ((2LL << page_shift_) <= min_size_byte) {
+        page_shift_++;
+    }
+    while (((end_ - begin_ - 1) >> page_shift_) + 1 > MAX_PAGE_CNT) {
+        page_shift_++;
+    }
+
+    int page_cnt = ((end_ - begin_ - 1) >> page_shift_) + 1;
+    page_table_.resize(page_cnt);
+    for (int page = 0, i = 0; page < page_cnt; page++) {
+        int page_begin = begin_ + (page << page_shift_);
+        while (intervals_[i].end <= page_begin) {
+            i++;
+        }
+        page_table_[page] = i;
+    }
+}
+
+int AddressDecoder::getIndex(int address_byte) const {
+    if (address_byte < begin_ || address_byte >= end_) {
+        return -1;
+    }
+    for (int i = page_table_[(address_byte - begin_) >> page_shift_];
+         i < intervals_.size() && intervals_[i].begin <= address_byte; i++) {
+        if (address_byte < intervals_[i].end) {
+            return intervals_[i].index;
+        }
+    }
+    return -1;
+}
+
+std::pair<int, int> AddressDecoder::findOverlap(const std::vector<AddressSpaceConfig>& address_spaces) {
+    std::vector<int> order(address_spaces.size());
+    std::iota(order.begin(), order.end(), 0);
+    order.erase(std::remove_if(order.begin(), order.end(), [&](int i) { return address_spaces[i].size_byte <= 0; }),
+                order.end());
+    std::sort(order.begin(), order.end(),
+              [&](int a, int b) { return address_spaces[a].offset_byte < address_spaces[b].offset_byte; });
+
+    for (int k = 1; k < order.size(); k++) {
+        if (address_spaces[order[k]].offset_byte < address_spaces[order[k - 1]].end()) {
+            return {order[k - 1], order[k]};
+        }
+    }
+    return {-1, -1};
+}
+
+}  // namespace pimsim
@@ -0,0 +1,45 @@
+//
+// Created by wyk on 2024/11/13.
+//
+
+#pragma once
+#include <utility>
+#include <vector>
+
+#include "config/config.h"
+
+namespace pimsim {
+
+// Maps addresses to the index of the address space holding them in constant time. The address spaces are kept sorted
+// by address, and a table indexed by page gives the first address space that does not end before the page. Pages are
+// no larger than the smallest address space as long as the table stays small, so a lookup checks at most two of them.
+class AddressDecoder {
+public:
+    AddressDecoder() = default;
+
+    // throws if two address spaces overlap
+    explicit AddressDecoder(const std::vector<AddressSpaceConfig>& address_spaces);
+
+    // the index in the given address spaces, -1 if the address is in none of them
+    [[nodiscard]] int getIndex(int address_byte) const;
+
+    // the indexes of two overlapping address spaces, {-1, -1} if none overlap
+    static std::pair<int, int> findOverlap(const std::vector<AddressSpaceConfig>& address_spaces);
+
+private:
+    struct Interval {
+        int begin;
+        int end;
+        int index;
+    };
+
+    static constexpr int MAX_PAGE_CNT = 1 << 16;
+
+    std::vector<Interval> intervals_;  // sorted by address
+    int begin_{0};
+    int end_{0};
+    int page_shift_{0};
+    std::vector<int> page_table_;  // index in 'intervals_' by page
+};
+
+}  // namespace pimsim
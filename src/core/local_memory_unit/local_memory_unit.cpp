@@ -4,6 +4,8 @@
 
 #include "local_memory_unit.h"
 
+#include <stdexcept>
+
 #include "core/core.h"
 #include "fmt/core.h"
 #include "util/util.h"
@@ -14,6 +16,16 @@ LocalMemoryUnit::LocalMemoryUnit(const char *name, const pimsim::LocalMemoryUnit
                                  const pimsim::SimConfig &sim_config, const PimUnitConfig &pim_config,
                                  pimsim::Core *core, pimsim::Clock *clk)
     : BaseModule(name, sim_config, core, clk), config_(config), pim_config_(pim_config) {
+    std::vector<AddressSpaceConfig> address_spaces;
+    for (const auto &local_memory_config : config_.local_memory_list) {
+        address_spaces.push_back(local_memory_config.addressing);
+    }
+    try {
+        address_decoder_ = AddressDecoder{address_spaces};
+    } catch (const std::runtime_error &e) {
+        throw std::runtime_error(fmt::format("LocalMemoryUnit: invalid local memory addressing, {}", e.what()));
+    }
+
     for (const auto &local_memory_config : config_.local_memory_list) {
         if (local_memory_config.type == +LocalMemoryType::ram)
             local_memory_list_.emplace_back(
@@ -29,6 +41,20 @@ LocalMemoryUnit::LocalMemoryUnit(const char *name, const pimsim::LocalMemoryUnit
 
 std::vector<uint8_t> LocalMemoryUnit::read_data(const pimsim::InstructionPayload &ins, int address_byte, int size_byte,
                                                 sc_core::sc_event &finish_access) {
+    auto data = read_view(ins, address_byte, size_byte, finish_access);
+    if (data.empty()) {
+        return {};
+    }
+    return {data.data, data.data + data.size_byte};
+}
+
+void LocalMemoryUnit::write_data(const pimsim::InstructionPayload &ins, int address_byte, int size_byte,
+                                 std::vector<uint8_t> data, sc_core::sc_event &finish_access) {
+    write_view(ins, address_byte, size_byte, {data.data(), static_cast<int>(data.size())}, finish_access);
+}
+
+DataView LocalMemoryUnit::read_view(const pimsim::InstructionPayload &ins, int address_byte, int size_byte,
+                                    sc_core::sc_event &finish_access) {
     auto local_memory = getLocalMemoryByAddress(address_byte);
     if (local_memory == nullptr) {
         std::cerr << fmt::format("Core id: {}, Invalid memory read with ins NO.'{}': address {} does not match any "
@@ -38,7 +64,7 @@ std::vector<uint8_t> LocalMemoryUnit::read_data(const pimsim::InstructionPayload
         return {};
     }
 
-    auto payload = std::make_shared<MemoryAccessPayload>(
+    auto payload = core_->getPayloadPool().make(
         MemoryAccessPayload{.ins = ins,
                             .access_type = MemoryAccessType::read,
                             .address_byte = address_byte - local_memory->getAddressSpaceBegin(),
@@ -47,11 +73,11 @@ std::vector<uint8_t> LocalMemoryUnit::read_data(const pimsim::InstructionPayload
     local_memory->access(payload);
     wait(payload->finish_access);
 
-    return std::move(payload->data);
+    return payload->data;
 }
 
-void LocalMemoryUnit::write_data(const pimsim::InstructionPayload &ins, int address_byte, int size_byte,
-                                 std::vector<uint8_t> data, sc_core::sc_event &finish_access) {
+void LocalMemoryUnit::write_view(const pimsim::InstructionPayload &ins, int address_byte, int size_byte,
+                                 DataView data, sc_core::sc_event &finish_access) {
     if (address_byte >= pim_config_.address_space.offset_byte &&
         address_byte + size_byte < pim_config_.address_space.end()) {
         // calculate config
@@ -63,10 +89,10 @@ void LocalMemoryUnit::write_data(const pimsim::InstructionPayload &ins, int addr
         int process_times = IntDivCeil(weight_bit_size, pim_bit_width);
 
         // load weight
-        double dynamic_power_mW = pim_config_.sram.write_dynamic_power_per_bit_mW * pim_bit_width;
         double latency = pim_config_.sram.write_latency_cycle * period_ns_ * process_times;
 
-        pim_load_energy_counter_.addDynamicEnergyPJ(latency, dynamic_power_mW);
+        pim_load_energy_counter_.addDynamicEnergyPJ(latency, pim_config_.sram.write_dynamic_power_per_bit_mW,
+                                                    pim_bit_width);
         wait(latency);
     } else {
         auto local_memory = getLocalMemoryByAddress(address_byte);
@@ -79,18 +105,56 @@ void LocalMemoryUnit::write_data(const pimsim::InstructionPayload &ins, int addr
             return;
         }
 
-        auto payload = std::make_shared<MemoryAccessPayload>(
+        auto payload = core_->getPayloadPool().make(
             MemoryAccessPayload{.ins = ins,
                                 .access_type = MemoryAccessType::write,
                                 .address_byte = address_byte - local_memory->getAddressSpaceBegin(),
                                 .size_byte = size_byte,
-                                .data = std::move(data),
+                                .data = data,
                                 .finish_access = finish_access});
         local_memory->access(payload);
         wait(payload->finish_access);
     }
 }
 
+std::vector<uint8_t> LocalMemoryUnit::readDataFunctionally(int address_byte, int size_byte) {
+    auto local_memory = getLocalMemoryByAddress(address_byte);
+    if (local_memory == nullptr) {
+        std::cerr << fmt::format("Core id: {}, Invalid functional memory read: address {} does not match any local "
+                                 "memory's address space",
+                                 core_->getCoreId(), address_byte)
+                  << std::endl;
+        return {};
+    }
+    return local_memory->readDataFunctionally(address_byte - local_memory->getAddressSpaceBegin(), size_byte);
+}
+
+void LocalMemoryUnit::writeDataFunctionally(int address_byte, const std::vector<uint8_t> &data) {
+    if (address_byte >= pim_config_.address_space.offset_byte &&
+        address_byte + static_cast<int>(data.size()) <= pim_config_.address_space.end()) {
+        // weights loaded into the macros are not kept
+        return;
+    }
+
+    auto local_memory = getLocalMemoryByAddress(address_byte);
+    if (local_memory == nullptr) {
+        std::cerr << fmt::format("Core id: {}, Invalid functional memory write: address {} does not match any local "
+                                 "memory's address space",
+                                 core_->getCoreId(), address_byte)
+                  << std::endl;
+        return;
+    }
+    local_memory->writeDataFunctionally(address_byte - local_memory->getAddressSpaceBegin(), data);
+}
+
+std::vector<std::vector<uint8_t>> LocalMemoryUnit::getMemoryDataList() {
+    std::vector<std::vector<uint8_t>> memory_data_list;
+    for (auto &local_memory : local_memory_list_) {
+        memory_data_list.emplace_back(local_memory->readDataFunctionally(0, local_memory->getMemorySizeByte()));
+    }
+    return memory_data_list;
+}
+
 EnergyReporter LocalMemoryUnit::getEnergyReporter() {
     EnergyReporter local_memory_unit_reporter;
     for (auto &local_memory : local_memory_list_) {
@@ -99,14 +163,18 @@ EnergyReporter LocalMemoryUnit::getEnergyReporter() {
     return std::move(local_memory_unit_reporter);
 }
 
-int LocalMemoryUnit::getLocalMemoryIdByAddress(int address_byte) const {
-    for (int i = 0; i < local_memory_list_.size(); i++) {
-        auto &local_memory = local_memory_list_[i];
-        if (local_memory->getAddressSpaceBegin() <= address_byte && address_byte < local_memory->getAddressSpaceEnd()) {
-            return i;
+std::vector<MemoryBankReport> LocalMemoryUnit::getMemoryBankReports() const {
+    std::vector<MemoryBankReport> memory_bank_reports;
+    for (const auto &local_memory : local_memory_list_) {
+        if (local_memory->isBanked()) {
+            memory_bank_reports.push_back(local_memory->getBankReport());
         }
     }
-    return -1;
+    return memory_bank_reports;
+}
+
+int LocalMemoryUnit::getLocalMemoryIdByAddress(int address_byte) const {
+    return address_decoder_.getIndex(address_byte);
 }
 
 int LocalMemoryUnit::getMemoryDataWidthById(int memory_id, MemoryAccessType access_type) const {
@@ -118,12 +186,8 @@ int LocalMemoryUnit::getMemorySizeById(int memory_id) const {
 }
 
 std::shared_ptr<Memory> LocalMemoryUnit::getLocalMemoryByAddress(int address_byte) {
-    for (auto &local_memory : local_memory_list_) {
-        if (local_memory->getAddressSpaceBegin() <= address_byte && address_byte < local_memory->getAddressSpaceEnd()) {
-            return local_memory;
-        }
-    }
-    return nullptr;
+    int memory_id = address_decoder_.getIndex(address_byte);
+    return memory_id == -1 ? nullptr : local_memory_list_[memory_id];
 }
 
 }  // namespace pimsim
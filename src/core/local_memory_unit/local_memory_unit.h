@@ -6,6 +6,7 @@
 #include <cstdint>
 #include <vector>
 
+#include "address_decoder.h"
 #include "base_component/base_module.h"
 #include "core/payload/payload.h"
 #include "memory/memory.h"
@@ -25,7 +26,22 @@ public:
     void write_data(const InstructionPayload& ins, int address_byte, int size_byte, std::vector<uint8_t> data,
                     sc_core::sc_event& finish_access);
 
+    // accesses without copying the data, the read view borrows the memory, see DataView
+    DataView read_view(const InstructionPayload& ins, int address_byte, int size_byte,
+                       sc_core::sc_event& finish_access);
+
+    void write_view(const InstructionPayload& ins, int address_byte, int size_byte, DataView data,
+                    sc_core::sc_event& finish_access);
+
+    // untimed accesses for functional fast-forwarding, see Core::fastForward
+    std::vector<uint8_t> readDataFunctionally(int address_byte, int size_byte);
+    void writeDataFunctionally(int address_byte, const std::vector<uint8_t>& data);
+    // the whole data of each local memory, by memory id
+    std::vector<std::vector<uint8_t>> getMemoryDataList();
+
     EnergyReporter getEnergyReporter() override;
+    // of the banked local memories only
+    std::vector<MemoryBankReport> getMemoryBankReports() const;
 
     int getLocalMemoryIdByAddress(int address_byte) const;
 
@@ -41,6 +57,7 @@ private:
     const PimUnitConfig& pim_config_;
 
     std::vector<std::shared_ptr<Memory>> local_memory_list_;
+    AddressDecoder address_decoder_;  // to the index in 'local_memory_list_'
 
     EnergyCounter pim_load_energy_counter_;
 };
@@ -35,6 +35,20 @@ std::stringstream& operator<<(std::stringstream& out, const std::unordered_set<i
     return out;
 }
 
+std::stringstream& operator<<(std::stringstream& out, const MemoryIdMask& mask) {
+    bool first = true;
+    for (int memory_id = -1; memory_id < LOCAL_MEMORY_MAX_CNT; memory_id++) {
+        if (mask.contains(memory_id)) {
+            if (!first) {
+                out << ", ";
+            }
+            out << memory_id;
+            first = false;
+        }
+    }
+    return out;
+}
+
 std::stringstream& operator<<(std::stringstream& out, const std::vector<int>& list) {
     for (auto it = list.begin(); it != list.end(); ++it) {
         if (it != list.begin()) {
@@ -56,33 +70,34 @@ std::stringstream& operator<<(std::stringstream& out, const std::unordered_map<i
 }
 
 void DataConflictPayload::addReadMemoryId(int memory_id) {
-    read_memory_id.insert(memory_id);
-    used_memory_id.insert(memory_id);
+    read_memory_id.add(memory_id);
+    used_memory_id.add(memory_id);
 }
 
 void DataConflictPayload::addReadMemoryId(const std::initializer_list<int>& memory_id_list) {
-    read_memory_id.insert(memory_id_list);
-    used_memory_id.insert(memory_id_list);
+    for (int memory_id : memory_id_list) {
+        addReadMemoryId(memory_id);
+    }
 }
 
 void DataConflictPayload::addWriteMemoryId(int memory_id) {
-    write_memory_id.insert(memory_id);
-    used_memory_id.insert(memory_id);
+    write_memory_id.add(memory_id);
+    used_memory_id.add(memory_id);
 }
 
 void DataConflictPayload::addReadWriteMemoryId(int memory_id) {
-    read_memory_id.insert(memory_id);
-    write_memory_id.insert(memory_id);
-    used_memory_id.insert(memory_id);
+    read_memory_id.add(memory_id);
+    write_memory_id.add(memory_id);
+    used_memory_id.add(memory_id);
 }
 
 bool DataConflictPayload::checkMemoryConflict(const pimsim::DataConflictPayload& ins_conflict_payload,
                                               const pimsim::DataConflictPayload& unit_conflict_payload,
                                               bool has_unit_conflict) {
     if (has_unit_conflict) {
-        return SetsIntersection(unit_conflict_payload.write_memory_id, ins_conflict_payload.read_memory_id);
+        return unit_conflict_payload.write_memory_id.intersects(ins_conflict_payload.read_memory_id);
     } else {
-        return SetsIntersection(unit_conflict_payload.used_memory_id, ins_conflict_payload.used_memory_id);
+        return unit_conflict_payload.used_memory_id.intersects(ins_conflict_payload.used_memory_id);
     }
 }
 
@@ -100,9 +115,9 @@ bool DataConflictPayload::checkDataConflict(const DataConflictPayload& ins_confl
 }
 
 DataConflictPayload& DataConflictPayload::operator+=(const pimsim::DataConflictPayload& other) {
-    this->read_memory_id.insert(other.read_memory_id.begin(), other.read_memory_id.end());
-    this->write_memory_id.insert(other.write_memory_id.begin(), other.write_memory_id.end());
-    this->used_memory_id.insert(other.used_memory_id.begin(), other.used_memory_id.end());
+    this->read_memory_id |= other.read_memory_id;
+    this->write_memory_id |= other.write_memory_id;
+    this->used_memory_id |= other.used_memory_id;
     this->use_pim_unit = (this->use_pim_unit || other.use_pim_unit);
     this->unit_type = other.unit_type;
     return *this;
@@ -115,7 +130,7 @@ DEFINE_PIM_PAYLOAD_FUNCTIONS(SIMDInsPayload, ins, input_cnt, opcode, inputs_bit_
                              inputs_address_byte, output_address_byte, len)
 
 DEFINE_PIM_PAYLOAD_FUNCTIONS(TransferInsPayload, ins, type, src_address_byte, dst_address_byte, size_byte, src_id,
-                             dst_id, transfer_id_tag)
+                             dst_id, transfer_id_tag, async, dst_cnt)
 
 DEFINE_PIM_PAYLOAD_FUNCTIONS(ScalarInsPayload, ins, op, src1_value, src2_value, offset, dst_reg, write_special_register)
 
@@ -147,7 +162,7 @@ DEFINE_TYPE_FROM_TO_JSON_FUNCTION_WITH_DEFAULT(SIMDInsPayload, ins, input_cnt, o
                                                output_bit_width, inputs_address_byte, output_address_byte, len)
 
 DEFINE_TYPE_FROM_TO_JSON_FUNCTION_WITH_DEFAULT(TransferInsPayload, ins, type, src_address_byte, dst_address_byte,
-                                               size_byte, src_id, dst_id, transfer_id_tag)
+                                               size_byte, src_id, dst_id, transfer_id_tag, async, dst_cnt)
 
 DEFINE_TYPE_FROM_TO_JSON_FUNCTION_WITH_DEFAULT(ScalarInsPayload, ins, op, src1_value, src2_value, offset, dst_reg,
                                                write_special_register)
@@ -6,6 +6,7 @@
 #include <array>
 #include <cstdint>
 #include <sstream>
+#include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -26,6 +27,34 @@ std::stringstream& operator<<(std::stringstream& out, const std::vector<int>& li
 
 std::stringstream& operator<<(std::stringstream& out, const std::unordered_map<int, int>& map);
 
+// Set of local memory ids stored as a bit mask. Bit 0 stands for id -1, i.e. an address outside all local memories.
+struct MemoryIdMask {
+    uint64_t bits{0};
+
+    void add(int memory_id) {
+        bits |= (uint64_t{1} << (memory_id + 1));
+    }
+
+    [[nodiscard]] bool contains(int memory_id) const {
+        return (bits & (uint64_t{1} << (memory_id + 1))) != 0;
+    }
+
+    [[nodiscard]] bool intersects(const MemoryIdMask& another) const {
+        return (bits & another.bits) != 0;
+    }
+
+    MemoryIdMask& operator|=(const MemoryIdMask& another) {
+        bits |= another.bits;
+        return *this;
+    }
+
+    bool operator==(const MemoryIdMask& another) const {
+        return bits == another.bits;
+    }
+};
+
+std::stringstream& operator<<(std::stringstream& out, const MemoryIdMask& mask);
+
 struct InstructionPayload {
     int pc{-1};
     int ins_id{-1};
@@ -47,13 +76,24 @@ struct InstructionPayload {
     DECLARE_TYPE_FROM_TO_JSON_FUNCTION_INTRUSIVE(InstructionPayload)
 };
 
+// borrowed view of data, a view read from a memory is valid until the next write to its range. null when no data
+// is kept, as in timing only runs
+struct DataView {
+    const uint8_t* data{nullptr};
+    int size_byte{0};
+
+    [[nodiscard]] bool empty() const {
+        return data == nullptr || size_byte == 0;
+    }
+};
+
 struct MemoryAccessPayload {
     InstructionPayload ins{};
 
     MemoryAccessType access_type;
     int address_byte;  // byte
     int size_byte;     // byte
-    std::vector<uint8_t> data;
+    DataView data;     // set by the memory for reads, and by the requester for writes
     sc_core::sc_event& finish_access;
 };
 
@@ -63,9 +103,9 @@ struct DataConflictPayload {
     int ins_id{-1};
     ExecuteUnitType unit_type{ExecuteUnitType::none};
 
-    std::unordered_set<int> read_memory_id;
-    std::unordered_set<int> write_memory_id;
-    std::unordered_set<int> used_memory_id;
+    MemoryIdMask read_memory_id;
+    MemoryIdMask write_memory_id;
+    MemoryIdMask used_memory_id;
 
     bool use_pim_unit{false};
 
@@ -87,6 +127,7 @@ struct DataConflictPayload {
 
     DataConflictPayload& operator+=(const DataConflictPayload& other);
 };
+static_assert(std::is_trivially_copyable_v<DataConflictPayload>);
 
 struct SIMDInsPayload {
     MAKE_SIGNAL_TYPE_TRACE_STREAM(SIMDInsPayload)
@@ -127,6 +168,11 @@ struct TransferInsPayload {
     int dst_id{0};
     int transfer_id_tag{0};
 
+    // goes on in the background after the instruction finishes, until a wait instruction for it
+    bool async{false};
+    // a send multicast to the cores from 'dst_id' to 'dst_id' + 'dst_cnt' - 1, except the sender itself
+    int dst_cnt{1};
+
     DECLARE_PIM_PAYLOAD_FUNCTIONS(TransferInsPayload)
     DECLARE_TYPE_FROM_TO_JSON_FUNCTION_INTRUSIVE(TransferInsPayload)
 };
@@ -20,17 +20,25 @@ Macro::Macro(const char *name, const pimsim::PimUnitConfig &config, const pimsim
     , macro_size_(config.macro_size)
     , independent_ipu_(independent_ipu)
     , activation_element_col_cnt_(config.macro_size.element_cnt_per_compartment)
-    , result_adder_socket_ptr_(result_adder_socket_ptr) {
+    , result_adder_socket_ptr_(result_adder_socket_ptr)
+    , analytic_(config.macro_sim_mode == +PimMacroSimMode::analytic)
+    , analytic_model_(config, sim_config.period_ns,
+                      analytic_ ? std::vector<bool>{independent_ipu} : std::vector<bool>{}) {
     for (int i = 0; i < IntDivCeil(macro_size_.element_cnt_per_compartment, BYTE_TO_BIT); i++) {
         activation_element_col_mask_.push_back(BYTE_MAX_VALUE);
     }
 
-    SC_THREAD(processIPUAndIssue)
-    SC_THREAD(processSRAMSubmodule)
-    SC_THREAD(processPostProcessSubmodule)
-    SC_THREAD(processAdderTreeSubmodule1)
-    SC_THREAD(processAdderTreeSubmodule2)
-    SC_THREAD(processShiftAdderSubmodule)
+    if (analytic_) {
+        SC_THREAD(processAnalyticIssue)
+        SC_THREAD(processAnalyticFinish)
+    } else {
+        SC_THREAD(processIPUAndIssue)
+        SC_THREAD(processSRAMSubmodule)
+        SC_THREAD(processPostProcessSubmodule)
+        SC_THREAD(processAdderTreeSubmodule1)
+        SC_THREAD(processAdderTreeSubmodule2)
+        SC_THREAD(processShiftAdderSubmodule)
+    }
 
     const int ipu_cnt = 1;
     const int sram_cnt = 1;
@@ -42,12 +50,12 @@ Macro::Macro(const char *name, const pimsim::PimUnitConfig &config, const pimsim
     const int shift_adder_cnt = macro_size_.element_cnt_per_compartment;
     const int result_adder_cnt = macro_size_.element_cnt_per_compartment;
 
-    ipu_energy_counter_.setStaticPowerMW(config_.ipu.static_power_mW * ipu_cnt);
-    sram_energy_counter_.setStaticPowerMW(config_.sram.static_power_mW * sram_cnt);
-    post_process_energy_counter_.setStaticPowerMW(config_.bit_sparse_config.static_power_mW * post_process_cnt);
-    adder_tree_energy_counter_.setStaticPowerMW(config_.adder_tree.static_power_mW * adder_tree_cnt);
-    shift_adder_energy_counter_.setStaticPowerMW(config_.shift_adder.static_power_mW * shift_adder_cnt);
-    result_adder_energy_counter_.setStaticPowerMW(config_.result_adder.static_power_mW * result_adder_cnt);
+    ipu_energy_counter_.setStaticPowerMW(config_.ipu.static_power_mW, ipu_cnt);
+    sram_energy_counter_.setStaticPowerMW(config_.sram.static_power_mW, sram_cnt);
+    post_process_energy_counter_.setStaticPowerMW(config_.bit_sparse_config.static_power_mW, post_process_cnt);
+    adder_tree_energy_counter_.setStaticPowerMW(config_.adder_tree.static_power_mW, adder_tree_cnt);
+    shift_adder_energy_counter_.setStaticPowerMW(config_.shift_adder.static_power_mW, shift_adder_cnt);
+    result_adder_energy_counter_.setStaticPowerMW(config_.result_adder.static_power_mW, result_adder_cnt);
 }
 
 void Macro::startExecute(pimsim::MacroPayload payload) {
@@ -60,6 +68,10 @@ void Macro::waitUntilFinishIfBusy() {
 }
 
 EnergyReporter Macro::getEnergyReporter() {
+    if (analytic_) {
+        return analytic_model_.getEnergyReporter(0);
+    }
+
     EnergyReporter macro_reporter;
     if (independent_ipu_) {
         macro_reporter.addSubModule("ipu", EnergyReporter{ipu_energy_counter_});
@@ -91,6 +103,10 @@ void Macro::setFinishRunFunction(std::function<void()> finish_func) {
 
 void Macro::setActivationElementColumn(const std::vector<unsigned char> &macros_activation_element_col_mask,
                                        int start_index) {
+    if (analytic_) {
+        analytic_model_.setActivationElementColumn(0, macros_activation_element_col_mask, start_index);
+    }
+
     activation_element_col_cnt_ = 0;
     for (int i = 0; i < macro_size_.element_cnt_per_compartment; i++) {
         if (getMaskBit(macros_activation_element_col_mask, i + start_index) != 0) {
@@ -130,9 +146,8 @@ void Macro::processIPUAndIssue() {
                 LOG(fmt::format("{} start ipu and issue, ins pc: {}, sub ins num: {}, batch: {}", getName(),
                                 pim_ins_info.ins_pc, pim_ins_info.sub_ins_num, submodule_payload.batch_info.batch_num));
 
-                double dynamic_power_mW = config_.ipu.dynamic_power_mW;
                 double latency = config_.ipu.latency_cycle * period_ns_;
-                ipu_energy_counter_.addDynamicEnergyPJ(latency, dynamic_power_mW);
+                ipu_energy_counter_.addDynamicEnergyPJ(latency, config_.ipu.dynamic_power_mW);
                 wait(latency, SC_NS);
 
                 waitAndStartNextSubmodule(submodule_payload, sram_socket_);
@@ -152,10 +167,10 @@ void Macro::processSRAMSubmodule() {
         LOG(fmt::format("{} start sram read, ins pc: {}, sub ins num: {}, batch: {}", getName(), pim_ins_info.ins_pc,
                         pim_ins_info.sub_ins_num, payload.batch_info.batch_num));
 
-        double dynamic_power_mW = config_.sram.read_dynamic_power_per_bit_mW * macro_size_.bit_width_per_row * 1 *
-                                  macro_size_.element_cnt_per_compartment * macro_size_.compartment_cnt_per_macro;
+        int read_bit_cnt = macro_size_.bit_width_per_row * 1 * macro_size_.element_cnt_per_compartment *
+                           macro_size_.compartment_cnt_per_macro;
         double latency = config_.sram.read_latency_cycle * period_ns_;
-        sram_energy_counter_.addDynamicEnergyPJ(latency, dynamic_power_mW);
+        sram_energy_counter_.addDynamicEnergyPJ(latency, config_.sram.read_dynamic_power_per_bit_mW, read_bit_cnt);
         wait(latency, SC_NS);
 
         waitAndStartNextSubmodule(payload, post_process_socket_);
@@ -178,16 +193,17 @@ void Macro::processPostProcessSubmodule() {
                 int meta_size_byte = config_.bit_sparse_config.mask_bit_width *
                                      macro_size_.element_cnt_per_compartment * macro_size_.compartment_cnt_per_macro /
                                      BYTE_TO_BIT;
-                double meta_read_dynamic_power_mW = config_.bit_sparse_config.reg_buffer_dynamic_power_mW_per_unit *
-                                                    IntDivCeil(meta_size_byte, config_.bit_sparse_config.unit_byte);
-                meta_buffer_energy_counter_.addDynamicEnergyPJ(period_ns_, meta_read_dynamic_power_mW);
+                meta_buffer_energy_counter_.addDynamicEnergyPJ(
+                    period_ns_, config_.bit_sparse_config.reg_buffer_dynamic_power_mW_per_unit,
+                    IntDivCeil(meta_size_byte, config_.bit_sparse_config.unit_byte));
             }
 
-            double dynamic_power_mW = config_.bit_sparse_config.dynamic_power_mW *
-                                      payload.sub_ins_info.activation_element_col_cnt *
-                                      payload.sub_ins_info.compartment_num;
+            int post_process_cnt =
+                payload.sub_ins_info.activation_element_col_cnt * payload.sub_ins_info.compartment_num;
             double latency = config_.bit_sparse_config.latency_cycle * period_ns_;
-            post_process_energy_counter_.addDynamicEnergyPJ(latency == 0.0 ? period_ns_ : latency, dynamic_power_mW);
+            post_process_energy_counter_.addDynamicEnergyPJ(latency == 0.0 ? period_ns_ : latency,
+                                                            config_.bit_sparse_config.dynamic_power_mW,
+                                                            post_process_cnt);
             wait(latency, SC_NS);
         }
 
@@ -206,11 +222,11 @@ void Macro::processAdderTreeSubmodule1() {
         LOG(fmt::format("{} start adder tree stage 1, ins pc: {}, sub ins num: {}, batch: {}", getName(),
                         pim_ins_info.ins_pc, pim_ins_info.sub_ins_num, payload.batch_info.batch_num));
 
-        double dynamic_power_mW = config_.adder_tree.dynamic_power_mW;
         double latency = period_ns_;
         for (int i = 0; i < macro_size_.element_cnt_per_compartment; i++) {
             if (getMaskBit(payload.sub_ins_info.activation_element_col_mask, i) != 0) {
-                adder_tree_energy_counter_.addDynamicEnergyPJ(latency, dynamic_power_mW, sc_core::sc_time_stamp(), i);
+                adder_tree_energy_counter_.addDynamicEnergyPJ(latency, config_.adder_tree.dynamic_power_mW,
+                                                              sc_core::sc_time_stamp(), i);
             }
         }
         wait(latency, SC_NS);
@@ -230,11 +246,11 @@ void Macro::processAdderTreeSubmodule2() {
         LOG(fmt::format("{} start adder tree stage 2, ins pc: {}, sub ins num: {}, batch: {}", getName(),
                         pim_ins_info.ins_pc, pim_ins_info.sub_ins_num, payload.batch_info.batch_num));
 
-        double dynamic_power_mW = config_.adder_tree.dynamic_power_mW;
         double latency = period_ns_;
         for (int i = 0; i < macro_size_.element_cnt_per_compartment; i++) {
             if (getMaskBit(payload.sub_ins_info.activation_element_col_mask, i) != 0) {
-                adder_tree_energy_counter_.addDynamicEnergyPJ(latency, dynamic_power_mW, sc_core::sc_time_stamp(), i);
+                adder_tree_energy_counter_.addDynamicEnergyPJ(latency, config_.adder_tree.dynamic_power_mW,
+                                                              sc_core::sc_time_stamp(), i);
             }
         }
         wait(latency, SC_NS);
@@ -254,19 +270,18 @@ void Macro::processShiftAdderSubmodule() {
         LOG(fmt::format("{} start shift adder, ins pc: {}, sub ins num: {}, batch: {}", getName(), pim_ins_info.ins_pc,
                         pim_ins_info.sub_ins_num, payload.batch_info.batch_num));
 
-        double dynamic_power_mW =
-            config_.shift_adder.dynamic_power_mW * payload.sub_ins_info.activation_element_col_cnt;
         double latency = config_.shift_adder.latency_cycle * period_ns_;
-        shift_adder_energy_counter_.addDynamicEnergyPJ(latency, dynamic_power_mW);
+        shift_adder_energy_counter_.addDynamicEnergyPJ(latency, config_.shift_adder.dynamic_power_mW,
+                                                       payload.sub_ins_info.activation_element_col_cnt);
         wait(latency, SC_NS);
 
         if (payload.batch_info.last_batch) {
             if (result_adder_socket_ptr_ != nullptr) {
                 result_adder_socket_ptr_->waitUntilFinishIfBusy();
             }
-            dynamic_power_mW = config_.result_adder.dynamic_power_mW * payload.sub_ins_info.activation_element_col_cnt;
             latency = config_.result_adder.latency_cycle * period_ns_;
-            result_adder_energy_counter_.addDynamicEnergyPJ(latency, dynamic_power_mW);
+            result_adder_energy_counter_.addDynamicEnergyPJ(latency, config_.result_adder.dynamic_power_mW,
+                                                            payload.sub_ins_info.activation_element_col_cnt);
         }
 
         if (pim_ins_info.last_ins && pim_ins_info.last_sub_ins && payload.batch_info.last_batch && finish_run_func_) {
@@ -277,24 +292,50 @@ void Macro::processShiftAdderSubmodule() {
     }
 }
 
-std::pair<int, int> Macro::getBatchCountAndActivationCompartmentCount(const MacroPayload &payload) {
-    int valid_input_cnt = std::min(macro_size_.compartment_cnt_per_macro, static_cast<int>(payload.inputs.size()));
-    int activation_compartment_num = static_cast<int>(std::count_if(
-        payload.inputs.begin(), payload.inputs.begin() + valid_input_cnt, [](auto input) { return input != 0; }));
-    int batch_num;
-    if (config_.input_bit_sparse && payload.bit_sparse) {
-        batch_num = 0;
-        for (int i = 0; i < payload.input_bit_width; i++) {
-            if (std::any_of(payload.inputs.begin(), payload.inputs.begin() + valid_input_cnt,
-                            [i](auto input) { return (input & (1 << i)) != 0; })) {
-                batch_num++;
+void Macro::processAnalyticIssue() {
+    while (true) {
+        macro_socket_.waitUntilStart();
+
+        if (activation_element_col_cnt_ > 0) {
+            const auto &payload = macro_socket_.payload;
+            const auto &pim_ins_info = payload.pim_ins_info;
+            LOG(fmt::format("{} start analytic, ins pc: {}, sub ins num: {}", getName(), pim_ins_info.ins_pc,
+                            pim_ins_info.sub_ins_num));
+
+            if (getBatchCountAndActivationCompartmentCount(payload).first > 0) {
+                auto release_time = analytic_model_.schedule(0, payload, sc_core::sc_time_stamp());
+                analytic_finish_queue_.push(
+                    {.pim_ins_info = pim_ins_info, .finish_time = analytic_model_.getFinishTime(0)});
+                analytic_finish_push_.notify();
+                wait(release_time - sc_core::sc_time_stamp());
             }
         }
-    } else {
-        batch_num = activation_compartment_num == 0 ? 0 : payload.input_bit_width;
+
+        macro_socket_.finish();
     }
+}
 
-    return {batch_num, activation_compartment_num};
+void Macro::processAnalyticFinish() {
+    while (true) {
+        if (analytic_finish_queue_.empty()) {
+            wait(analytic_finish_push_);
+        }
+
+        auto finish_info = analytic_finish_queue_.front();
+        analytic_finish_queue_.pop();
+        if (finish_info.finish_time > sc_core::sc_time_stamp()) {
+            wait(finish_info.finish_time - sc_core::sc_time_stamp());
+        }
+
+        const auto &pim_ins_info = finish_info.pim_ins_info;
+        if (pim_ins_info.last_ins && pim_ins_info.last_sub_ins && finish_run_func_) {
+            finish_run_func_();
+        }
+    }
+}
+
+std::pair<int, int> Macro::getBatchCountAndActivationCompartmentCount(const MacroPayload &payload) {
+    return MacroArray::getBatchCountAndActivationCompartmentCount(config_, payload);
 }
 
 #undef LOG
@@ -4,11 +4,13 @@
 
 #pragma once
 #include <functional>
+#include <queue>
 
 #include "base_component/base_module.h"
 #include "base_component/fsm.h"
 #include "base_component/submodule_socket.h"
 #include "config/config.h"
+#include "macro_array.h"
 #include "pim_payload.h"
 
 namespace pimsim {
@@ -42,8 +44,18 @@ private:
     [[noreturn]] void processAdderTreeSubmodule2();
     [[noreturn]] void processShiftAdderSubmodule();
 
+    // analytic mode
+    [[noreturn]] void processAnalyticIssue();
+    [[noreturn]] void processAnalyticFinish();
+
     std::pair<int, int> getBatchCountAndActivationCompartmentCount(const MacroPayload& payload);
 
+private:
+    struct AnalyticFinishInfo {
+        PimInsInfo pim_ins_info{};
+        sc_core::sc_time finish_time{};
+    };
+
 private:
     const PimUnitConfig& config_;
     const PimMacroSizeConfig& macro_size_;
@@ -61,6 +73,12 @@ private:
 
     SubmoduleSocket<MacroGroupSubmodulePayload>* result_adder_socket_ptr_{nullptr};
 
+    // analytic mode
+    bool analytic_;
+    MacroArray analytic_model_;
+    std::queue<AnalyticFinishInfo> analytic_finish_queue_{};
+    sc_core::sc_event analytic_finish_push_;
+
     EnergyCounter ipu_energy_counter_;
     EnergyCounter sram_energy_counter_;
     EnergyCounter meta_buffer_energy_counter_;
@@ -0,0 +1,271 @@
+//
+// Created by wyk on 2024/11/13.
+//
+
+#include "macro_array.h"
+
+#include "util/util.h"
+
+namespace pimsim {
+
+MacroArray::MacroArray(const PimUnitConfig &config, double period_ns, const std::vector<bool> &independent_ipu)
+    : config_(config)
+    , macro_size_(config.macro_size)
+    , period_ns_(period_ns)
+    , macro_cnt_(static_cast<int>(independent_ipu.size()))
+    , mask_byte_cnt_(IntDivCeil(config.macro_size.element_cnt_per_compartment, BYTE_TO_BIT))
+    , independent_ipu_(independent_ipu)
+    , activation_element_col_cnt_(macro_cnt_, config.macro_size.element_cnt_per_compartment)
+    , activation_element_col_mask_(macro_cnt_ * mask_byte_cnt_, BYTE_MAX_VALUE)
+    , ipu_energy_counter_(macro_cnt_)
+    , sram_energy_counter_(macro_cnt_)
+    , meta_buffer_energy_counter_(macro_cnt_)
+    , post_process_energy_counter_(macro_cnt_)
+    , adder_tree_energy_counter_(macro_cnt_)
+    , shift_adder_energy_counter_(macro_cnt_)
+    , result_adder_energy_counter_(macro_cnt_) {
+    for (auto &release_time : stage_release_time_) {
+        release_time.resize(macro_cnt_ + 1, sc_core::SC_ZERO_TIME);
+    }
+
+    const int ipu_cnt = 1;
+    const int sram_cnt = 1;
+    const int post_process_cnt = config_.bit_sparse
+                                     ? macro_size_.row_cnt_per_element * 1 * macro_size_.element_cnt_per_compartment *
+                                           macro_size_.compartment_cnt_per_macro
+                                     : 0;
+    const int adder_tree_cnt = macro_size_.element_cnt_per_compartment;
+    const int shift_adder_cnt = macro_size_.element_cnt_per_compartment;
+    const int result_adder_cnt = macro_size_.element_cnt_per_compartment;
+
+    for (int macro_id = 0; macro_id < macro_cnt_; macro_id++) {
+        ipu_energy_counter_[macro_id].setStaticPowerMW(config_.ipu.static_power_mW, ipu_cnt);
+        sram_energy_counter_[macro_id].setStaticPowerMW(config_.sram.static_power_mW, sram_cnt);
+        post_process_energy_counter_[macro_id].setStaticPowerMW(config_.bit_sparse_config.static_power_mW,
+                                                                post_process_cnt);
+        adder_tree_energy_counter_[macro_id].setStaticPowerMW(config_.adder_tree.static_power_mW, adder_tree_cnt);
+        shift_adder_energy_counter_[macro_id].setStaticPowerMW(config_.shift_adder.static_power_mW, shift_adder_cnt);
+        result_adder_energy_counter_[macro_id].setStaticPowerMW(config_.result_adder.static_power_mW,
+                                                                result_adder_cnt);
+    }
+}
+
+// Replays the blocking hand-off of the event-driven pipeline batch by batch: a stage finishes its batch after its
+// latency, then holds it until the next stage has released the previous batch. Times are kept in sc_time so that
+// they round exactly like the waits of the event-driven mode, and energy is booked with the same calls and the same
+// time tags.
+sc_core::sc_time MacroArray::schedule(int macro_id, const MacroPayload &payload, const sc_core::sc_time &start_time) {
+    const int activation_element_col_cnt = activation_element_col_cnt_[macro_id];
+    if (activation_element_col_cnt == 0) {
+        return start_time;
+    }
+    auto [batch_cnt, compartment_num] = getBatchCountAndActivationCompartmentCount(config_, payload);
+    if (batch_cnt == 0) {
+        return start_time;
+    }
+
+    const bool post_process = config_.bit_sparse && payload.bit_sparse;
+
+    const double ipu_latency = config_.ipu.latency_cycle * period_ns_;
+    const double sram_latency = config_.sram.read_latency_cycle * period_ns_;
+    const double post_process_latency = post_process ? config_.bit_sparse_config.latency_cycle * period_ns_ : 0.0;
+    const double adder_tree_latency = period_ns_;
+    const double shift_adder_latency = config_.shift_adder.latency_cycle * period_ns_;
+    const auto stage_latency = getStageLatency(post_process);
+
+    const int sram_read_bit_cnt = macro_size_.bit_width_per_row * 1 * macro_size_.element_cnt_per_compartment *
+                                  macro_size_.compartment_cnt_per_macro;
+    const int post_process_cnt = activation_element_col_cnt * compartment_num;
+
+    auto &adder_tree_energy_counter = adder_tree_energy_counter_[macro_id];
+    auto add_adder_tree_energy = [&](const sc_core::sc_time &time) {
+        for (int i = 0; i < macro_size_.element_cnt_per_compartment; i++) {
+            if (isElementColumnActive(macro_id, i)) {
+                adder_tree_energy_counter.addDynamicEnergyPJ(adder_tree_latency, config_.adder_tree.dynamic_power_mW,
+                                                             time, i);
+            }
+        }
+    };
+
+    auto hand_over = [&](int stage, const sc_core::sc_time &time) {
+        return handOver(macro_id, stage, time + stage_latency[stage]);
+    };
+
+    for (int batch = 0; batch < batch_cnt; batch++) {
+        auto time = (batch == 0) ? start_time : stage_release_time_[0][macro_id];
+
+        ipu_energy_counter_[macro_id].addDynamicEnergyPJ(ipu_latency, config_.ipu.dynamic_power_mW);
+        time = hand_over(0, time);
+
+        sram_energy_counter_[macro_id].addDynamicEnergyPJ(sram_latency, config_.sram.read_dynamic_power_per_bit_mW,
+                                                          sram_read_bit_cnt);
+        time = hand_over(1, time);
+
+        if (post_process) {
+            if (batch == 0) {
+                int meta_size_byte = config_.bit_sparse_config.mask_bit_width *
+                                     macro_size_.element_cnt_per_compartment * macro_size_.compartment_cnt_per_macro /
+                                     BYTE_TO_BIT;
+                meta_buffer_energy_counter_[macro_id].addDynamicEnergyPJ(
+                    period_ns_, config_.bit_sparse_config.reg_buffer_dynamic_power_mW_per_unit,
+                    IntDivCeil(meta_size_byte, config_.bit_sparse_config.unit_byte));
+            }
+            post_process_energy_counter_[macro_id].addDynamicEnergyPJ(
+                post_process_latency == 0.0 ? period_ns_ : post_process_latency,
+                config_.bit_sparse_config.dynamic_power_mW, post_process_cnt);
+        }
+        time = hand_over(2, time);
+
+        add_adder_tree_energy(time);
+        time = hand_over(3, time);
+
+        add_adder_tree_energy(time);
+        time = hand_over(4, time);
+
+        shift_adder_energy_counter_[macro_id].addDynamicEnergyPJ(
+            shift_adder_latency, config_.shift_adder.dynamic_power_mW, activation_element_col_cnt);
+        hand_over(5, time);
+    }
+    holdLastBatchForResultAdder(macro_id);
+
+    result_adder_energy_counter_[macro_id].addDynamicEnergyPJ(config_.result_adder.latency_cycle * period_ns_,
+                                                              config_.result_adder.dynamic_power_mW,
+                                                              activation_element_col_cnt);
+
+    return stage_release_time_[0][macro_id];
+}
+
+// Like the event-driven controller, which hands every batch on whatever the inputs and starts the result adder once
+// its shift adder has the last batch and the result adder is free.
+sc_core::sc_time MacroArray::scheduleController(const MacroPayload &payload, const sc_core::sc_time &start_time) {
+    const int batch_cnt = payload.input_bit_width;
+    if (batch_cnt == 0) {
+        return start_time;
+    }
+
+    const auto stage_latency = getStageLatency(config_.bit_sparse && payload.bit_sparse);
+    for (int batch = 0; batch < batch_cnt; batch++) {
+        auto time = (batch == 0) ? start_time : stage_release_time_[0][macro_cnt_];
+        for (int stage = 0; stage < STAGE_CNT; stage++) {
+            time = handOver(macro_cnt_, stage, time + stage_latency[stage]);
+        }
+    }
+    holdLastBatchForResultAdder(macro_cnt_);
+
+    // the instructions scheduled from now on start after 'start_time', the result adder is free for them before it
+    while (!result_adder_busy_time_.empty() && result_adder_busy_time_.front().second <= start_time) {
+        result_adder_busy_time_.pop_front();
+    }
+    const auto &result_adder_start_time = stage_release_time_[STAGE_CNT - 1][macro_cnt_];
+    result_adder_busy_time_.emplace_back(
+        result_adder_start_time,
+        result_adder_start_time + sc_core::sc_time{config_.result_adder.latency_cycle * period_ns_, SC_NS});
+
+    return stage_release_time_[0][macro_cnt_];
+}
+
+const sc_core::sc_time &MacroArray::getReleaseTime(int macro_id) const {
+    return stage_release_time_[0][macro_id];
+}
+
+const sc_core::sc_time &MacroArray::getFinishTime(int macro_id) const {
+    return stage_release_time_[STAGE_CNT - 1][macro_id];
+}
+
+const sc_core::sc_time &MacroArray::getControllerReleaseTime() const {
+    return stage_release_time_[0][macro_cnt_];
+}
+
+EnergyReporter MacroArray::getEnergyReporter(int macro_id) const {
+    EnergyReporter macro_reporter;
+    if (independent_ipu_[macro_id]) {
+        macro_reporter.addSubModule("ipu", EnergyReporter{ipu_energy_counter_[macro_id]});
+    }
+    if (config_.bit_sparse) {
+        macro_reporter.addSubModule("meta buffer", EnergyReporter{meta_buffer_energy_counter_[macro_id]});
+    }
+    macro_reporter.addSubModule("sram read", EnergyReporter{sram_energy_counter_[macro_id]});
+    macro_reporter.addSubModule("post process", EnergyReporter{post_process_energy_counter_[macro_id]});
+    macro_reporter.addSubModule("adder tree", EnergyReporter{adder_tree_energy_counter_[macro_id]});
+    macro_reporter.addSubModule("shift adder", EnergyReporter{shift_adder_energy_counter_[macro_id]});
+    macro_reporter.addSubModule("result adder", EnergyReporter{result_adder_energy_counter_[macro_id]});
+    return std::move(macro_reporter);
+}
+
+void MacroArray::setActivationElementColumn(int macro_id,
+                                            const std::vector<unsigned char> &macros_activation_element_col_mask,
+                                            int start_index) {
+    int &activation_element_col_cnt = activation_element_col_cnt_[macro_id];
+    unsigned char *mask = activation_element_col_mask_.data() + macro_id * mask_byte_cnt_;
+
+    activation_element_col_cnt = 0;
+    for (int i = 0; i < macro_size_.element_cnt_per_compartment; i++) {
+        if (getMaskBit(macros_activation_element_col_mask, i + start_index) != 0) {
+            activation_element_col_cnt++;
+            mask[i / BYTE_TO_BIT] |= (1 << (i % BYTE_TO_BIT));
+        } else {
+            mask[i / BYTE_TO_BIT] &= (~(1 << (i % BYTE_TO_BIT)));
+        }
+    }
+}
+
+int MacroArray::getActivationElementColumnCount(int macro_id) const {
+    return activation_element_col_cnt_[macro_id];
+}
+
+std::pair<int, int> MacroArray::getBatchCountAndActivationCompartmentCount(const PimUnitConfig &config,
+                                                                           const MacroPayload &payload) {
+    int valid_input_cnt =
+        std::min(config.macro_size.compartment_cnt_per_macro, static_cast<int>(payload.inputs.size()));
+    int activation_compartment_num = static_cast<int>(std::count_if(
+        payload.inputs.begin(), payload.inputs.begin() + valid_input_cnt, [](auto input) { return input != 0; }));
+    int batch_num;
+    if (config.input_bit_sparse && payload.bit_sparse) {
+        batch_num = 0;
+        for (int i = 0; i < payload.input_bit_width; i++) {
+            if (std::any_of(payload.inputs.begin(), payload.inputs.begin() + valid_input_cnt,
+                            [i](auto input) { return (input & (1 << i)) != 0; })) {
+                batch_num++;
+            }
+        }
+    } else {
+        batch_num = activation_compartment_num == 0 ? 0 : payload.input_bit_width;
+    }
+
+    return {batch_num, activation_compartment_num};
+}
+
+std::array<sc_core::sc_time, MacroArray::STAGE_CNT> MacroArray::getStageLatency(bool post_process) const {
+    const double post_process_latency = post_process ? config_.bit_sparse_config.latency_cycle * period_ns_ : 0.0;
+    return {sc_core::sc_time{config_.ipu.latency_cycle * period_ns_, SC_NS},
+            sc_core::sc_time{config_.sram.read_latency_cycle * period_ns_, SC_NS},
+            sc_core::sc_time{post_process_latency, SC_NS},
+            sc_core::sc_time{period_ns_, SC_NS},
+            sc_core::sc_time{period_ns_, SC_NS},
+            sc_core::sc_time{config_.shift_adder.latency_cycle * period_ns_, SC_NS}};
+}
+
+sc_core::sc_time MacroArray::handOver(int macro_id, int stage, const sc_core::sc_time &finish_time) {
+    auto &release_time = stage_release_time_[stage][macro_id];
+    release_time = (stage + 1 < STAGE_CNT) ? std::max(finish_time, stage_release_time_[stage + 1][macro_id])
+                                           : finish_time;
+    return release_time;
+}
+
+// The shift adder waits once for the result adder it finds busy, the controller may start it again right then.
+void MacroArray::holdLastBatchForResultAdder(int macro_id) {
+    auto &release_time = stage_release_time_[STAGE_CNT - 1][macro_id];
+    for (const auto &[busy_start_time, busy_end_time] : result_adder_busy_time_) {
+        if (busy_start_time < release_time && release_time < busy_end_time) {
+            release_time = busy_end_time;
+            return;
+        }
+    }
+}
+
+bool MacroArray::isElementColumnActive(int macro_id, int element_col) const {
+    return (activation_element_col_mask_[macro_id * mask_byte_cnt_ + element_col / BYTE_TO_BIT] &
+            (1 << (element_col % BYTE_TO_BIT))) != 0;
+}
+
+}  // namespace pimsim
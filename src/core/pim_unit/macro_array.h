@@ -0,0 +1,87 @@
+//
+// Created by wyk on 2024/11/13.
+//
+
+#pragma once
+#include <array>
+#include <deque>
+#include <vector>
+
+#include "base_component/energy_counter.h"
+#include "config/config.h"
+#include "pim_payload.h"
+#include "systemc.h"
+#include "util/reporter.h"
+
+namespace pimsim {
+
+// Analytic model of several macros, used by the analytic macro simulation mode. Per-macro state is kept in
+// structure-of-arrays form and no simulation process is owned, the caller advances all macros from its own process
+// and waits for the returned times. The controller of the group, which runs the same pipeline and starts the result
+// adder the macros share, is kept as one more row, so that the shift adders hold their last batch while the result
+// adder is busy.
+class MacroArray {
+public:
+    // ipu, sram, post process, adder tree 1, adder tree 2, shift adder
+    static constexpr int STAGE_CNT = 6;
+
+    MacroArray(const PimUnitConfig& config, double period_ns, const std::vector<bool>& independent_ipu);
+
+    // schedules the whole pipeline of the macro for one instruction started at 'start_time' and books its energy,
+    // returns the time the macro can accept the next instruction
+    sc_core::sc_time schedule(int macro_id, const MacroPayload& payload, const sc_core::sc_time& start_time);
+    // schedules the pipeline of the controller for one instruction started at 'start_time', which runs all batches
+    // of the instruction whatever the inputs and then starts the result adder, returns the time the controller can
+    // accept the next instruction. the macros of the instruction are scheduled before it
+    sc_core::sc_time scheduleController(const MacroPayload& payload, const sc_core::sc_time& start_time);
+
+    [[nodiscard]] const sc_core::sc_time& getReleaseTime(int macro_id) const;
+    [[nodiscard]] const sc_core::sc_time& getFinishTime(int macro_id) const;
+    [[nodiscard]] const sc_core::sc_time& getControllerReleaseTime() const;
+
+    EnergyReporter getEnergyReporter(int macro_id) const;
+
+    void setActivationElementColumn(int macro_id, const std::vector<unsigned char>& macros_activation_element_col_mask,
+                                    int start_index = 0);
+    [[nodiscard]] int getActivationElementColumnCount(int macro_id) const;
+
+    static std::pair<int, int> getBatchCountAndActivationCompartmentCount(const PimUnitConfig& config,
+                                                                          const MacroPayload& payload);
+
+private:
+    [[nodiscard]] std::array<sc_core::sc_time, STAGE_CNT> getStageLatency(bool post_process) const;
+    // the stage hands the batch that finishes at 'finish_time' over once the next stage has released the previous
+    // one, returns the time, which is also the start time of the next stage
+    sc_core::sc_time handOver(int macro_id, int stage, const sc_core::sc_time& finish_time);
+    void holdLastBatchForResultAdder(int macro_id);
+    [[nodiscard]] bool isElementColumnActive(int macro_id, int element_col) const;
+
+private:
+    const PimUnitConfig& config_;
+    const PimMacroSizeConfig& macro_size_;
+    const double period_ns_;
+    const int macro_cnt_;
+    const int mask_byte_cnt_;
+
+    std::vector<bool> independent_ipu_;
+    std::vector<int> activation_element_col_cnt_;
+    // masks of all macros back to back, 'mask_byte_cnt_' bytes each
+    std::vector<unsigned char> activation_element_col_mask_;
+
+    // the time each stage of each macro hands its last batch over to the next stage, indexed by [stage][macro], the
+    // controller last
+    std::array<std::vector<sc_core::sc_time>, STAGE_CNT> stage_release_time_;
+    // the start and finish time of the result adder for the instructions the controller has scheduled, from the ones
+    // that may still hold a shift adder on
+    std::deque<std::pair<sc_core::sc_time, sc_core::sc_time>> result_adder_busy_time_;
+
+    std::vector<EnergyCounter> ipu_energy_counter_;
+    std::vector<EnergyCounter> sram_energy_counter_;
+    std::vector<EnergyCounter> meta_buffer_energy_counter_;
+    std::vector<EnergyCounter> post_process_energy_counter_;
+    std::vector<EnergyCounter> adder_tree_energy_counter_;
+    std::vector<EnergyCounter> shift_adder_energy_counter_;
+    std::vector<EnergyCounter> result_adder_energy_counter_;
+};
+
+}  // namespace pimsim
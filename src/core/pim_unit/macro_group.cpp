@@ -16,15 +16,19 @@ MacroGroup::MacroGroup(const char *name, const pimsim::PimUnitConfig &config, co
     , config_(config)
     , macro_size_(config.macro_size)
     , controller_(std::string(name) + "_controller", config, sim_config, core, clk, next_sub_ins_, result_adder_socket_)
+    , analytic_(config.macro_sim_mode == +PimMacroSimMode::analytic)
+    , macro_array_(config, sim_config.period_ns, analytic_ ? getMacrosIndependentIPU(config) : std::vector<bool>{})
     , activation_macro_cnt_(config.macro_group_size) {
     SC_THREAD(processIssue)
     SC_THREAD(processResultAdderSubmodule)
 
+    if (analytic_) {
+        return;
+    }
     for (int i = 0; i < config_.macro_group_size; i++) {
         auto macro_name = fmt::format("{}_macro_{}", getName(), i);
-        bool independent_ipu = config_.value_sparse || i == 0;
-        macro_list_.push_back(
-            new Macro(macro_name.c_str(), config_, sim_config, core, clk, independent_ipu, &result_adder_socket_));
+        macro_list_.push_back(new Macro(macro_name.c_str(), config_, sim_config, core, clk,
+                                        hasIndependentIPU(config_, i), &result_adder_socket_));
     }
 }
 
@@ -39,6 +43,12 @@ void MacroGroup::waitUntilFinishIfBusy() {
 
 EnergyReporter MacroGroup::getEnergyReporter() {
     EnergyReporter macro_group_reporter;
+    if (analytic_) {
+        for (int macro_id = 0; macro_id < config_.macro_group_size; macro_id++) {
+            macro_group_reporter.accumulate(macro_array_.getEnergyReporter(macro_id), true);
+        }
+        return std::move(macro_group_reporter);
+    }
     for (auto *macro : macro_list_) {
         macro_group_reporter.accumulate(macro->getEnergyReporter(), true);
     }
@@ -55,6 +65,16 @@ void MacroGroup::setFinishRunFunc(std::function<void()> finish_run_func) {
 
 void MacroGroup::setMacrosActivationElementColumn(
     const std::vector<unsigned char> &macros_activation_element_col_mask) {
+    if (analytic_) {
+        activation_macro_cnt_ = 0;
+        for (int macro_id = 0; macro_id < config_.macro_group_size; macro_id++) {
+            int start_index = macro_id * macro_size_.element_cnt_per_compartment;
+            macro_array_.setActivationElementColumn(macro_id, macros_activation_element_col_mask, start_index);
+            activation_macro_cnt_ += (macro_array_.getActivationElementColumnCount(macro_id) > 0) ? 1 : 0;
+        }
+        return;
+    }
+
     for (int i = 0; i < macro_list_.size(); i++) {
         int start_index = i * macro_size_.element_cnt_per_compartment;
         macro_list_[i]->setActivationElementColumn(macros_activation_element_col_mask, start_index);
@@ -70,6 +90,13 @@ int MacroGroup::getActivationMacroCount() const {
 }
 
 int MacroGroup::getActivationElementColumnCount() const {
+    if (analytic_) {
+        int activation_element_col_cnt = 0;
+        for (int macro_id = 0; macro_id < config_.macro_group_size; macro_id++) {
+            activation_element_col_cnt += macro_array_.getActivationElementColumnCount(macro_id);
+        }
+        return activation_element_col_cnt;
+    }
     return std::transform_reduce(
         macro_list_.begin(), macro_list_.end(), 0, [](int a, int b) { return a + b; },
         [](const Macro *macro) { return macro->getActivationElementColumnCount(); });
@@ -84,18 +111,22 @@ void MacroGroup::processIssue() {
         LOG(fmt::format("{} start, ins pc: {}, sub ins num: {}", getName(), pim_ins_info.ins_pc,
                         pim_ins_info.sub_ins_num));
 
-        for (int macro_id = 0; macro_id < macro_list_.size(); macro_id++) {
-            MacroPayload macro_payload{.pim_ins_info = pim_ins_info,
-                                       .row = payload.row,
-                                       .input_bit_width = payload.input_bit_width,
-                                       .bit_sparse = payload.bit_sparse};
-            if (macro_id < payload.macro_inputs.size()) {
-                macro_payload.inputs.swap(payload.macro_inputs[macro_id]);
+        if (analytic_) {
+            issueAnalyticMacros(payload);
+        } else {
+            for (int macro_id = 0; macro_id < macro_list_.size(); macro_id++) {
+                MacroPayload macro_payload{.pim_ins_info = pim_ins_info,
+                                           .row = payload.row,
+                                           .input_bit_width = payload.input_bit_width,
+                                           .bit_sparse = payload.bit_sparse};
+                if (macro_id < payload.macro_inputs.size()) {
+                    macro_payload.inputs.swap(payload.macro_inputs[macro_id]);
+                }
+
+                auto *macro = macro_list_[macro_id];
+                macro->waitUntilFinishIfBusy();
+                macro->startExecute(std::move(macro_payload));
             }
-
-            auto *macro = macro_list_[macro_id];
-            macro->waitUntilFinishIfBusy();
-            macro->startExecute(std::move(macro_payload));
         }
 
         controller_.waitUntilFinishIfBusy();
@@ -109,6 +140,42 @@ void MacroGroup::processIssue() {
     }
 }
 
+void MacroGroup::issueAnalyticMacros(MacroGroupPayload &payload) {
+    // macros are started one after another, each one as soon as it has released its previous instruction
+    auto start_time = sc_core::sc_time_stamp();
+    MacroPayload macro_payload{.pim_ins_info = payload.pim_ins_info,
+                               .row = payload.row,
+                               .input_bit_width = payload.input_bit_width,
+                               .bit_sparse = payload.bit_sparse};
+    for (int macro_id = 0; macro_id < config_.macro_group_size; macro_id++) {
+        macro_payload.inputs.clear();
+        if (macro_id < payload.macro_inputs.size()) {
+            macro_payload.inputs.swap(payload.macro_inputs[macro_id]);
+        }
+
+        start_time = std::max(start_time, macro_array_.getReleaseTime(macro_id));
+        macro_array_.schedule(macro_id, macro_payload, start_time);
+    }
+
+    // the controller is started next, as soon as it has released its previous instruction. its result adder holds
+    // the shift adders of the macros from the next instruction on
+    macro_array_.scheduleController(macro_payload, std::max(start_time, macro_array_.getControllerReleaseTime()));
+    wait(start_time - sc_core::sc_time_stamp());
+}
+
+// the macros share the ipu of the first one, unless each of them takes its own inputs for value sparsity
+bool MacroGroup::hasIndependentIPU(const PimUnitConfig &config, int macro_id) {
+    return config.value_sparse || macro_id == 0;
+}
+
+std::vector<bool> MacroGroup::getMacrosIndependentIPU(const PimUnitConfig &config) {
+    std::vector<bool> independent_ipu(config.macro_group_size);
+    for (int i = 0; i < config.macro_group_size; i++) {
+        independent_ipu[i] = hasIndependentIPU(config, i);
+    }
+    return independent_ipu;
+}
+
 void MacroGroup::processResultAdderSubmodule() {
     while (true) {
         result_adder_socket_.waitUntilStart();
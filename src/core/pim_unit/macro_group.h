@@ -8,6 +8,7 @@
 #include "base_component/base_module.h"
 #include "config/config.h"
 #include "macro.h"
+#include "macro_array.h"
 #include "macro_group_controller.h"
 
 namespace pimsim {
@@ -34,12 +35,19 @@ private:
     [[noreturn]] void processIssue();
     [[noreturn]] void processResultAdderSubmodule();
 
+    void issueAnalyticMacros(MacroGroupPayload& payload);
+    static bool hasIndependentIPU(const PimUnitConfig& config, int macro_id);
+    static std::vector<bool> getMacrosIndependentIPU(const PimUnitConfig& config);
+
 private:
     const PimUnitConfig& config_;
     const PimMacroSizeConfig& macro_size_;
 
     MacroGroupController controller_;
     std::vector<Macro*> macro_list_;
+    // analytic mode, all macros of the group are advanced by the issue process instead of one module per macro
+    bool analytic_;
+    MacroArray macro_array_;
     int activation_macro_cnt_{0};
 
     SubmoduleSocket<MacroGroupPayload> macro_group_socket_{};
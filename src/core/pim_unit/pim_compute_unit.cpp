@@ -221,9 +221,9 @@ void PimComputeUnit::processSubInsCompute(const PimComputeSubInsPayload &sub_ins
 
         if (config_.value_sparse && payload.value_sparse &&
             (group_id + 1) % config_.value_sparse_config.output_macro_group_cnt == 0) {
-            double dynamic_power_mW = config_.value_sparse_config.dynamic_power_mW;
             double latency = config_.value_sparse_config.latency_cycle * period_ns_;
-            value_sparse_network_energy_counter_.addDynamicEnergyPJ(latency, dynamic_power_mW);
+            value_sparse_network_energy_counter_.addDynamicEnergyPJ(latency,
+                                                                    config_.value_sparse_config.dynamic_power_mW);
             wait(latency, SC_NS);
         }
     }
@@ -285,9 +285,9 @@ void PimComputeUnit::readBitSparseMetaSubmodule() {
         auto &payload = read_bit_sparse_meta_socket_.payload;
         payload.data = local_memory_socket_.readData(payload.ins, payload.addr_byte, payload.size_byte);
 
-        double dynamic_power_mW = config_.bit_sparse_config.reg_buffer_dynamic_power_mW_per_unit *
-                                  IntDivCeil(payload.size_byte, config_.bit_sparse_config.unit_byte);
-        meta_buffer_energy_counter_.addDynamicEnergyPJ(period_ns_, dynamic_power_mW);
+        meta_buffer_energy_counter_.addDynamicEnergyPJ(
+            period_ns_, config_.bit_sparse_config.reg_buffer_dynamic_power_mW_per_unit,
+            IntDivCeil(payload.size_byte, config_.bit_sparse_config.unit_byte));
 
         read_bit_sparse_meta_socket_.finish();
     }
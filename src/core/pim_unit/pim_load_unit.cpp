@@ -95,10 +95,10 @@ void PimLoadUnit::processExecute() {
         int process_times = IntDivCeil(weight_bit_size, pim_bit_width);
 
         // load weight
-        double dynamic_power_mW = config_.sram.write_dynamic_power_per_bit_mW * pim_bit_width;
         double latency = config_.sram.write_latency_cycle * period_ns_;
         for (int i = 0; i < process_times; i++) {
-            sram_write_energy_counter_.addDynamicEnergyPJ(latency, dynamic_power_mW);
+            sram_write_energy_counter_.addDynamicEnergyPJ(latency, config_.sram.write_dynamic_power_per_bit_mW,
+                                                          pim_bit_width);
 
             if (i == process_times - 1) {
                 finish_ins_ = true;
@@ -128,9 +128,8 @@ void PimOutputUnit::processOutputSum(const pimsim::PimOutputInsPayload &payload)
 
     // sum
     double sum_latency = config_.result_adder.latency_cycle * period_ns_;
-    double sum_dynamic_power_mW =
-        config_.result_adder.dynamic_power_mW * sum_times_per_group * payload.activation_group_num;
-    result_adder_energy_counter_.addDynamicEnergyPJ(sum_latency, sum_dynamic_power_mW);
+    result_adder_energy_counter_.addDynamicEnergyPJ(sum_latency, config_.result_adder.dynamic_power_mW,
+                                                    sum_times_per_group * payload.activation_group_num);
 
     // need not wait for result adder finish, because result is written to memory instead of registers in result adder
     double sum_stall_ns = (config_.result_adder.latency_cycle - 1) * period_ns_;
@@ -151,9 +150,8 @@ void PimOutputUnit::processOutputSumMove(const pimsim::PimOutputInsPayload &payl
     int sum_times_per_group = payload.output_cnt_per_group;
 
     double sum_latency = config_.result_adder.latency_cycle * period_ns_;
-    double sum_dynamic_power_mW =
-        config_.result_adder.dynamic_power_mW * sum_times_per_group * payload.activation_group_num;
-    result_adder_energy_counter_.addDynamicEnergyPJ(sum_latency, sum_dynamic_power_mW);
+    result_adder_energy_counter_.addDynamicEnergyPJ(sum_latency, config_.result_adder.dynamic_power_mW,
+                                                    sum_times_per_group * payload.activation_group_num);
 
     // need not wait for result adder finish, because result is written to memory instead of registers in result adder
     double sum_stall_ns = (config_.result_adder.latency_cycle - 1) * period_ns_;
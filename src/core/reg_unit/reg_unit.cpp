@@ -91,6 +91,14 @@ std::string RegUnit::getGeneralRegistersString() const {
     return ss.str();
 }
 
+const std::array<int, GENERAL_REG_NUM> &RegUnit::getGeneralRegisters() const {
+    return general_regs_;
+}
+
+const std::array<int, SPECIAL_REG_NUM> &RegUnit::getSpecialRegisters() const {
+    return special_regs_;
+}
+
 void RegUnit::readValue() {
     const auto &read_req = read_req_port_.read();
     const auto &cur_write_req = write_req_port_.read();
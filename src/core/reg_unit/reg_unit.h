@@ -39,6 +39,9 @@ public:
 
     std::string getGeneralRegistersString() const;
 
+    [[nodiscard]] const std::array<int, GENERAL_REG_NUM>& getGeneralRegisters() const;
+    [[nodiscard]] const std::array<int, SPECIAL_REG_NUM>& getSpecialRegisters() const;
+
 private:
     void readValue();
     void writeValue();
@@ -29,12 +29,11 @@ ScalarUnit::ScalarUnit(const char *name, const pimsim::ScalarUnitConfig &config,
     SC_METHOD(finishRun)
     sensitive << finish_run_trigger_;
 
-    double scalar_functors_total_static_power_mW = config_.default_functor_static_power_mW;
+    energy_counter_.setStaticPowerMW(config_.default_functor_static_power_mW);
     for (const auto &scalar_functor_config : config_.functor_list) {
-        scalar_functors_total_static_power_mW += scalar_functor_config.static_power_mW;
+        energy_counter_.addStaticPowerMW(scalar_functor_config.static_power_mW);
         functor_config_map_.emplace(scalar_functor_config.inst_name, &scalar_functor_config);
     }
-    energy_counter_.setStaticPowerMW(scalar_functors_total_static_power_mW);
 }
 
 void ScalarUnit::checkScalarInst() {
@@ -59,8 +58,9 @@ void ScalarUnit::process() {
 
         // statistic energy
         auto functor_found = functor_config_map_.find(payload.op._to_string());
-        double dynamic_power_mW = functor_found == functor_config_map_.end() ? config_.default_functor_dynamic_power_mW
-                                                                             : functor_found->second->dynamic_power_mW;
+        const double &dynamic_power_mW = functor_found == functor_config_map_.end()
+                                             ? config_.default_functor_dynamic_power_mW
+                                             : functor_found->second->dynamic_power_mW;
         energy_counter_.addDynamicEnergyPJ(period_ns_, dynamic_power_mW);
 
         // execute instruction
@@ -104,7 +104,8 @@ void ScalarUnit::executeInst() {
 
             int address_byte = payload.src1_value + payload.offset;
             int size_byte = WORD_BYTE_SIZE;
-            auto write_data = IntToBytes(payload.src2_value, true);
+            auto write_data = data_mode_ == +DataMode::real_data ? IntToBytes(payload.src2_value, true)
+                                                                 : std::vector<unsigned char>{};
             local_memory_socket_.writeData(payload.ins, address_byte, size_byte, std::move(write_data));
         } else {
             reg_unit_socket_.writeRegister(executeAndWriteRegister(payload));
@@ -128,79 +129,69 @@ void ScalarUnit::executeInst() {
     }
 }
 
-RegUnitWriteRequest ScalarUnit::executeAndWriteRegister(const pimsim::ScalarInsPayload &payload) {
-    RegUnitWriteRequest reg_file_write_req{.reg_id = payload.dst_reg, .write_special_register = false};
-    switch (payload.op) {
+int ScalarUnit::calculate(ScalarOperator op, int src1_value, int src2_value) {
+    switch (op) {
         case ScalarOperator::add: {
-            reg_file_write_req.reg_value = payload.src1_value + payload.src2_value;
-            break;
+            return src1_value + src2_value;
         }
         case ScalarOperator::sub: {
-            reg_file_write_req.reg_value = payload.src1_value - payload.src2_value;
-            break;
+            return src1_value - src2_value;
         }
         case ScalarOperator::mul: {
-            reg_file_write_req.reg_value = payload.src1_value * payload.src2_value;
-            break;
+            return src1_value * src2_value;
         }
         case ScalarOperator::div: {
-            reg_file_write_req.reg_value = payload.src1_value / payload.src2_value;
-            break;
+            return src1_value / src2_value;
         }
         case ScalarOperator::sll: {
-            reg_file_write_req.reg_value = (payload.src1_value << payload.src2_value);
-            break;
+            return (src1_value << src2_value);
         }
         case ScalarOperator::srl: {
-            unsigned int result =
-                (static_cast<unsigned int>(payload.src1_value) >> static_cast<unsigned int>(payload.src2_value));
-            reg_file_write_req.reg_value = static_cast<int>(result);
-            break;
+            unsigned int result = (static_cast<unsigned int>(src1_value) >> static_cast<unsigned int>(src2_value));
+            return static_cast<int>(result);
         }
         case ScalarOperator::sra: {
-            reg_file_write_req.reg_value = (payload.src1_value >> payload.src2_value);
-            break;
+            return (src1_value >> src2_value);
         }
         case ScalarOperator::mod: {
-            reg_file_write_req.reg_value = payload.src1_value % payload.src2_value;
-            break;
+            return src1_value % src2_value;
         }
         case ScalarOperator::min: {
-            reg_file_write_req.reg_value = std::min(payload.src1_value, payload.src2_value);
-            break;
+            return std::min(src1_value, src2_value);
         }
         case ScalarOperator::max: {
-            reg_file_write_req.reg_value = std::max(payload.src1_value, payload.src2_value);
-            break;
+            return std::max(src1_value, src2_value);
         }
         case ScalarOperator::s_and: {
-            reg_file_write_req.reg_value = (payload.src1_value & payload.src2_value);
-            break;
+            return (src1_value & src2_value);
         }
         case ScalarOperator::s_or: {
-            reg_file_write_req.reg_value = (payload.src1_value | payload.src2_value);
-            break;
+            return (src1_value | src2_value);
         }
         case ScalarOperator::eq: {
-            reg_file_write_req.reg_value = (payload.src1_value == payload.src2_value) ? 1 : 0;
-            break;
+            return (src1_value == src2_value) ? 1 : 0;
         }
         case ScalarOperator::ne: {
-            reg_file_write_req.reg_value = (payload.src1_value != payload.src2_value) ? 1 : 0;
-            break;
+            return (src1_value != src2_value) ? 1 : 0;
         }
         case ScalarOperator::gt: {
-            reg_file_write_req.reg_value = (payload.src1_value > payload.src2_value) ? 1 : 0;
-            break;
+            return (src1_value > src2_value) ? 1 : 0;
         }
         case ScalarOperator::lt: {
-            reg_file_write_req.reg_value = (payload.src1_value < payload.src2_value) ? 1 : 0;
-            break;
+            return (src1_value < src2_value) ? 1 : 0;
         }
         case ScalarOperator::lui: {
-            reg_file_write_req.reg_value = (payload.src2_value << 16);
-            break;
+            return (src2_value << 16);
+        }
+        default: {
+            return 0;
         }
+    }
+}
+
+RegUnitWriteRequest ScalarUnit::executeAndWriteRegister(const pimsim::ScalarInsPayload &payload) {
+    RegUnitWriteRequest reg_file_write_req{.reg_id = payload.dst_reg, .write_special_register = false};
+    switch (payload.op) {
         case ScalarOperator::load: {
             int address_byte = payload.src1_value + payload.offset;
             int size_byte = WORD_BYTE_SIZE;
@@ -221,6 +212,7 @@ RegUnitWriteRequest ScalarUnit::executeAndWriteRegister(const pimsim::ScalarInsP
             break;
         }
         default: {
+            reg_file_write_req.reg_value = calculate(payload.op, payload.src1_value, payload.src2_value);
             break;
         }
     }
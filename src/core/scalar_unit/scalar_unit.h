@@ -27,6 +27,9 @@ public:
     void bindLocalMemoryUnit(LocalMemoryUnit* local_memory_unit);
     void bindRegUnit(RegUnit* reg_unit);
 
+    // result of the arithmetic and logic operators, which need no memory access
+    static int calculate(ScalarOperator op, int src1_value, int src2_value);
+
 private:
     [[noreturn]] void process();
     [[noreturn]] void executeInst();
@@ -35,13 +35,10 @@ SIMDUnit::SIMDUnit(const char* name, const SIMDUnitConfig& config, const SimConf
                                         &ins_config);
     }
 
-    double SIMD_functors_total_static_power_mW = 0.0;
     for (const auto& functor_config : config_.functor_list) {
-        SIMD_functors_total_static_power_mW += functor_config.static_power_per_functor_mW * functor_config.functor_cnt;
+        energy_counter_.addStaticPowerMW(functor_config.static_power_per_functor_mW, functor_config.functor_cnt);
         functor_config_map_.emplace(functor_config.name, &functor_config);
     }
-
-    energy_counter_.setStaticPowerMW(SIMD_functors_total_static_power_mW);
 }
 
 void SIMDUnit::checkSIMDInst() {
@@ -131,10 +128,9 @@ void SIMDUnit::processExecuteSubmodule() {
         LOG(fmt::format("simd execute start, pc: {}, batch: {}", payload.ins_info.ins.pc,
                         payload.batch_info.batch_num));
 
-        double dynamic_power_mW =
-            payload.ins_info.functor_config->dynamic_power_per_functor_mW * payload.batch_info.batch_vector_len;
         double latency = payload.ins_info.functor_config->latency_cycle * period_ns_;
-        energy_counter_.addDynamicEnergyPJ(latency, dynamic_power_mW);
+        energy_counter_.addDynamicEnergyPJ(latency, payload.ins_info.functor_config->dynamic_power_per_functor_mW,
+                                           payload.batch_info.batch_vector_len);
         wait(latency, SC_NS);
 
         waitAndStartNextSubmodule(payload, write_submodule_socket_);
@@ -248,15 +244,13 @@ std::pair<SIMDInstructionInfo, DataConflictPayload> SIMDUnit::decodeAndGetInfo(c
     DataConflictPayload conflict_payload{.ins_id = payload.ins.ins_id, .unit_type = ExecuteUnitType::simd};
     for (const auto& vector_input : vector_inputs) {
         int read_memory_id = local_memory_socket_.getLocalMemoryIdByAddress(vector_input.start_address_byte);
-        conflict_payload.read_memory_id.insert(read_memory_id);
-        conflict_payload.used_memory_id.insert(read_memory_id);
+        conflict_payload.addReadMemoryId(read_memory_id);
     }
     int write_memory_id = local_memory_socket_.getLocalMemoryIdByAddress(output.start_address_byte);
-    conflict_payload.write_memory_id.insert(write_memory_id);
-    conflict_payload.used_memory_id.insert(write_memory_id);
+    conflict_payload.addWriteMemoryId(write_memory_id);
 
     bool use_pipeline =
-        config_.pipeline && !SetsIntersection(conflict_payload.write_memory_id, conflict_payload.read_memory_id);
+        config_.pipeline && !conflict_payload.write_memory_id.intersects(conflict_payload.read_memory_id);
     SIMDInstructionInfo ins_info{.ins = payload.ins,
                                  .scalar_inputs = scalar_inputs,
                                  .vector_inputs = vector_inputs,
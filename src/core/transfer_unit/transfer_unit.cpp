@@ -4,6 +4,7 @@
 
 #include "transfer_unit.h"
 
+#include "core/core.h"
 #include "fmt/core.h"
 #include "network/switch.h"
 #include "systemc.h"
@@ -29,6 +30,15 @@ TransferUnit::TransferUnit(const char* name, const TransferUnitConfig& config, c
     SC_THREAD(processIssue)
     SC_THREAD(processReadSubmodule)
     SC_THREAD(processWriteSubmodule)
+    SC_THREAD(processLoadReorder)
+
+    for (int i = 0; i < config_.max_outstanding_load_cnt; i++) {
+        auto& lane = load_lanes_.emplace_back(std::make_unique<LoadLane>());
+        lane->id = i;
+        auto* lane_ptr = lane.get();
+        idle_load_lanes_.push_back(lane_ptr);
+        sc_core::sc_spawn([this, lane_ptr] { processLoadLane(lane_ptr); }, fmt::format("load_lane_{}", i).c_str());
+    }
 
     SC_METHOD(finishInstruction)
     sensitive << finish_ins_trigger_;
@@ -54,13 +64,15 @@ void TransferUnit::processIssue() {
         const auto& [ins_info, conflict_payload] = decodeAndGetInfo(payload);
         ports_.data_conflict_port_.write(conflict_payload);
 
-        if (payload.type == +TransferType::send) {
-            processSendHandshake(payload.dst_id, payload.transfer_id_tag);
+        if (payload.async) {
+            startAsyncLane(payload);
+        } else if (payload.type == +TransferType::send) {
+            processSendHandshake(payload.dst_id, payload.dst_cnt, payload.transfer_id_tag);
         } else if (payload.type == +TransferType::receive) {
             processReceiveHandshake(payload.src_id, payload.transfer_id_tag);
         }
 
-        int process_times = IntDivCeil(payload.size_byte, ins_info.batch_max_data_size_byte);
+        int process_times = payload.async ? 1 : IntDivCeil(payload.size_byte, ins_info.batch_max_data_size_byte);
         TransferSubmodulePayload submodule_payload{.ins_info = ins_info};
         for (int batch = 0; batch < process_times; batch++) {
             submodule_payload.batch_info = {
@@ -93,16 +105,24 @@ void TransferUnit::processReadSubmodule() {
         int address_byte = payload.ins_info.src_start_address_byte +
                            payload.batch_info.batch_num * payload.ins_info.batch_max_data_size_byte;
         int size_byte = payload.batch_info.batch_data_size_byte;
-        if (auto type = payload.ins_info.type; type == +TransferType::receive) {
-            processReceiveData(payload.ins_info.src_id);
-        } else if (type == +TransferType::global_load) {
-            processLoadGlobalData(payload.ins_info.ins, address_byte, size_byte);
+        if (auto type = payload.ins_info.type; type == +TransferType::global_load && !payload.ins_info.async) {
+            // the load lanes pass the batch on to the write submodule once it is loaded
+            startLoadLane(payload, address_byte);
         } else {
-            payload.batch_info.data = local_memory_socket_.readData(payload.ins_info.ins, address_byte, size_byte);
+            if (payload.ins_info.async) {
+                // nothing to read, the async lane does the transfer
+            } else if (type == +TransferType::receive) {
+                processReceiveData(payload.ins_info.src_id, payload.ins_info.transfer_id_tag);
+            } else {
+                payload.batch_info.data = local_memory_socket_.readView(payload.ins_info.ins, address_byte, size_byte);
+            }
+            // written after the global loads still in flight
+            while (next_load_write_sequence_ != next_load_issue_sequence_) {
+                wait(load_reorder_drain_);
+            }
+            waitAndStartNextSubmodule(payload, write_submodule_socket_);
         }
 
-        waitAndStartNextSubmodule(payload, write_submodule_socket_);
-
         if (!payload.batch_info.last_batch && payload.ins_info.use_pipeline) {
             cur_ins_next_batch_.notify();
         }
@@ -128,12 +148,16 @@ void TransferUnit::processWriteSubmodule() {
         int address_byte = payload.ins_info.dst_start_address_byte +
                            payload.batch_info.batch_num * payload.ins_info.batch_max_data_size_byte;
         int size_byte = payload.batch_info.batch_data_size_byte;
-        if (auto type = payload.ins_info.type; type == +TransferType::send) {
-            processSendData(payload.ins_info.dst_id, payload.ins_info.transfer_id_tag, address_byte, size_byte);
+        if (payload.ins_info.async) {
+            // nothing to write, the async lane does the transfer
+        } else if (auto type = payload.ins_info.type; type == +TransferType::send) {
+            processSendData(payload.ins_info.dst_id, payload.ins_info.dst_cnt, payload.ins_info.transfer_id_tag,
+                            address_byte, size_byte);
         } else if (type == +TransferType::global_store) {
-            processStoreGlobalData(payload.ins_info.ins, address_byte, size_byte);
+            processStoreGlobalData(payload.ins_info.ins, address_byte, size_byte, switch_socket_,
+                                   finish_write_global_);
         } else {
-            local_memory_socket_.writeData(payload.ins_info.ins, address_byte, size_byte, payload.batch_info.data);
+            local_memory_socket_.writeView(payload.ins_info.ins, address_byte, size_byte, payload.batch_info.data);
         }
 
         LOG(fmt::format("transfer write end, pc: {}, batch: {}", payload.ins_info.ins.pc,
@@ -152,6 +176,128 @@ void TransferUnit::processWriteSubmodule() {
     }
 }
 
+void TransferUnit::processLoadReorder() {
+    while (true) {
+        auto found = load_reorder_buffer_.find(next_load_write_sequence_);
+        if (found == load_reorder_buffer_.end()) {
+            wait(load_reorder_trigger_);
+            continue;
+        }
+
+        auto payload = std::move(found->second);
+        load_reorder_buffer_.erase(found);
+        waitAndStartNextSubmodule(payload, write_submodule_socket_);
+        next_load_write_sequence_++;
+        load_reorder_drain_.notify();
+    }
+}
+
+void TransferUnit::processLoadLane(LoadLane* lane) {
+    while (true) {
+        while (!lane->busy) {
+            wait(lane->start);
+        }
+
+        const auto& payload = lane->payload;
+        processLoadGlobalData(payload.ins_info.ins, lane->address_byte, payload.batch_info.batch_data_size_byte,
+                              lane->switch_socket, lane->finish_read_global);
+
+        load_reorder_buffer_.emplace(lane->sequence, std::move(lane->payload));
+        load_reorder_trigger_.notify();
+
+        lane->busy = false;
+        idle_load_lanes_.push_back(lane);
+        load_lane_release_.notify();
+    }
+}
+
+void TransferUnit::startLoadLane(const TransferSubmodulePayload& payload, int address_byte) {
+    while (idle_load_lanes_.empty()) {
+        wait(load_lane_release_);
+    }
+
+    auto* lane = idle_load_lanes_.back();
+    idle_load_lanes_.pop_back();
+    lane->busy = true;
+    lane->sequence = next_load_issue_sequence_++;
+    lane->address_byte = address_byte;
+    lane->payload = payload;
+    lane->start.notify();
+}
+
+void TransferUnit::processAsyncLane(AsyncLane* lane) {
+    while (true) {
+        while (!lane->busy) {
+            wait(lane->start);
+        }
+
+        const auto& payload = lane->payload;
+        LOG(fmt::format("async transfer start, pc: {}, lane: {}", payload.ins.pc, lane->id));
+        if (payload.type == +TransferType::send) {
+            processSendHandshake(payload.dst_id, payload.dst_cnt, payload.transfer_id_tag);
+            lane->memory_socket.readView(payload.ins, payload.src_address_byte, payload.size_byte);
+            processSendData(payload.dst_id, payload.dst_cnt, payload.transfer_id_tag, payload.dst_address_byte,
+                            payload.size_byte);
+        } else if (payload.type == +TransferType::receive) {
+            processReceiveHandshake(payload.src_id, payload.transfer_id_tag);
+            processReceiveData(payload.src_id, payload.transfer_id_tag);
+            lane->memory_socket.writeView(payload.ins, payload.dst_address_byte, payload.size_byte, {});
+        } else if (payload.type == +TransferType::global_load) {
+            processLoadGlobalData(payload.ins, payload.src_address_byte, payload.size_byte, lane->switch_socket,
+                                  lane->finish_global_access);
+            lane->memory_socket.writeView(payload.ins, payload.dst_address_byte, payload.size_byte, {});
+        } else if (payload.type == +TransferType::global_store) {
+            lane->memory_socket.readView(payload.ins, payload.src_address_byte, payload.size_byte);
+            processStoreGlobalData(payload.ins, payload.dst_address_byte, payload.size_byte, lane->switch_socket,
+                                   lane->finish_global_access);
+        }
+        LOG(fmt::format("async transfer end, pc: {}, lane: {}", payload.ins.pc, lane->id));
+
+        async_transfer_finish_cnt_[getAsyncTransferKey(payload)]++;
+        async_transfer_finish_.notify();
+
+        lane->busy = false;
+        idle_async_lanes_.push_back(lane);
+    }
+}
+
+void TransferUnit::startAsyncLane(const TransferInsPayload& payload) {
+    if (idle_async_lanes_.empty()) {
+        auto& lane = async_lanes_.emplace_back(std::make_unique<AsyncLane>());
+        lane->id = static_cast<int>(async_lanes_.size()) - 1;
+        lane->busy = true;
+        lane->payload = payload;
+        lane->memory_socket.bindLocalMemoryUnit(local_memory_unit_);
+        lane->switch_socket.bindSwitch(switch_);
+        auto* lane_ptr = lane.get();
+        sc_core::sc_spawn([this, lane_ptr] { processAsyncLane(lane_ptr); },
+                          fmt::format("async_lane_{}", lane->id).c_str());
+        return;
+    }
+
+    auto* lane = idle_async_lanes_.back();
+    idle_async_lanes_.pop_back();
+    lane->busy = true;
+    lane->payload = payload;
+    lane->start.notify();
+}
+
+std::pair<int, int> TransferUnit::getAsyncTransferKey(const TransferInsPayload& payload) const {
+    if (payload.type == +TransferType::send) {
+        return {payload.dst_id, payload.transfer_id_tag};
+    }
+    if (payload.type == +TransferType::receive) {
+        return {payload.src_id, payload.transfer_id_tag};
+    }
+    return {global_memory_switch_id_, payload.transfer_id_tag};
+}
+
+void TransferUnit::waitAsyncTransfers(const std::pair<int, int>& key, long long transfer_cnt) {
+    while (async_transfer_finish_cnt_[key] < transfer_cnt) {
+        wait(async_transfer_finish_);
+    }
+}
+
 void TransferUnit::finishInstruction() {
     ports_.finish_ins_port_.write(finish_ins_);
     ports_.finish_ins_id_port_.write(finish_ins_id_);
@@ -162,11 +308,16 @@ void TransferUnit::finishRun() {
 }
 
 void TransferUnit::bindLocalMemoryUnit(LocalMemoryUnit* local_memory_unit) {
+    local_memory_unit_ = local_memory_unit;
     local_memory_socket_.bindLocalMemoryUnit(local_memory_unit);
 }
 
 void TransferUnit::bindSwitch(Switch* switch_) {
+    this->switch_ = switch_;
     switch_socket_.bindSwitch(switch_);
+    for (auto& lane : load_lanes_) {
+        lane->switch_socket.bindSwitch(switch_);
+    }
     switch_->registerReceiveHandler(
         [this](const std::shared_ptr<NetworkPayload>& payload) { this->switchReceiveHandler(payload); });
 }
@@ -211,8 +362,17 @@ std::pair<TransferInstructionInfo, DataConflictPayload> TransferUnit::decodeAndG
                                          .batch_max_data_size_byte = payload.size_byte,
                                          .src_id = payload.src_id,
                                          .dst_id = payload.dst_id,
+                                         .dst_cnt = payload.dst_cnt,
                                          .transfer_id_tag = payload.transfer_id_tag,
-                                         .use_pipeline = false};
+                                         .use_pipeline = false,
+                                         .async = payload.async};
+        if (payload.type == +TransferType::global_load && !payload.async) {
+            // the next batch is issued as soon as a load lane takes this one
+            ins_info.use_pipeline = true;
+            if (config_.load_batch_size_byte > 0) {
+                ins_info.batch_max_data_size_byte = std::min(payload.size_byte, config_.load_batch_size_byte);
+            }
+        }
         DataConflictPayload conflict_payload{.ins_id = payload.ins.ins_id, .unit_type = ExecuteUnitType::transfer};
         if (payload.type == +TransferType::send || payload.type == +TransferType::global_store) {
             conflict_payload.addReadMemoryId(local_memory_socket_.getLocalMemoryIdByAddress(payload.src_address_byte));
@@ -224,154 +384,161 @@ std::pair<TransferInstructionInfo, DataConflictPayload> TransferUnit::decodeAndG
 }
 
 void TransferUnit::switchReceiveHandler(const std::shared_ptr<NetworkPayload>& payload) {
-    auto data_transfer_payload = payload->getRequestPayload<DataTransferInfo>();
+    const auto& data_transfer_payload = payload->data_transfer;
     auto remote_is_sender = data_transfer_payload->is_sender;
 
-    LOG(fmt::format(
-        "receive network message from {}, remote is {}, status: {}, sender_core_id: {}, expected_sender_core_id: {}",
-        payload->src_id, (remote_is_sender ? "sender" : "receiver"), data_transfer_payload->status._to_string(),
-        data_transfer_payload->sender_id, expected_sender_core_id_));
+    LOG(fmt::format("receive network message from {}, remote is {}, status: {}, sender_core_id: {}, id_tag: {}",
+                    payload->src_id, (remote_is_sender ? "sender" : "receiver"),
+                    data_transfer_payload->status._to_string(), data_transfer_payload->sender_id,
+                    data_transfer_payload->id_tag));
 
     if (remote_is_sender) {
         // remote core execute send inst to this core
-        auto status = data_transfer_payload->status;
-        auto sender_core_id = data_transfer_payload->sender_id;
-        if (status == +DataTransferStatus::sender_ready) {
-            // remote core send handshake
-            receiver_waiting_sender_map[sender_core_id] = data_transfer_payload->id_tag;
-            if (sender_core_id == expected_sender_core_id_) {
-                // this core already execute recv and is waiting for remote core
-                receiver_wait_sender_ready_.notify(SC_ZERO_TIME);
-            }
+        auto& channel = getTransferChannel(data_transfer_payload->sender_id, data_transfer_payload->id_tag);
+        if (auto status = data_transfer_payload->status; status == +DataTransferStatus::sender_ready) {
+            channel.sender_ready_cnt++;
         } else if (status == +DataTransferStatus::send_data) {
-            receiver_wait_data_ready_.notify(SC_ZERO_TIME);
+            channel.data_ready_cnt++;
         }
-    } else {
+        channel.update.notify(SC_ZERO_TIME);
+    } else if (data_transfer_payload->status == +DataTransferStatus::receiver_ready) {
         // remote core recv this core
-        auto receiver_core_id = data_transfer_payload->receiver_id;
-        if (receiver_core_id == expected_receiver_core_id_ &&
-            data_transfer_payload->id_tag == expected_transfer_id_tag_ &&
-            data_transfer_payload->status == +DataTransferStatus::receiver_ready) {
-            sender_wait_receiver_ready_.notify(SC_ZERO_TIME);
-        } else {
-            std::cerr << fmt::format("TransferUnit: send-recv not match") << std::endl;
-        }
+        auto& channel = getTransferChannel(data_transfer_payload->receiver_id, data_transfer_payload->id_tag);
+        channel.receiver_ready_cnt++;
+        channel.update.notify(SC_ZERO_TIME);
+    } else {
+        std::cerr << fmt::format("TransferUnit: send-recv not match") << std::endl;
     }
 }
 
-void TransferUnit::processSendHandshake(int dst_id, int transfer_id_tag) {
-    expected_receiver_core_id_ = dst_id;
-    expected_transfer_id_tag_ = transfer_id_tag;
-    LOG(fmt::format("send handshake start, dst_id: {}, transfer_id_tag: {}", dst_id, transfer_id_tag));
-
-    auto request = std::make_shared<DataTransferInfo>(DataTransferInfo{.sender_id = core_id_,
-                                                                       .receiver_id = dst_id,
-                                                                       .is_sender = true,
-                                                                       .status = DataTransferStatus::sender_ready,
-                                                                       .id_tag = transfer_id_tag,
-                                                                       .data_size_byte = 0});
-    auto network_payload = std::make_shared<NetworkPayload>(NetworkPayload{.src_id = core_id_,
-                                                                           .dst_id = dst_id,
-                                                                           .request_data_size_byte = 1,
-                                                                           .request_payload = request,
-                                                                           .response_data_size_byte = 1,
-                                                                           .response_payload = nullptr});
+TransferUnit::TransferChannel& TransferUnit::getTransferChannel(int core_id, int transfer_id_tag) {
+    return transfer_channels_[{core_id, transfer_id_tag}];
+}
+
+void TransferUnit::processSendHandshake(int dst_id, int dst_cnt, int transfer_id_tag) {
+    LOG(fmt::format("send handshake start, dst_id: {}, dst_cnt: {}, transfer_id_tag: {}", dst_id, dst_cnt,
+                    transfer_id_tag));
+
+    auto& payload_pool = core_->getPayloadPool();
+    auto request = payload_pool.make(DataTransferInfo{.sender_id = core_id_,
+                                                      .receiver_id = dst_id,
+                                                      .is_sender = true,
+                                                      .status = DataTransferStatus::sender_ready,
+                                                      .id_tag = transfer_id_tag,
+                                                      .data_size_byte = 0});
+    auto network_payload = payload_pool.make(NetworkPayload{.src_id = core_id_,
+                                                            .dst_id = dst_id,
+                                                            .dst_cnt = dst_cnt,
+                                                            .request_data_size_byte = 1,
+                                                            .data_transfer = request,
+                                                            .response_data_size_byte = 1});
     switch_socket_.send_message(network_payload);
-    wait(sender_wait_receiver_ready_);
 
-    LOG(fmt::format("send handshake end, dst_id: {}, transfer_id_tag: {}", dst_id, transfer_id_tag));
-    expected_receiver_core_id_ = -1;
-    expected_transfer_id_tag_ = -1;
+    for (int receiver_id = dst_id; receiver_id < dst_id + dst_cnt; receiver_id++) {
+        if (dst_cnt > 1 && receiver_id == core_id_) {
+            continue;
+        }
+        auto& channel = getTransferChannel(receiver_id, transfer_id_tag);
+        while (channel.receiver_ready_cnt == 0) {
+            wait(channel.update);
+        }
+        channel.receiver_ready_cnt--;
+    }
+
+    LOG(fmt::format("send handshake end, dst_id: {}, dst_cnt: {}, transfer_id_tag: {}", dst_id, dst_cnt,
+                    transfer_id_tag));
 }
 
-void TransferUnit::processSendData(int dst_id, int transfer_id_tag, int dst_address_byte, int data_size_byte) {
-    LOG(fmt::format("send data start, dst_id: {}, transfer_id_tag: {}", dst_id, transfer_id_tag));
-    auto resuest = std::make_shared<DataTransferInfo>(DataTransferInfo{.sender_id = core_id_,
-                                                                       .receiver_id = dst_id,
-                                                                       .is_sender = true,
-                                                                       .status = DataTransferStatus::send_data,
-                                                                       .id_tag = transfer_id_tag,
-                                                                       .data_size_byte = data_size_byte});
-    auto network_payload = std::make_shared<NetworkPayload>(NetworkPayload{.src_id = core_id_,
-                                                                           .dst_id = dst_id,
-                                                                           .request_data_size_byte = data_size_byte,
-                                                                           .request_payload = resuest,
-                                                                           .response_data_size_byte = 0,
-                                                                           .response_payload = nullptr});
+void TransferUnit::processSendData(int dst_id, int dst_cnt, int transfer_id_tag, int dst_address_byte,
+                                   int data_size_byte) {
+    LOG(fmt::format("send data start, dst_id: {}, dst_cnt: {}, transfer_id_tag: {}", dst_id, dst_cnt,
+                    transfer_id_tag));
+    auto& payload_pool = core_->getPayloadPool();
+    auto request = payload_pool.make(DataTransferInfo{.sender_id = core_id_,
+                                                      .receiver_id = dst_id,
+                                                      .is_sender = true,
+                                                      .status = DataTransferStatus::send_data,
+                                                      .id_tag = transfer_id_tag,
+                                                      .data_size_byte = data_size_byte});
+    auto network_payload = payload_pool.make(NetworkPayload{.src_id = core_id_,
+                                                            .dst_id = dst_id,
+                                                            .dst_cnt = dst_cnt,
+                                                            .request_data_size_byte = data_size_byte,
+                                                            .data_transfer = request,
+                                                            .response_data_size_byte = 0});
     switch_socket_.send_message(network_payload);
-    LOG(fmt::format("send data end, dst_id: {}, transfer_id_tag: {}", dst_id, transfer_id_tag));
+    LOG(fmt::format("send data end, dst_id: {}, dst_cnt: {}, transfer_id_tag: {}", dst_id, dst_cnt,
+                    transfer_id_tag));
 }
 
 void TransferUnit::processReceiveHandshake(int src_id, int transfer_id_tag) {
-    expected_sender_core_id_ = src_id;
     LOG(fmt::format("receive handshake start, src_id: {}, transfer_id_tag: {}", src_id, transfer_id_tag));
 
-    if (auto found = receiver_waiting_sender_map.find(src_id);
-        found == receiver_waiting_sender_map.end() || found->second != transfer_id_tag) {
-        wait(receiver_wait_sender_ready_);
+    auto& channel = getTransferChannel(src_id, transfer_id_tag);
+    while (channel.sender_ready_cnt == 0) {
+        wait(channel.update);
     }
-
-    expected_sender_core_id_ = -1;
+    channel.sender_ready_cnt--;
 }
 
-void TransferUnit::processReceiveData(int src_id) {
-    auto data_transfer_response =
-        std::make_shared<DataTransferInfo>(DataTransferInfo{.sender_id = src_id,
-                                                            .receiver_id = core_id_,
-                                                            .is_sender = false,
-                                                            .status = DataTransferStatus::receiver_ready,
-                                                            .id_tag = receiver_waiting_sender_map[src_id],
-                                                            .data_size_byte = 0});
-    auto network_payload = std::make_shared<NetworkPayload>(NetworkPayload{.src_id = core_id_,
-                                                                           .dst_id = src_id,
-                                                                           .request_data_size_byte = 1,
-                                                                           .request_payload = data_transfer_response,
-                                                                           .response_data_size_byte = 0,
-                                                                           .response_payload = nullptr});
-    int transfer_id_tag = receiver_waiting_sender_map[src_id];
-    receiver_waiting_sender_map[src_id] = -1;
+void TransferUnit::processReceiveData(int src_id, int transfer_id_tag) {
+    auto& payload_pool = core_->getPayloadPool();
+    auto data_transfer_response = payload_pool.make(DataTransferInfo{.sender_id = src_id,
+                                                                     .receiver_id = core_id_,
+                                                                     .is_sender = false,
+                                                                     .status = DataTransferStatus::receiver_ready,
+                                                                     .id_tag = transfer_id_tag,
+                                                                     .data_size_byte = 0});
+    auto network_payload = payload_pool.make(NetworkPayload{.src_id = core_id_,
+                                                            .dst_id = src_id,
+                                                            .request_data_size_byte = 1,
+                                                            .data_transfer = data_transfer_response,
+                                                            .response_data_size_byte = 0});
     switch_socket_.send_message(network_payload);
     LOG(fmt::format("receive handshake end, src_id: {}, transfer_id_tag: {}", src_id, transfer_id_tag));
 
-    LOG(fmt::format("receive data start, src_id: {}, transfer_id_tag: {}", src_id,
-                    receiver_waiting_sender_map[src_id]));
-    wait(receiver_wait_data_ready_);
+    LOG(fmt::format("receive data start, src_id: {}, transfer_id_tag: {}", src_id, transfer_id_tag));
+    auto& channel = getTransferChannel(src_id, transfer_id_tag);
+    while (channel.data_ready_cnt == 0) {
+        wait(channel.update);
+    }
+    channel.data_ready_cnt--;
     LOG(fmt::format("receive data end, src_id: {}, transfer_id_tag: {}", src_id, transfer_id_tag));
 }
 
-void TransferUnit::processLoadGlobalData(const InstructionPayload& ins, int src_address_byte, int data_size_byte) {
+void TransferUnit::processLoadGlobalData(const InstructionPayload& ins, int src_address_byte, int data_size_byte,
+                                         SwitchSocket& switch_socket, sc_core::sc_event& finish_access) {
     LOG(fmt::format("load global data start, pc: {}", ins.pc));
-    auto global_trans =
-        std::make_shared<MemoryAccessPayload>(MemoryAccessPayload{.ins = ins,
-                                                                  .access_type = MemoryAccessType::read,
-                                                                  .address_byte = src_address_byte,
-                                                                  .size_byte = data_size_byte,
-                                                                  .finish_access = finish_read_global_});
-    auto network_payload = std::make_shared<NetworkPayload>(NetworkPayload{.src_id = core_id_,
-                                                                           .dst_id = global_memory_switch_id_,
-                                                                           .request_data_size_byte = 1,
-                                                                           .request_payload = global_trans,
-                                                                           .response_data_size_byte = data_size_byte,
-                                                                           .response_payload = nullptr});
-    switch_socket_.load(network_payload);
+    auto& payload_pool = core_->getPayloadPool();
+    auto global_trans = payload_pool.make(MemoryAccessPayload{.ins = ins,
+                                                              .access_type = MemoryAccessType::read,
+                                                              .address_byte = src_address_byte,
+                                                              .size_byte = data_size_byte,
+                                                              .finish_access = finish_access});
+    auto network_payload = payload_pool.make(NetworkPayload{.src_id = core_id_,
+                                                            .dst_id = global_memory_switch_id_,
+                                                            .request_data_size_byte = 1,
+                                                            .memory_access = global_trans,
+                                                            .response_data_size_byte = data_size_byte});
+    switch_socket.load(network_payload);
     LOG(fmt::format("load global data end, pc: {}", ins.pc));
 }
 
-void TransferUnit::processStoreGlobalData(const InstructionPayload& ins, int dst_address_byte, int data_size_byte) {
+void TransferUnit::processStoreGlobalData(const InstructionPayload& ins, int dst_address_byte, int data_size_byte,
+                                          SwitchSocket& switch_socket, sc_core::sc_event& finish_access) {
     LOG(fmt::format("store global data start, pc: {}", ins.pc));
-    auto global_trans =
-        std::make_shared<MemoryAccessPayload>(MemoryAccessPayload{.ins = ins,
-                                                                  .access_type = MemoryAccessType::write,
-                                                                  .address_byte = dst_address_byte,
-                                                                  .size_byte = data_size_byte,
-                                                                  .finish_access = finish_write_global_});
-    auto network_payload = std::make_shared<NetworkPayload>(NetworkPayload{.src_id = core_id_,
-                                                                           .dst_id = global_memory_switch_id_,
-                                                                           .request_data_size_byte = data_size_byte,
-                                                                           .request_payload = global_trans,
-                                                                           .response_data_size_byte = 1,
-                                                                           .response_payload = nullptr});
-    switch_socket_.store(network_payload);
+    auto& payload_pool = core_->getPayloadPool();
+    auto global_trans = payload_pool.make(MemoryAccessPayload{.ins = ins,
+                                                              .access_type = MemoryAccessType::write,
+                                                              .address_byte = dst_address_byte,
+                                                              .size_byte = data_size_byte,
+                                                              .finish_access = finish_access});
+    auto network_payload = payload_pool.make(NetworkPayload{.src_id = core_id_,
+                                                            .dst_id = global_memory_switch_id_,
+                                                            .request_data_size_byte = data_size_byte,
+                                                            .memory_access = global_trans,
+                                                            .response_data_size_byte = 1});
+    switch_socket.store(network_payload);
     LOG(fmt::format("store global data end, pc: {}", ins.pc));
 }
 
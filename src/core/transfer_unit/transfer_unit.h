@@ -3,6 +3,11 @@
 //
 
 #pragma once
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "base_component/base_module.h"
 #include "base_component/fsm.h"
@@ -28,9 +33,11 @@ struct TransferInstructionInfo {
 
     int src_id{0};
     int dst_id{0};
+    int dst_cnt{1};
     int transfer_id_tag{0};
 
     bool use_pipeline{false};
+    bool async{false};  // the transfer goes on in an async lane, the instruction passes a single empty batch
 };
 
 struct TransferBatchInfo {
@@ -38,7 +45,7 @@ struct TransferBatchInfo {
     int batch_data_size_byte{0};
     bool first_batch{false};
     bool last_batch{false};
-    std::vector<unsigned char> data{};
+    DataView data{};  // borrowed from the source memory until the batch is written
 };
 
 struct TransferSubmodulePayload {
@@ -56,6 +63,7 @@ public:
     [[noreturn]] void processIssue();
     [[noreturn]] void processReadSubmodule();
     [[noreturn]] void processWriteSubmodule();
+    [[noreturn]] void processLoadReorder();
     void finishInstruction();
     void finishRun();
 
@@ -64,7 +72,55 @@ public:
     void bindLocalMemoryUnit(LocalMemoryUnit* local_memory_unit);
     void bindSwitch(Switch* switch_);
 
+    // async transfers are told apart by the other side, which is the other core or the global memory, and the
+    // transfer id tag
+    [[nodiscard]] std::pair<int, int> getAsyncTransferKey(const TransferInsPayload& payload) const;
+    // blocks until as many async transfers with the key have finished
+    void waitAsyncTransfers(const std::pair<int, int>& key, long long transfer_cnt);
+
 private:
+    // one outstanding global load, with its own socket and events so that the loads in flight do not wake each other
+    struct LoadLane {
+        int id{0};
+        bool busy{false};
+        long long sequence{0};
+        int address_byte{0};
+        TransferSubmodulePayload payload{};
+
+        SwitchSocket switch_socket{};
+        sc_core::sc_event start;
+        sc_core::sc_event finish_read_global;
+    };
+
+    [[noreturn]] void processLoadLane(LoadLane* lane);
+    void startLoadLane(const TransferSubmodulePayload& payload, int address_byte);
+
+    // one async transfer from the handshake to the last data, with its own sockets and events like LoadLane
+    struct AsyncLane {
+        int id{0};
+        bool busy{false};
+        TransferInsPayload payload{};
+
+        MemorySocket memory_socket{};
+        SwitchSocket switch_socket{};
+        sc_core::sc_event start;
+        sc_core::sc_event finish_global_access;
+    };
+
+    [[noreturn]] void processAsyncLane(AsyncLane* lane);
+    void startAsyncLane(const TransferInsPayload& payload);
+
+    // the handshakes of the sends and receives with the other core and the transfer id tag, kept as counts so that
+    // a message arriving before it is waited for is not lost
+    struct TransferChannel {
+        int sender_ready_cnt{0};    // on the receiver
+        int receiver_ready_cnt{0};  // on the sender
+        int data_ready_cnt{0};      // on the receiver
+        sc_core::sc_event update;
+    };
+
+    TransferChannel& getTransferChannel(int core_id, int transfer_id_tag);
+
     static void waitAndStartNextSubmodule(TransferSubmodulePayload& cur_payload,
                                           SubmoduleSocket<TransferSubmodulePayload>& next_submodule_socket);
 
@@ -72,14 +128,18 @@ private:
 
     void switchReceiveHandler(const std::shared_ptr<NetworkPayload>& payload);
 
-    void processSendHandshake(int dst_id, int transfer_id_tag);
-    void processSendData(int dst_id, int transfer_id_tag, int dst_address_byte, int data_size_byte);
+    // a multicast to 'dst_cnt' cores from 'dst_id' on hands shakes with all receivers at once, then sends the data
+    // once to all of them
+    void processSendHandshake(int dst_id, int dst_cnt, int transfer_id_tag);
+    void processSendData(int dst_id, int dst_cnt, int transfer_id_tag, int dst_address_byte, int data_size_byte);
 
     void processReceiveHandshake(int src_id, int transfer_id_tag);
-    void processReceiveData(int src_id);
+    void processReceiveData(int src_id, int transfer_id_tag);
 
-    void processLoadGlobalData(const InstructionPayload& ins, int src_address_byte, int data_size_byte);
-    void processStoreGlobalData(const InstructionPayload& ins, int dst_address_byte, int data_size_byte);
+    void processLoadGlobalData(const InstructionPayload& ins, int src_address_byte, int data_size_byte,
+                               SwitchSocket& switch_socket, sc_core::sc_event& finish_access);
+    void processStoreGlobalData(const InstructionPayload& ins, int dst_address_byte, int data_size_byte,
+                                SwitchSocket& switch_socket, sc_core::sc_event& finish_access);
 
 public:
     ExecuteUnitResponseIOPorts<TransferInsPayload> ports_;
@@ -91,6 +151,7 @@ private:
     sc_core::sc_signal<TransferInsPayload> transfer_fsm_out_;
     sc_core::sc_signal<FSMPayload<TransferInsPayload>> transfer_fsm_in_;
 
+    LocalMemoryUnit* local_memory_unit_{nullptr};
     MemorySocket local_memory_socket_;
 
     sc_core::sc_event cur_ins_next_batch_;
@@ -108,21 +169,31 @@ private:
     const int core_id_;
     SwitchSocket switch_socket_;
 
-    // -1 for not ready
-    int expected_receiver_core_id_ = -1;
-    int expected_sender_core_id_ = -1;  // execute recv and recv sender_core_id's send inst
-    int expected_transfer_id_tag_ = -1;
-
-    sc_event sender_wait_receiver_ready_;
-    sc_event receiver_wait_sender_ready_;
-    sc_event receiver_wait_data_ready_;
-
-    std::unordered_map<int, int> receiver_waiting_sender_map;  // <core_id_, transfer_id_tag>
+    std::map<std::pair<int, int>, TransferChannel> transfer_channels_;  // by other core id and transfer id tag
 
     // load store
     const int global_memory_switch_id_;
-    sc_event finish_read_global_;
     sc_event finish_write_global_;
+
+    // dma, the batches of global loads take the idle lanes in order and finish in any order, and the reorder buffer
+    // passes them on to the write submodule in the order they were issued
+    std::vector<std::unique_ptr<LoadLane>> load_lanes_;
+    std::vector<LoadLane*> idle_load_lanes_;
+    sc_event load_lane_release_;
+
+    std::unordered_map<long long, TransferSubmodulePayload> load_reorder_buffer_;  // by sequence of issue
+    sc_event load_reorder_trigger_;
+    sc_event load_reorder_drain_;
+    long long next_load_issue_sequence_{0};
+    long long next_load_write_sequence_{0};
+
+    // async transfers, the lanes are made the first time all of them are busy
+    std::vector<std::unique_ptr<AsyncLane>> async_lanes_;
+    std::vector<AsyncLane*> idle_async_lanes_;
+    Switch* switch_{nullptr};
+
+    std::map<std::pair<int, int>, long long> async_transfer_finish_cnt_;
+    sc_event async_transfer_finish_;
 };
 
 }  // namespace pimsim
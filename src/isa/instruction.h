@@ -34,6 +34,8 @@ struct Instruction {
     // transfer
     int offset_mask{0};
     int rd1{0}, rd2{0}, reg_id{0}, reg_len{0};
+    int sync{0};       // 1 for an asynchronous transfer
+    int multicast{0};  // 1 for a send to the cores from $rd1 to $rd1 + $rs2 - 1
 };
 
 DECLARE_TYPE_FROM_TO_JSON_FUNCTION_NON_INTRUSIVE(Instruction)
@@ -0,0 +1,167 @@
+//
+// Created by wyk on 2024/11/13.
+//
+
+#include "dram.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "fmt/core.h"
+
+namespace pimsim {
+
+DRAM::DRAM(const char *name, const DRAMConfig &config, const SimConfig &sim_config, Core *core, Clock *clk)
+    : MemoryHardware(name, sim_config, core, clk)
+    , config_(config)
+    , open_row_(config.channel_cnt * config.bank_cnt, -1)
+    , channel_release_time_(config.channel_cnt, 0.0)
+    , channel_refresh_index_(config.channel_cnt, 0)
+    , channel_busy_time_(config.channel_cnt, 0.0) {
+    if (data_mode_ == +DataMode::real_data) {
+        initialData();
+    }
+
+    static_energy_counter_.setStaticPowerMW(config_.static_power_mW);
+}
+
+sc_core::sc_time DRAM::accessAndGetDelay(MemoryAccessPayload &payload) {
+    if (payload.address_byte < 0 || payload.address_byte + payload.size_byte > config_.size_byte) {
+        std::cerr << fmt::format("Invalid memory access with ins NO.'{}': address overflow", payload.ins.pc)
+                  << std::endl;
+        return {0.0, sc_core::SC_NS};
+    }
+
+    const bool read = payload.access_type == +MemoryAccessType::read;
+    const double now = sc_core::sc_time_stamp().to_seconds() * 1e9;
+    double finish_time = now;
+
+    // the access is split at row boundaries, the rows of one access may be in different channels and banks
+    const int access_end = payload.address_byte + std::max(payload.size_byte, 1);
+    for (int row_begin = payload.address_byte; row_begin < access_end;) {
+        const int row_end = std::min(access_end, (row_begin / config_.row_size_byte + 1) * config_.row_size_byte);
+        const auto [channel, bank, row] = getRowLocation(row_begin);
+        const int burst_cnt = (row_end - 1) / config_.burst_size_byte - row_begin / config_.burst_size_byte + 1;
+
+        const double start_time = skipRefresh(channel, now);
+        const bool row_hit = (open_row_[bank] == row);
+        open_row_[bank] = row;
+        row_access_cnt_++;
+        if (row_hit) {
+            row_hit_cnt_++;
+        } else {
+            activate_energy_counter_.addDynamicEnergyPJ(
+                (config_.row_miss_latency_cycle - config_.row_hit_latency_cycle) * period_ns_,
+                config_.activate_dynamic_power_mW);
+        }
+
+        const int latency_cycle = row_hit ? config_.row_hit_latency_cycle : config_.row_miss_latency_cycle;
+        const double burst_start_time =
+            std::max(start_time + latency_cycle * period_ns_, channel_release_time_[channel]);
+        const double burst_time = burst_cnt * config_.burst_cycle * period_ns_;
+        channel_release_time_[channel] = burst_start_time + burst_time;
+        channel_busy_time_[channel] += burst_time;
+        if (read) {
+            read_energy_counter_.addDynamicEnergyPJ(burst_time, config_.read_dynamic_power_mW);
+        } else {
+            write_energy_counter_.addDynamicEnergyPJ(burst_time, config_.write_dynamic_power_mW);
+        }
+
+        finish_time = std::max(finish_time, burst_start_time + burst_time);
+        row_begin = row_end;
+    }
+
+    if (data_mode_ == +DataMode::real_data) {
+        if (read) {
+            payload.data = {data_.data() + payload.address_byte, payload.size_byte};
+        } else if (!payload.data.empty()) {
+            std::memmove(data_.data() + payload.address_byte, payload.data.data,
+                         std::min(payload.size_byte, payload.data.size_byte));
+        }
+    }
+
+    return {finish_time - now, sc_core::SC_NS};
+}
+
+DRAM::RowLocation DRAM::getRowLocation(int address_byte) const {
+    const int row_index = address_byte / config_.row_size_byte;
+    const int total_bank_cnt = config_.channel_cnt * config_.bank_cnt;
+    return {.channel = row_index % config_.channel_cnt,
+            .bank = row_index % total_bank_cnt,
+            .row = row_index / total_bank_cnt};
+}
+
+// each refresh takes the end of its interval
+double DRAM::skipRefresh(int channel, double time_ns) {
+    if (config_.refresh_interval_cycle == 0) {
+        return time_ns;
+    }
+
+    const double refresh_interval = config_.refresh_interval_cycle * period_ns_;
+    const double refresh_time = config_.refresh_cycle * period_ns_;
+    auto refresh_index = static_cast<long long>(time_ns / refresh_interval);
+    if (time_ns - refresh_index * refresh_interval >= refresh_interval - refresh_time) {
+        refresh_index++;
+        time_ns = refresh_index * refresh_interval;
+    }
+
+    if (refresh_index > channel_refresh_index_[channel]) {
+        for (int bank = channel; bank < open_row_.size(); bank += config_.channel_cnt) {
+            open_row_[bank] = -1;
+        }
+        channel_refresh_index_[channel] = refresh_index;
+    }
+    return time_ns;
+}
+
+bool DRAM::isRowHit(const MemoryAccessPayload &payload) const {
+    const auto location = getRowLocation(payload.address_byte);
+    return open_row_[location.bank] == location.row;
+}
+
+bool DRAM::hasBankStatistics() const {
+    return true;
+}
+
+void DRAM::addBankStatistics(MemoryBankReport &report) const {
+    report.row_hit_cnt = row_hit_cnt_;
+    report.row_access_cnt = row_access_cnt_;
+    report.channel_busy_time = channel_busy_time_;
+}
+
+void DRAM::initialData() {
+    data_ = MemoryImage{static_cast<std::size_t>(config_.size_byte), config_.has_image ? config_.image_file : ""};
+}
+
+EnergyReporter DRAM::getEnergyReporter() {
+    EnergyReporter mem_energy_reporter{static_energy_counter_};
+    mem_energy_reporter.addSubModule("activate", EnergyReporter{activate_energy_counter_});
+    mem_energy_reporter.addSubModule("read", EnergyReporter{read_energy_counter_});
+    mem_energy_reporter.addSubModule("write", EnergyReporter{write_energy_counter_});
+    return std::move(mem_energy_reporter);
+}
+
+int DRAM::getMemoryDataWidthByte(MemoryAccessType access_type) const {
+    return config_.burst_size_byte;
+}
+
+int DRAM::getMemorySizeByte() const {
+    return config_.size_byte;
+}
+
+std::vector<uint8_t> DRAM::readDataFunctionally(int address_byte, int size_byte) {
+    if (data_mode_ != +DataMode::real_data || address_byte < 0 || address_byte + size_byte > config_.size_byte) {
+        return {};
+    }
+    return {data_.data() + address_byte, data_.data() + address_byte + size_byte};
+}
+
+void DRAM::writeDataFunctionally(int address_byte, const std::vector<uint8_t> &data) {
+    if (data_mode_ != +DataMode::real_data || address_byte < 0 ||
+        address_byte + static_cast<int>(data.size()) > config_.size_byte) {
+        return;
+    }
+    std::copy(data.begin(), data.end(), data_.data() + address_byte);
+}
+
+}  // namespace pimsim
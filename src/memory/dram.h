@@ -0,0 +1,74 @@
+//
+// Created by wyk on 2024/11/13.
+//
+
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "../base_component/base_module.h"
+#include "../base_component/energy_counter.h"
+#include "../config/config.h"
+#include "../core/payload/payload.h"
+#include "memory_hardware.h"
+#include "memory_image.h"
+
+namespace pimsim {
+
+// DRAM timing with channels, banks, row buffers and refresh, see DRAMConfig. The access to a bank is serialized by
+// Memory, which holds the banks of an access until it finishes, while the data bus of each channel is shared here by
+// the accesses running in its banks.
+class DRAM : public MemoryHardware {
+public:
+    SC_HAS_PROCESS(DRAM);
+
+    DRAM(const char* name, const DRAMConfig& config, const SimConfig& sim_config, Core* core, Clock* clk);
+
+    sc_core::sc_time accessAndGetDelay(MemoryAccessPayload& payload) override;
+
+    EnergyReporter getEnergyReporter() override;
+
+    int getMemoryDataWidthByte(MemoryAccessType access_type) const override;
+    int getMemorySizeByte() const override;
+
+    std::vector<uint8_t> readDataFunctionally(int address_byte, int size_byte) override;
+    void writeDataFunctionally(int address_byte, const std::vector<uint8_t>& data) override;
+
+    [[nodiscard]] bool isRowHit(const MemoryAccessPayload& payload) const override;
+    [[nodiscard]] bool hasBankStatistics() const override;
+    void addBankStatistics(MemoryBankReport& report) const override;
+
+private:
+    struct RowLocation {
+        int channel;
+        int bank;  // over all channels, the bank index of Memory
+        int row;
+    };
+
+    [[nodiscard]] RowLocation getRowLocation(int address_byte) const;
+    // the first time from 'time_ns' on that the channel is not refreshing, the rows of the channel are closed by the
+    // refreshes passed since its last access
+    double skipRefresh(int channel, double time_ns);
+
+    void initialData();
+
+private:
+    const DRAMConfig& config_;
+
+    MemoryImage data_;
+
+    std::vector<int> open_row_;                 // by bank, -1 if closed
+    std::vector<double> channel_release_time_;  // ns, when the data bus of the channel is free
+    std::vector<long long> channel_refresh_index_;
+
+    int row_hit_cnt_{0};
+    int row_access_cnt_{0};
+    std::vector<double> channel_busy_time_;  // ns
+
+    EnergyCounter static_energy_counter_;
+    EnergyCounter activate_energy_counter_;
+    EnergyCounter read_energy_counter_;
+    EnergyCounter write_energy_counter_;
+};
+
+}  // namespace pimsim
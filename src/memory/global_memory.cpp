@@ -4,13 +4,27 @@
 
 #include "global_memory.h"
 
+#include <algorithm>
+
+#include "fmt/format.h"
+
 namespace pimsim {
 
 GlobalMemory::GlobalMemory(const char* name, const GlobalMemoryConfig& config, const SimConfig& sim_config, Clock* clk)
-    : memory_(name, config.hardware_config, config.addressing, sim_config, nullptr, clk)
+    : name_(name)
+    , service_engine_cnt_(config.service_engine_cnt)
     , switch_("GlobalMemoryConfig", sim_config, nullptr, clk, config.global_memory_switch_id) {
+    if (config.type == +GlobalMemoryType::dram) {
+        memory_ = std::make_shared<Memory>(name, config.dram_config, config.addressing, sim_config, nullptr, clk);
+    } else {
+        memory_ = std::make_shared<Memory>(name, config.hardware_config, config.addressing, sim_config, nullptr, clk);
+    }
     switch_.registerReceiveHandler(
         [this](const std::shared_ptr<NetworkPayload>& payload) { this->switchReceiveHandler(payload); });
+
+    for (int i = 0; i < service_engine_cnt_; i++) {
+        spawnServiceEngine();
+    }
 }
 
 void GlobalMemory::bindNetwork(Network* network) {
@@ -18,13 +32,74 @@ void GlobalMemory::bindNetwork(Network* network) {
 }
 
 EnergyReporter GlobalMemory::getEnergyReporter() {
-    return memory_.getEnergyReporter();
+    return memory_->getEnergyReporter();
+}
+
+std::vector<MemoryBankReport> GlobalMemory::getMemoryBankReports() const {
+    if (!memory_->isBanked()) {
+        return {};
+    }
+    return {memory_->getBankReport()};
+}
+
+MemoryQueueReport GlobalMemory::getQueueReport() const {
+    // the requests still waiting count until now
+    double queue_depth_time =
+        queue_depth_time_ + static_cast<double>(input_queue_.size()) *
+                                (sc_core::sc_time_stamp() - queue_depth_change_time_).to_seconds() * 1e9;
+    return {.name = name_,
+            .request_cnt = request_cnt_,
+            .max_queue_depth = max_queue_depth_,
+            .queue_depth_time = queue_depth_time,
+            .wait_time = wait_time_};
 }
 
 void GlobalMemory::switchReceiveHandler(const std::shared_ptr<NetworkPayload>& payload) {
-    auto global_trans = payload->getRequestPayload<MemoryAccessPayload>();
-    memory_.access(global_trans);
-    wait(global_trans->finish_access);
+    updateQueueDepthTime();
+    input_queue_.push_back({payload, sc_core::sc_time_stamp()});
+    request_cnt_++;
+    max_queue_depth_ = std::max(max_queue_depth_, static_cast<int>(input_queue_.size()));
+    if (service_engine_cnt_ == 0 && static_cast<int>(input_queue_.size()) > idle_engine_cnt_) {
+        spawnServiceEngine();
+    }
+    input_trigger_.notify();
+}
+
+// an engine is idle from its spawn on, so that the requests arriving before it runs are not given more engines
+void GlobalMemory::spawnServiceEngine() {
+    idle_engine_cnt_++;
+    sc_core::sc_spawn([this] { processServiceEngine(); },
+                      fmt::format("{}_service_engine_{}", name_, engine_cnt_++).c_str());
+}
+
+void GlobalMemory::processServiceEngine() {
+    while (true) {
+        while (input_queue_.empty()) {
+            wait(input_trigger_);
+        }
+
+        updateQueueDepthTime();
+        auto request = std::move(input_queue_.front());
+        input_queue_.pop_front();
+        idle_engine_cnt_--;
+        wait_time_ += (sc_core::sc_time_stamp() - request.arrival_time).to_seconds() * 1e9;
+
+        const auto& global_trans = request.payload->memory_access;
+        memory_->access(global_trans);
+        wait(global_trans->finish_access);
+
+        request.payload->served = true;
+        if (request.payload->finish_serve != nullptr) {
+            request.payload->finish_serve->notify(sc_core::SC_ZERO_TIME);
+        }
+        idle_engine_cnt_++;
+    }
+}
+
+void GlobalMemory::updateQueueDepthTime() {
+    auto now = sc_core::sc_time_stamp();
+    queue_depth_time_ += static_cast<double>(input_queue_.size()) * (now - queue_depth_change_time_).to_seconds() * 1e9;
+    queue_depth_change_time_ = now;
 }
 
 }  // namespace pimsim
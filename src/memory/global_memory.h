@@ -3,25 +3,60 @@
 //
 
 #pragma once
+#include <deque>
+#include <string>
+
 #include "memory.h"
 #include "network/switch.h"
 
 namespace pimsim {
 
+// The requests that arrive at the switch of the global memory wait in an input queue, and each of the service engines
+// takes the first one, accesses the memory and tells the requester that the request is served. So the switches that
+// hand the requests over never wait for the memory themselves. Without a limit on the engines, one is added whenever
+// a request would otherwise wait, and the requests only queue inside the memory.
 class GlobalMemory {
 public:
     GlobalMemory(const char* name, const GlobalMemoryConfig& config, const SimConfig& sim_config, Clock* clk);
 
     EnergyReporter getEnergyReporter();
+    // empty if the memory is not banked
+    std::vector<MemoryBankReport> getMemoryBankReports() const;
+    [[nodiscard]] MemoryQueueReport getQueueReport() const;
 
     void bindNetwork(Network* network);
 
 private:
+    struct PendingRequest {
+        std::shared_ptr<NetworkPayload> payload;
+        sc_core::sc_time arrival_time;
+    };
+
     void switchReceiveHandler(const std::shared_ptr<NetworkPayload>& payload);
 
+    void spawnServiceEngine();
+    [[noreturn]] void processServiceEngine();
+
+    // accumulates the queue depth up to now before the depth changes
+    void updateQueueDepthTime();
+
 private:
-    Memory memory_;
+    std::string name_;
+    const int service_engine_cnt_;
+
+    std::shared_ptr<Memory> memory_;
     Switch switch_;
+
+    std::deque<PendingRequest> input_queue_;
+    sc_core::sc_event input_trigger_;
+    int engine_cnt_{0};
+    int idle_engine_cnt_{0};
+
+    long long request_cnt_{0};
+    int max_queue_depth_{0};
+    double queue_depth_time_{0.0};  // ns
+    double wait_time_{0.0};         // ns
+    sc_core::sc_time queue_depth_change_time_{sc_core::SC_ZERO_TIME};
 };
 
 }  // namespace pimsim
@@ -4,6 +4,9 @@
 
 #include "memory.h"
 
+#include <algorithm>
+
+#include "dram.h"
 #include "ram.h"
 #include "reg_buffer.h"
 
@@ -13,6 +16,18 @@ Memory::Memory(const char *name, const RAMConfig &ram_config, const AddressSpace
                const SimConfig &sim_config, Core *core, Clock *clk)
     : BaseModule(name, sim_config, core, clk), addressing_(addressing) {
     hardware_ = std::make_shared<RAM>(name, ram_config, sim_config, core, clk);
+    setBanking(ram_config.bank_cnt, ram_config.port_cnt,
+               ram_config.bank_interleave_byte == 0 ? ram_config.width_byte : ram_config.bank_interleave_byte);
+    SC_THREAD(process);
+}
+
+Memory::Memory(const char *name, const DRAMConfig &dram_config, const AddressSpaceConfig &addressing,
+               const SimConfig &sim_config, Core *core, Clock *clk)
+    : BaseModule(name, sim_config, core, clk), addressing_(addressing), first_ready_(true) {
+    hardware_ = std::make_shared<DRAM>(name, dram_config, sim_config, core, clk);
+    // one bank of Memory for each bank of each channel, accesses are only limited by the banks
+    const int bank_cnt = dram_config.channel_cnt * dram_config.bank_cnt;
+    setBanking(bank_cnt, bank_cnt, dram_config.row_size_byte);
     SC_THREAD(process);
 }
 
@@ -20,11 +35,14 @@ Memory::Memory(const char *name, const RegBufferConfig &reg_buffer_config, const
                const SimConfig &sim_config, Core *core, Clock *clk)
     : BaseModule(name, sim_config, core, clk), addressing_(addressing) {
     hardware_ = std::make_shared<RegBuffer>(name, reg_buffer_config, sim_config, core, clk);
+    setBanking(1, 1, reg_buffer_config.size_byte);
     SC_THREAD(process);
 }
 
 void Memory::access(std::shared_ptr<MemoryAccessPayload> payload) {
-    access_queue_.emplace(std::move(payload));
+    auto bank_mask = getBankMask(payload->address_byte, payload->size_byte);
+    access_queue_.push_back(
+        PendingAccess{.payload = std::move(payload), .bank_mask = bank_mask, .arrival_time = sc_core::sc_time_stamp()});
     start_process_.notify();
 }
 
@@ -44,23 +62,159 @@ int Memory::getMemorySizeByte() const {
     return hardware_->getMemorySizeByte();
 }
 
+std::vector<uint8_t> Memory::readDataFunctionally(int address_byte, int size_byte) {
+    return hardware_->readDataFunctionally(address_byte, size_byte);
+}
+
+void Memory::writeDataFunctionally(int address_byte, const std::vector<uint8_t> &data) {
+    hardware_->writeDataFunctionally(address_byte, data);
+}
+
 EnergyReporter Memory::getEnergyReporter() {
     return hardware_->getEnergyReporter();
 }
 
+bool Memory::isBanked() const {
+    return bank_cnt_ > 1 || port_release_time_.size() > 1 || hardware_->hasBankStatistics();
+}
+
+MemoryBankReport Memory::getBankReport() const {
+    MemoryBankReport report{.name = getName(),
+                            .bank_conflict_cnt = bank_conflict_cnt_,
+                            .bank_stall_time = bank_stall_time_,
+                            .bank_busy_time = bank_busy_time_};
+    hardware_->addBankStatistics(report);
+    return report;
+}
+
+void Memory::setBanking(int bank_cnt, int port_cnt, int bank_interleave_byte) {
+    bank_cnt_ = bank_cnt;
+    bank_interleave_byte_ = bank_interleave_byte;
+    bank_release_time_.assign(bank_cnt, sc_core::SC_ZERO_TIME);
+    port_release_time_.assign(port_cnt, sc_core::SC_ZERO_TIME);
+    bank_busy_time_.assign(bank_cnt, 0.0);
+}
+
+uint64_t Memory::getBankMask(int address_byte, int size_byte) const {
+    if (bank_cnt_ == 1) {
+        return 1;
+    }
+    int first_block = address_byte / bank_interleave_byte_;
+    int last_block = (address_byte + std::max(size_byte, 1) - 1) / bank_interleave_byte_;
+    if (last_block - first_block + 1 >= bank_cnt_) {
+        return bank_cnt_ == 64 ? ~uint64_t{0} : (uint64_t{1} << bank_cnt_) - 1;
+    }
+    uint64_t bank_mask = 0;
+    for (int block = first_block; block <= last_block; block++) {
+        bank_mask |= uint64_t{1} << (block % bank_cnt_);
+    }
+    return bank_mask;
+}
+
+void Memory::startAccess(const PendingAccess &access, int port) {
+    auto now = sc_core::sc_time_stamp();
+    if (access.conflict) {
+        bank_conflict_cnt_++;
+        bank_stall_time_ += (now - access.arrival_time).to_seconds() * 1e9;
+    }
+
+    auto &payload = *access.payload;
+    sc_core::sc_time access_delay = hardware_->accessAndGetDelay(payload);
+    if (payload.ins.unit_type == +ExecuteUnitType::scalar) {
+        payload.finish_access.notify();
+        return;
+    }
+
+    auto release_time = now + access_delay;
+    port_release_time_[port] = release_time;
+    for (int bank = 0; bank < bank_cnt_; bank++) {
+        if ((access.bank_mask & (uint64_t{1} << bank)) != 0) {
+            bank_release_time_[bank] = release_time;
+            bank_busy_time_[bank] += access_delay.to_seconds() * 1e9;
+        }
+    }
+    payload.finish_access.notify(access_delay);
+}
+
+// Starts the waiting accesses that have their banks and a port free. The banks of a waiting access are kept from the
+// accesses behind it, so that accesses to the same bank start in the order they come. In the row hit pass of first
+// ready scheduling, row hits may go before earlier accesses, unless they touch the same data and one of them writes.
+void Memory::startWaitingAccesses(bool row_hit_only) {
+    auto now = sc_core::sc_time_stamp();
+    uint64_t held_bank_mask = 0;
+    for (int bank = 0; bank < bank_cnt_; bank++) {
+        if (bank_release_time_[bank] > now) {
+            held_bank_mask |= uint64_t{1} << bank;
+        }
+    }
+
+    auto is_dependent = [](const PendingAccess &earlier, const PendingAccess &later) {
+        const auto &a = *earlier.payload, &b = *later.payload;
+        return (a.access_type == +MemoryAccessType::write || b.access_type == +MemoryAccessType::write) &&
+               a.address_byte < b.address_byte + b.size_byte && b.address_byte < a.address_byte + a.size_byte;
+    };
+
+    for (auto it = access_queue_.begin(); it != access_queue_.end();) {
+        auto port = std::find_if(port_release_time_.begin(), port_release_time_.end(),
+                                 [&](const sc_core::sc_time &release_time) { return release_time <= now; });
+        if (port == port_release_time_.end()) {
+            break;
+        }
+
+        bool ready = (it->bank_mask & held_bank_mask) == 0;
+        if (ready && row_hit_only) {
+            ready = hardware_->isRowHit(*it->payload) &&
+                    std::none_of(access_queue_.begin(), it,
+                                 [&](const PendingAccess &earlier) { return is_dependent(earlier, *it); });
+        }
+        if (!ready) {
+            if ((it->bank_mask & held_bank_mask) != 0) {
+                it->conflict = true;
+            }
+            if (!row_hit_only) {
+                held_bank_mask |= it->bank_mask;
+            }
+            ++it;
+            continue;
+        }
+
+        startAccess(*it, static_cast<int>(port - port_release_time_.begin()));
+        if (*port > now) {
+            held_bank_mask |= it->bank_mask;
+        }
+        it = access_queue_.erase(it);
+    }
+}
+
 void Memory::process() {
     while (true) {
         while (access_queue_.empty()) {
             wait(start_process_);
         }
-        auto payload_ptr = access_queue_.front();
-        access_queue_.pop();
 
-        sc_core::sc_time access_delay = hardware_->accessAndGetDelay(*payload_ptr);
-        if (payload_ptr->ins.unit_type != +ExecuteUnitType::scalar) {
-            wait(access_delay);
+        if (first_ready_) {
+            startWaitingAccesses(true);
+        }
+        startWaitingAccesses(false);
+        if (access_queue_.empty()) {
+            continue;
+        }
+
+        // wait for a bank or port to be released, or for a new access
+        auto now = sc_core::sc_time_stamp();
+        auto next_release_time = now;
+        auto update_next_release_time = [&](const sc_core::sc_time &release_time) {
+            if (release_time > now && (next_release_time == now || release_time < next_release_time)) {
+                next_release_time = release_time;
+            }
+        };
+        std::for_each(bank_release_time_.begin(), bank_release_time_.end(), update_next_release_time);
+        std::for_each(port_release_time_.begin(), port_release_time_.end(), update_next_release_time);
+        if (next_release_time > now) {
+            wait(next_release_time - now, start_process_);
+        } else {
+            wait(start_process_);
         }
-        payload_ptr->finish_access.notify();
     }
 }
 
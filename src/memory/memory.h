@@ -3,7 +3,8 @@
 //
 
 #pragma once
-#include <queue>
+#include <cstdint>
+#include <deque>
 
 #include "../base_component/base_module.h"
 #include "../config/config.h"
@@ -12,6 +13,8 @@
 
 namespace pimsim {
 
+// Serves the accesses of a memory in the order they come, except that an access whose banks are free may start
+// before earlier accesses that wait for other banks. An access holds its banks and a port until it finishes.
 class Memory : public BaseModule {
 public:
     SC_HAS_PROCESS(Memory);
@@ -19,6 +22,10 @@ public:
     Memory(const char* name, const RAMConfig& ram_config, const AddressSpaceConfig& addressing,
                 const SimConfig& sim_config, Core* core, Clock* clk);
 
+    // served first ready, first come first served, see DRAM
+    Memory(const char* name, const DRAMConfig& dram_config, const AddressSpaceConfig& addressing,
+           const SimConfig& sim_config, Core* core, Clock* clk);
+
     Memory(const char* name, const RegBufferConfig& reg_buffer_config, const AddressSpaceConfig& addressing,
                 const SimConfig& sim_config, Core* core, Clock* clk);
 
@@ -29,18 +36,48 @@ public:
     [[nodiscard]] int getMemoryDataWidthByte(MemoryAccessType access_type) const;
     [[nodiscard]] int getMemorySizeByte() const;
 
+    std::vector<uint8_t> readDataFunctionally(int address_byte, int size_byte);
+    void writeDataFunctionally(int address_byte, const std::vector<uint8_t>& data);
+
     EnergyReporter getEnergyReporter() override;
 
+    // whether the memory has more than one bank or port, only then the bank report is of interest
+    [[nodiscard]] bool isBanked() const;
+    [[nodiscard]] MemoryBankReport getBankReport() const;
+
 private:
+    struct PendingAccess {
+        std::shared_ptr<MemoryAccessPayload> payload;
+        uint64_t bank_mask;
+        sc_core::sc_time arrival_time;
+        bool conflict{false};
+    };
+
     [[noreturn]] void process();
 
+    void setBanking(int bank_cnt, int port_cnt, int bank_interleave_byte);
+    [[nodiscard]] uint64_t getBankMask(int address_byte, int size_byte) const;
+    void startWaitingAccesses(bool row_hit_only);
+    void startAccess(const PendingAccess& access, int port);
+
 private:
     const AddressSpaceConfig& addressing_;
+    const bool first_ready_{false};
 
-    std::queue<std::shared_ptr<MemoryAccessPayload>> access_queue_;
+    std::deque<PendingAccess> access_queue_;
     std::shared_ptr<MemoryHardware> hardware_;
 
     sc_core::sc_event start_process_;
+
+    // banking
+    int bank_cnt_{1};
+    int bank_interleave_byte_{1};
+    std::vector<sc_core::sc_time> bank_release_time_;
+    std::vector<sc_core::sc_time> port_release_time_;
+
+    int bank_conflict_cnt_{0};
+    double bank_stall_time_{0.0};         // ns
+    std::vector<double> bank_busy_time_;  // ns
 };
 
 }  // namespace pimsim
@@ -3,6 +3,9 @@
 //
 
 #pragma once
+#include <cstdint>
+#include <vector>
+
 #include "../base_component/base_module.h"
 #include "../core/payload/payload.h"
 
@@ -19,6 +22,21 @@ public:
 
     [[nodiscard]] virtual int getMemoryDataWidthByte(MemoryAccessType access_type) const = 0;
     [[nodiscard]] virtual int getMemorySizeByte() const = 0;
+
+    // untimed accesses without energy, for functional fast-forwarding. data is only kept in real data mode
+    virtual std::vector<uint8_t> readDataFunctionally(int address_byte, int size_byte) = 0;
+    virtual void writeDataFunctionally(int address_byte, const std::vector<uint8_t>& data) = 0;
+
+    // whether the access would hit an open row, such accesses are served first
+    [[nodiscard]] virtual bool isRowHit(const MemoryAccessPayload& payload) const {
+        return false;
+    }
+
+    // statistics of the hardware added to the bank report of the memory
+    [[nodiscard]] virtual bool hasBankStatistics() const {
+        return false;
+    }
+    virtual void addBankStatistics(MemoryBankReport& report) const {}
 };
 
 }  // namespace pimsim
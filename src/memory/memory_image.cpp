@@ -0,0 +1,90 @@
+//
+// Created by wyk on 2024/11/13.
+//
+
+#include "memory_image.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+#include "fmt/format.h"
+
+namespace pimsim {
+
+MemoryImage::MemoryImage(std::size_t size_byte, const std::string& image_file) : size_byte_(size_byte) {
+    if (size_byte_ == 0) {
+        return;
+    }
+
+    void* data = mmap(nullptr, size_byte_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (data == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+    data_ = static_cast<uint8_t*>(data);
+
+    if (image_file.empty()) {
+        return;
+    }
+    int fd = open(image_file.c_str(), O_RDONLY);
+    struct stat file_stat {};
+    if (fd < 0 || fstat(fd, &file_stat) != 0) {
+        std::cerr << fmt::format("Can not open memory image file '{}', the memory starts with zeros", image_file)
+                  << std::endl;
+        if (fd >= 0) {
+            close(fd);
+        }
+        return;
+    }
+
+    // the last partial page of the file reads zeros beyond the end of the file, like the rest of the memory
+    auto map_size = std::min(size_byte_, static_cast<std::size_t>(file_stat.st_size));
+    bool mapped =
+        map_size == 0 || mmap(data_, map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0) != MAP_FAILED;
+    close(fd);
+    if (!mapped) {
+        release();
+        throw std::runtime_error(fmt::format("MemoryImage: map image file '{}' failed", image_file));
+    }
+}
+
+MemoryImage::~MemoryImage() {
+    release();
+}
+
+MemoryImage::MemoryImage(MemoryImage&& another) noexcept
+    : data_(std::exchange(another.data_, nullptr)), size_byte_(std::exchange(another.size_byte_, 0)) {}
+
+MemoryImage& MemoryImage::operator=(MemoryImage&& another) noexcept {
+    if (this != &another) {
+        release();
+        data_ = std::exchange(another.data_, nullptr);
+        size_byte_ = std::exchange(another.size_byte_, 0);
+    }
+    return *this;
+}
+
+uint8_t* MemoryImage::data() const {
+    return data_;
+}
+
+std::size_t MemoryImage::size() const {
+    return size_byte_;
+}
+
+void MemoryImage::release() {
+    if (data_ != nullptr) {
+        munmap(data_, size_byte_);
+        data_ = nullptr;
+        size_byte_ = 0;
+    }
+}
+
+}  // namespace pimsim
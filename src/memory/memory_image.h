@@ -0,0 +1,37 @@
+//
+// Created by wyk on 2024/11/13.
+//
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace pimsim {
+
+// Backing store of the data of a memory. The whole size is mapped as anonymous memory, so pages are only allocated
+// when first written, and the image file is mapped copy-on-write over its beginning, so only the touched pages of the
+// image are read and memories loading the same image share its unmodified pages.
+class MemoryImage {
+public:
+    MemoryImage() = default;
+    MemoryImage(std::size_t size_byte, const std::string& image_file);
+    ~MemoryImage();
+
+    MemoryImage(const MemoryImage&) = delete;
+    MemoryImage& operator=(const MemoryImage&) = delete;
+    MemoryImage(MemoryImage&& another) noexcept;
+    MemoryImage& operator=(MemoryImage&& another) noexcept;
+
+    [[nodiscard]] uint8_t* data() const;
+    [[nodiscard]] std::size_t size() const;
+
+private:
+    void release();
+
+private:
+    uint8_t* data_{nullptr};
+    std::size_t size_byte_{0};
+};
+
+}  // namespace pimsim
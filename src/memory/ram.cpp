@@ -4,6 +4,9 @@
 
 #include "ram.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "../../packages/fmt/include/fmt/core.h"
 #include "../util/util.h"
 
@@ -33,15 +36,18 @@ sc_core::sc_time RAM::accessAndGetDelay(pimsim::MemoryAccessPayload &payload) {
         read_energy_counter_.addDynamicEnergyPJ(latency, config_.read_dynamic_power_mW);
 
         if (data_mode_ == +DataMode::real_data) {
-            payload.data.resize(payload.size_byte);
-            std::copy_n(data_.begin() + payload.address_byte, payload.size_byte, payload.data.begin());
+            payload.data = {data_.data() + payload.address_byte, payload.size_byte};
         }
     } else {
         latency = process_times * config_.write_latency_cycle * period_ns_;
         write_energy_counter_.addDynamicEnergyPJ(latency, config_.write_dynamic_power_mW);
 
         if (data_mode_ == +DataMode::real_data) {
-            std::copy(payload.data.begin(), payload.data.end(), data_.begin() + payload.address_byte);
+            if (!payload.data.empty()) {
+                // a transfer inside one memory may overlap
+                std::memmove(data_.data() + payload.address_byte, payload.data.data,
+                             std::min(payload.size_byte, payload.data.size_byte));
+            }
         }
     }
 
@@ -49,13 +55,7 @@ sc_core::sc_time RAM::accessAndGetDelay(pimsim::MemoryAccessPayload &payload) {
 }
 
 void RAM::initialData() {
-    data_ = std::vector<uint8_t>(config_.size_byte, 0);
-    if (config_.has_image) {
-        std::ifstream ifs;
-        ifs.open(config_.image_file, std::ios::in | std::ios::binary);
-        ifs.read(reinterpret_cast<char *>(data_.data()), config_.size_byte);
-        ifs.close();
-    }
+    data_ = MemoryImage{static_cast<std::size_t>(config_.size_byte), config_.has_image ? config_.image_file : ""};
 }
 
 EnergyReporter RAM::getEnergyReporter() {
@@ -73,4 +73,19 @@ int RAM::getMemorySizeByte() const {
     return config_.size_byte;
 }
 
+std::vector<uint8_t> RAM::readDataFunctionally(int address_byte, int size_byte) {
+    if (data_mode_ != +DataMode::real_data || address_byte < 0 || address_byte + size_byte > config_.size_byte) {
+        return {};
+    }
+    return {data_.data() + address_byte, data_.data() + address_byte + size_byte};
+}
+
+void RAM::writeDataFunctionally(int address_byte, const std::vector<uint8_t> &data) {
+    if (data_mode_ != +DataMode::real_data || address_byte < 0 ||
+        address_byte + static_cast<int>(data.size()) > config_.size_byte) {
+        return;
+    }
+    std::copy(data.begin(), data.end(), data_.data() + address_byte);
+}
+
 }  // namespace pimsim
@@ -4,6 +4,9 @@
 
 #include "reg_buffer.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "fmt/core.h"
 #include "util/util.h"
 
@@ -30,12 +33,10 @@ sc_core::sc_time RegBuffer::accessAndGetDelay(pimsim::MemoryAccessPayload &paylo
         int read_data_size_byte =
             (payload.size_byte <= config_.read_max_width_byte) ? payload.size_byte : config_.read_max_width_byte;
         int read_data_unit_cnt = IntDivCeil(read_data_size_byte, config_.rw_min_unit_byte);
-        double read_dynamic_power_mW = config_.rw_dynamic_power_per_unit_mW * read_data_unit_cnt;
-        read_energy_counter_.addDynamicEnergyPJ(period_ns_, read_dynamic_power_mW);
+        read_energy_counter_.addDynamicEnergyPJ(period_ns_, config_.rw_dynamic_power_per_unit_mW, read_data_unit_cnt);
 
         if (data_mode_ == +DataMode::real_data) {
-            payload.data.resize(payload.size_byte);
-            std::copy_n(data_.begin() + payload.address_byte, payload.size_byte, payload.data.begin());
+            payload.data = {data_.data() + payload.address_byte, payload.size_byte};
         }
 
         return {0, sc_core::SC_NS};
@@ -43,11 +44,15 @@ sc_core::sc_time RegBuffer::accessAndGetDelay(pimsim::MemoryAccessPayload &paylo
         int write_data_size_byte =
             (payload.size_byte <= config_.write_max_width_byte) ? payload.size_byte : config_.write_max_width_byte;
         int write_data_unit_cnt = IntDivCeil(write_data_size_byte, config_.rw_min_unit_byte);
-        double write_dynamic_power_mW = config_.rw_dynamic_power_per_unit_mW * write_data_unit_cnt;
-        write_energy_counter_.addDynamicEnergyPJ(period_ns_, write_dynamic_power_mW);
+        write_energy_counter_.addDynamicEnergyPJ(period_ns_, config_.rw_dynamic_power_per_unit_mW,
+                                                 write_data_unit_cnt);
 
         if (data_mode_ == +DataMode::real_data) {
-            std::copy(payload.data.begin(), payload.data.end(), data_.begin() + payload.address_byte);
+            if (!payload.data.empty()) {
+                // a transfer inside one memory may overlap
+                std::memmove(data_.data() + payload.address_byte, payload.data.data,
+                             std::min(payload.size_byte, payload.data.size_byte));
+            }
         }
 
         return {period_ns_, sc_core::SC_NS};
@@ -62,13 +67,7 @@ EnergyReporter RegBuffer::getEnergyReporter() {
 }
 
 void RegBuffer::initialData() {
-    data_ = std::vector<uint8_t>(config_.size_byte, 0);
-    if (config_.has_image) {
-        std::ifstream ifs;
-        ifs.open(config_.image_file, std::ios::in | std::ios::binary);
-        ifs.read(reinterpret_cast<char *>(data_.data()), config_.size_byte);
-        ifs.close();
-    }
+    data_ = MemoryImage{static_cast<std::size_t>(config_.size_byte), config_.has_image ? config_.image_file : ""};
 }
 
 int RegBuffer::getMemoryDataWidthByte(MemoryAccessType access_type) const {
@@ -79,4 +78,19 @@ int RegBuffer::getMemorySizeByte() const {
     return config_.size_byte;
 }
 
+std::vector<uint8_t> RegBuffer::readDataFunctionally(int address_byte, int size_byte) {
+    if (data_mode_ != +DataMode::real_data || address_byte < 0 || address_byte + size_byte > config_.size_byte) {
+        return {};
+    }
+    return {data_.data() + address_byte, data_.data() + address_byte + size_byte};
+}
+
+void RegBuffer::writeDataFunctionally(int address_byte, const std::vector<uint8_t> &data) {
+    if (data_mode_ != +DataMode::real_data || address_byte < 0 ||
+        address_byte + static_cast<int>(data.size()) > config_.size_byte) {
+        return;
+    }
+    std::copy(data.begin(), data.end(), data_.data() + address_byte);
+}
+
 }  // namespace pimsim
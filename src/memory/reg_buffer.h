@@ -6,6 +6,7 @@
 #include "base_component/base_module.h"
 #include "core/payload/payload.h"
 #include "memory_hardware.h"
+#include "memory_image.h"
 
 namespace pimsim {
 
@@ -22,13 +23,16 @@ public:
     int getMemoryDataWidthByte(MemoryAccessType access_type) const override;
     int getMemorySizeByte() const override;
 
+    std::vector<uint8_t> readDataFunctionally(int address_byte, int size_byte) override;
+    void writeDataFunctionally(int address_byte, const std::vector<uint8_t>& data) override;
+
 private:
     void initialData();
 
 private:
     const RegBufferConfig& config_;
 
-    std::vector<uint8_t> data_;
+    MemoryImage data_;
 
     EnergyCounter static_energy_counter_;
     EnergyCounter read_energy_counter_;
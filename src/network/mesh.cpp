@@ -0,0 +1,132 @@
+//
+// Created by wyk on 2024/11/13.
+//
+
+#include "mesh.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+
+#include "fmt/format.h"
+
+namespace pimsim {
+
+Mesh::Mesh(const MeshConfig& config, const SimConfig& sim_config)
+    : config_(config)
+    , sim_config_(sim_config)
+    , router_cnt_(config.getRouterCount())
+    , node_cnt_(config.getRouterCount() + 1)
+    , links_(router_cnt_ * direction_cnt + node_cnt_ * 2) {}
+
+sc_core::sc_time Mesh::transferAndGetDelay(int src_id, int dst_id, int flit_cnt, const sc_core::sc_time& start_time) {
+    if (flit_cnt <= 0) {
+        return sc_core::SC_ZERO_TIME;
+    }
+    getRoute(getNode(src_id), getNode(dst_id), route_);
+
+    sc_core::sc_time period{sim_config_.period_ns, sc_core::SC_NS};
+    auto flit_time = period * flit_cnt;
+    auto router_time = period * config_.router_pipeline_cycle;
+    auto link_time = period * config_.link_latency_cycle;
+
+    auto head_time = start_time;
+    for (int i = 0; i < route_.size(); i++) {
+        auto& link = links_[route_[i]];
+        auto link_start_time = std::max(head_time, link.release_time);
+        link.release_time = link_start_time + flit_time;
+        link.flit_cnt += flit_cnt;
+        link.busy_time += flit_time;
+        link.stall_time += link_start_time - head_time;
+
+        // the injection port leads into the first router, each link between routers into the next one
+        if (i == 0) {
+            head_time = link_start_time + router_time;
+        } else if (i < route_.size() - 1) {
+            head_time = link_start_time + link_time + router_time;
+        }
+    }
+    // from the start of the transfer to the tail flit leaving the ejection port
+    return links_[route_.back()].release_time - start_time;
+}
+
+double Mesh::getLatencyCycle(int src_id, int dst_id) const {
+    int hop_cnt = getHopCount(src_id, dst_id);
+    return (hop_cnt + 1) * config_.router_pipeline_cycle + hop_cnt * config_.link_latency_cycle + 1;
+}
+
+double Mesh::getEnergyPJ(int src_id, int dst_id) const {
+    int hop_cnt = getHopCount(src_id, dst_id);
+    return hop_cnt * config_.link_energy_pJ + (hop_cnt + 1) * config_.router_energy_pJ;
+}
+
+int Mesh::getHopCount(int src_id, int dst_id) const {
+    int src_router = getRouter(getNode(src_id));
+    int dst_router = getRouter(getNode(dst_id));
+    return std::abs(src_router % config_.x_cnt - dst_router % config_.x_cnt) +
+           std::abs(src_router / config_.x_cnt - dst_router / config_.x_cnt);
+}
+
+std::vector<NetworkLinkReport> Mesh::getLinkReports() const {
+    std::vector<NetworkLinkReport> link_reports;
+    for (int i = 0; i < links_.size(); i++) {
+        if (links_[i].flit_cnt > 0) {
+            link_reports.push_back({.name = getLinkName(i),
+                                    .flit_cnt = links_[i].flit_cnt,
+                                    .busy_time = links_[i].busy_time.to_seconds() * 1e9,
+                                    .stall_time = links_[i].stall_time.to_seconds() * 1e9});
+        }
+    }
+    return link_reports;
+}
+
+int Mesh::getNode(int switch_id) const {
+    if (switch_id < 0) {
+        return router_cnt_;
+    }
+    if (switch_id >= router_cnt_) {
+        throw std::runtime_error(fmt::format("Mesh: switch {} is not attached to any router", switch_id));
+    }
+    return switch_id;
+}
+
+int Mesh::getRouter(int node) const {
+    return node == router_cnt_ ? config_.global_memory_router_id : node;
+}
+
+// XY routing, along the x dimension first and then along the y dimension
+void Mesh::getRoute(int src_node, int dst_node, std::vector<int>& route) const {
+    route.clear();
+    route.push_back(router_cnt_ * direction_cnt + src_node);
+
+    int router = getRouter(src_node);
+    int dst_router = getRouter(dst_node);
+    int x = router % config_.x_cnt, y = router / config_.x_cnt;
+    int dst_x = dst_router % config_.x_cnt, dst_y = dst_router / config_.x_cnt;
+    while (x != dst_x) {
+        route.push_back((y * config_.x_cnt + x) * direction_cnt + (x < dst_x ? east : west));
+        x += x < dst_x ? 1 : -1;
+    }
+    while (y != dst_y) {
+        route.push_back((y * config_.x_cnt + x) * direction_cnt + (y < dst_y ? north : south));
+        y += y < dst_y ? 1 : -1;
+    }
+
+    route.push_back(router_cnt_ * direction_cnt + node_cnt_ + dst_node);
+}
+
+std::string Mesh::getLinkName(int link_index) const {
+    if (link_index < router_cnt_ * direction_cnt) {
+        static const char* direction_names[] = {"east", "west", "north", "south"};
+        int router = link_index / direction_cnt;
+        return fmt::format("router_{}_{}.{}", router % config_.x_cnt, router / config_.x_cnt,
+                           direction_names[link_index % direction_cnt]);
+    }
+
+    int port_index = link_index - router_cnt_ * direction_cnt;
+    int node = port_index % node_cnt_;
+    auto node_name = node == router_cnt_ ? std::string{"global_memory"} : fmt::format("core_{}", node);
+    return fmt::format("{}.{}", node_name, port_index < node_cnt_ ? "inject" : "eject");
+}
+
+}  // namespace pimsim
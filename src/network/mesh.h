@@ -0,0 +1,67 @@
+//
+// Created by wyk on 2024/11/13.
+//
+
+#pragma once
+#include <string>
+#include <vector>
+
+#include "config/config.h"
+#include "systemc.h"
+#include "util/reporter.h"
+
+namespace pimsim {
+
+// Links of a 2D mesh reserved by messages along their XY routes, see MeshConfig. A message moves as a whole from link
+// to link (virtual cut-through): its head flit takes a link once the link is free and the hops before have been passed,
+// and the link is held until the last flit has left it, one flit per cycle. The route is reserved when the message is
+// sent, so the messages take each link in the order they are sent.
+class Mesh {
+public:
+    Mesh(const MeshConfig& config, const SimConfig& sim_config);
+
+    // reserves the route from 'start_time' on and returns the time from then until the last flit has arrived
+    sc_core::sc_time transferAndGetDelay(int src_id, int dst_id, int flit_cnt, const sc_core::sc_time& start_time);
+
+    // the latency of a single flit on an idle route
+    [[nodiscard]] double getLatencyCycle(int src_id, int dst_id) const;
+    // per flit over the links between two routers and the routers on the route
+    [[nodiscard]] double getEnergyPJ(int src_id, int dst_id) const;
+    // the links between two routers on the route
+    [[nodiscard]] int getHopCount(int src_id, int dst_id) const;
+
+    // the links that carried any flit
+    [[nodiscard]] std::vector<NetworkLinkReport> getLinkReports() const;
+
+private:
+    enum Direction { east = 0, west = 1, north = 2, south = 3, direction_cnt = 4 };
+
+    struct Link {
+        sc_core::sc_time release_time{sc_core::SC_ZERO_TIME};
+
+        long long flit_cnt{0};
+        sc_core::sc_time busy_time{sc_core::SC_ZERO_TIME};
+        sc_core::sc_time stall_time{sc_core::SC_ZERO_TIME};
+    };
+
+    // cores are the nodes with their own ids, the global memory is the node after them, throws for other switches
+    [[nodiscard]] int getNode(int switch_id) const;
+    [[nodiscard]] int getRouter(int node) const;
+
+    // the indexes in 'links_' from the injection port of the source to the ejection port of the destination
+    void getRoute(int src_node, int dst_node, std::vector<int>& route) const;
+    [[nodiscard]] std::string getLinkName(int link_index) const;
+
+private:
+    const MeshConfig& config_;
+    const SimConfig& sim_config_;
+
+    const int router_cnt_;
+    const int node_cnt_;
+
+    // the output links of each router by direction, then the injection ports and the ejection ports of the nodes
+    std::vector<Link> links_;
+    std::vector<int> route_;
+};
+
+}  // namespace pimsim
@@ -4,27 +4,102 @@
 
 #include "network.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <set>
+#include <stdexcept>
 #include <utility>
 
+#include "fmt/format.h"
 #include "util/util.h"
 
 namespace pimsim {
 
-Network::Network(std::string name, const NetworkConfig& config, const SimConfig& sim_config)
-    : config_(config), sim_config_(sim_config), name_(std::move(name)) {
-    readLatencyEnergyFile(config.network_config_file_path);
+Network::Network(std::string name, const NetworkConfig& config, const SimConfig& sim_config,
+                 int global_memory_switch_id)
+    : config_(config)
+    , sim_config_(sim_config)
+    , name_(std::move(name))
+    , global_memory_switch_id_(global_memory_switch_id) {
+    if (config.model == +NetworkModel::mesh) {
+        mesh_ = std::make_unique<Mesh>(config.mesh_config, sim_config);
+    } else if (!config.generate_table) {
+        readLatencyEnergyFile(config.network_config_file_path);
+    } else if (!config.table_override_file_path.empty()) {
+        readLatencyEnergyFile(config.table_override_file_path);
+    } else {
+        setLatencyEnergy(nlohmann::json::object());
+    }
 }
 
 sc_core::sc_time Network::transferAndGetDelay(int src_id, int dst_id, int data_size_byte) {
-    auto per_flit_latency_ns = latency_map_[src_id][dst_id] * sim_config_.period_ns;
-    auto per_flit_energy_pj = energy_map_[src_id][dst_id];
-    int times = IntDivCeil(data_size_byte, config_.bus_width_byte);
+    return transferFromAndGetDelay(src_id, dst_id, data_size_byte, sc_core::sc_time_stamp());
+}
+
+const std::vector<std::pair<int, sc_core::sc_time>>& Network::multicastAndGetDelays(int src_id, int dst_id,
+                                                                                    int dst_cnt, int data_size_byte) {
+    // the latency of each destination is looked up once, so an unknown pair throws before any sorting
+    multicast_latency_list_.clear();
+    for (int id = dst_id; id < dst_id + dst_cnt; id++) {
+        if (id != src_id) {
+            multicast_latency_list_.emplace_back(getLatencyCycle(src_id, id), id);
+        }
+    }
+    std::stable_sort(multicast_latency_list_.begin(), multicast_latency_list_.end(),
+                     [](const auto& node1, const auto& node2) { return node1.first < node2.first; });
+    multicast_node_list_.clear();
+    multicast_node_list_.push_back(src_id);
+    for (const auto& [latency, id] : multicast_latency_list_) {
+        multicast_node_list_.push_back(id);
+    }
+
+    auto now = sc_core::sc_time_stamp();
+    multicast_ready_time_list_.assign(multicast_node_list_.size(), now);
+    multicast_delay_list_.clear();
+    for (int i = 1; i < multicast_node_list_.size(); i++) {
+        int parent = config_.multicast_fanout == 0 ? 0 : (i - 1) / config_.multicast_fanout;
+        auto start_time = multicast_ready_time_list_[parent];
+        auto arrival_time = start_time + transferFromAndGetDelay(multicast_node_list_[parent],
+                                                                 multicast_node_list_[i], data_size_byte, start_time);
+        multicast_ready_time_list_[i] = arrival_time;
+        // a node sends its copies one after another, which the mesh already does at the injection port
+        if (!hasLinkContention()) {
+            multicast_ready_time_list_[parent] = arrival_time;
+        }
+        multicast_delay_list_.emplace_back(multicast_node_list_[i], arrival_time - now);
+    }
+    return multicast_delay_list_;
+}
 
-    energy_counter_.addDynamicEnergyPJ(times * per_flit_energy_pj);
+sc_core::sc_time Network::transferFromAndGetDelay(int src_id, int dst_id, int data_size_byte,
+                                                  const sc_core::sc_time& start_time) {
+    // a payload without data still carries its header, so it never arrives in no time
+    if (mesh_ != nullptr) {
+        int flit_cnt = std::max(1, IntDivCeil(data_size_byte, config_.mesh_config.link_width_byte));
+        int hop_cnt = mesh_->getHopCount(src_id, dst_id);
+        flit_count_.link_flit_cnt += static_cast<long long>(flit_cnt) * hop_cnt;
+        flit_count_.router_flit_cnt += static_cast<long long>(flit_cnt) * (hop_cnt + 1);
+        return mesh_->transferAndGetDelay(src_id, dst_id, flit_cnt, start_time);
+    }
 
+    int pair_index = getPairIndex(src_id, dst_id);
+    auto per_flit_latency_ns = latency_matrix_[pair_index] * sim_config_.period_ns;
+    int times = std::max(1, IntDivCeil(data_size_byte, config_.bus_width_byte));
+
+    flit_count_.pair_flit_cnt[pair_index] += times;
+
+    if (config_.pipelined_flit) {
+        // the head flit pays the latency, the others follow it one flit interval apart
+        return sc_time{per_flit_latency_ns + (times - 1) * config_.flit_interval_cycle * sim_config_.period_ns, SC_NS};
+    }
     return sc_time{times * per_flit_latency_ns, SC_NS};
 }
 
+bool Network::hasLinkContention() const {
+    return mesh_ != nullptr;
+}
+
 Switch* Network::getSwitch(int id) {
     return switch_map_[id];
 }
@@ -35,38 +110,169 @@ void Network::registerSwitch(int id, Switch* switch_ptr) {
     }
 }
 
+void Network::registerRemoteSwitch(int id) {
+    remote_switch_id_set_.insert(id);
+}
+
+bool Network::isRemoteSwitch(int id) const {
+    return remote_switch_id_set_.find(id) != remote_switch_id_set_.end();
+}
+
+void Network::sendToRemote(const RemoteNetworkPayload& payload) {
+    remote_outbox_.push_back(payload);
+}
+
+std::vector<RemoteNetworkPayload> Network::takeRemoteOutbox() {
+    std::vector<RemoteNetworkPayload> outbox;
+    outbox.swap(remote_outbox_);
+    return outbox;
+}
+
+double Network::getLatencyCycle(int src_id, int dst_id) const {
+    if (mesh_ != nullptr) {
+        return mesh_->getLatencyCycle(src_id, dst_id);
+    }
+    return latency_matrix_[getPairIndex(src_id, dst_id)];
+}
+
+int Network::getSwitchIndex(int id) const {
+    auto offset = static_cast<long long>(id) - min_switch_id_;
+    if (offset < 0 || offset >= static_cast<long long>(switch_index_table_.size())) {
+        return -1;
+    }
+    return switch_index_table_[offset];
+}
+
+bool Network::hasPair(int src_id, int dst_id) const {
+    if (mesh_ != nullptr) {
+        return true;
+    }
+    int src_index = getSwitchIndex(src_id);
+    int dst_index = getSwitchIndex(dst_id);
+    if (src_index == -1 || dst_index == -1) {
+        return false;
+    }
+    int pair_index = src_index * switch_cnt_ + dst_index;
+    return !std::isnan(latency_matrix_[pair_index]) && !std::isnan(energy_matrix_[pair_index]);
+}
+
+int Network::getPairIndex(int src_id, int dst_id) const {
+    if (hasPair(src_id, dst_id)) {
+        return getSwitchIndex(src_id) * switch_cnt_ + getSwitchIndex(dst_id);
+    }
+    auto table_name = config_.generate_table ? std::string{"the generated tables"}
+                                             : fmt::format("'{}'", config_.network_config_file_path);
+    throw std::runtime_error(fmt::format("Network: no latency and energy from switch {} to switch {} in {}", src_id,
+                                         dst_id, table_name));
+}
+
+// With 'generate_table', the tables are filled with the latency and energy of a single flit on an idle mesh for
+// every pair of routers and the global memory, in O(N^2) without going through json, before the given pairs.
 void Network::setLatencyEnergy(const nlohmann::json& j) {
-    // set latency
-    auto latency_array = j["latency"];
-    for (const auto& src_array : latency_array.items()) {
-        auto src_key = std::stoi(src_array.key());
-
-        for (const auto& dst : src_array.value().items()) {
-            auto dst_key = std::stoi(dst.key());
-            latency_map_[src_key][dst_key] = dst.value();
+    static const nlohmann::json empty_table = nlohmann::json::object();
+    const auto& latency_array = j.contains("latency") ? j.at("latency") : empty_table;
+    const auto& energy_array = j.contains("energy") ? j.at("energy") : empty_table;
+
+    // index the switches of both tables
+    std::set<int> switch_id_set;
+    for (const auto* table : {&latency_array, &energy_array}) {
+        for (const auto& src_array : table->items()) {
+            switch_id_set.insert(std::stoi(src_array.key()));
+            for (const auto& dst : src_array.value().items()) {
+                switch_id_set.insert(std::stoi(dst.key()));
+            }
+        }
+    }
+    std::vector<int> mesh_switch_id_list;
+    if (config_.generate_table) {
+        for (int id = 0; id < config_.mesh_config.getRouterCount(); id++) {
+            mesh_switch_id_list.push_back(id);
         }
+        mesh_switch_id_list.push_back(global_memory_switch_id_);
+        switch_id_set.insert(mesh_switch_id_list.begin(), mesh_switch_id_list.end());
     }
 
-    // set energy
-    auto energy_array = j["energy"];
-    for (const auto& src_array : energy_array.items()) {
-        auto src_key = std::stoi(src_array.key());
+    switch_cnt_ = static_cast<int>(switch_id_set.size());
+    switch_index_table_.clear();
+    if (!switch_id_set.empty()) {
+        min_switch_id_ = *switch_id_set.begin();
+        switch_index_table_.assign(*switch_id_set.rbegin() - min_switch_id_ + 1, -1);
+    }
+    int index = 0;
+    for (int id : switch_id_set) {
+        switch_index_table_[id - min_switch_id_] = index++;
+    }
 
-        for (const auto& dst : src_array.value().items()) {
-            auto dst_key = std::stoi(dst.key());
-            energy_map_[src_key][dst_key] = dst.value();
+    // a switch reaches itself for free unless the tables say otherwise
+    latency_matrix_.assign(switch_cnt_ * switch_cnt_, std::numeric_limits<double>::quiet_NaN());
+    energy_matrix_.assign(switch_cnt_ * switch_cnt_, std::numeric_limits<double>::quiet_NaN());
+    for (int i = 0; i < switch_cnt_; i++) {
+        latency_matrix_[i * switch_cnt_ + i] = 0.0;
+        energy_matrix_[i * switch_cnt_ + i] = 0.0;
+    }
+    auto fill_matrix = [this](const nlohmann::json& table, std::vector<double>& matrix) {
+        for (const auto& src_array : table.items()) {
+            int src_index = getSwitchIndex(std::stoi(src_array.key()));
+            for (const auto& dst : src_array.value().items()) {
+                matrix[src_index * switch_cnt_ + getSwitchIndex(std::stoi(dst.key()))] = dst.value();
+            }
+        }
+    };
+    if (config_.generate_table) {
+        Mesh mesh{config_.mesh_config, sim_config_};
+        for (int src_id : mesh_switch_id_list) {
+            int src_index = getSwitchIndex(src_id);
+            for (int dst_id : mesh_switch_id_list) {
+                int pair_index = src_index * switch_cnt_ + getSwitchIndex(dst_id);
+                latency_matrix_[pair_index] = mesh.getLatencyCycle(src_id, dst_id);
+                energy_matrix_[pair_index] = mesh.getEnergyPJ(src_id, dst_id);
+            }
         }
     }
+    fill_matrix(latency_array, latency_matrix_);
+    fill_matrix(energy_array, energy_matrix_);
+    flit_count_.pair_flit_cnt.assign(switch_cnt_ * switch_cnt_, 0);
 }
 
 void Network::readLatencyEnergyFile(const std::string& file_path) {
-    std::ifstream ifs(config_.network_config_file_path);
+    std::ifstream ifs(file_path);
     auto j = nlohmann::json::parse(ifs);
     setLatencyEnergy(j);
 }
 
+// the energy is summed from the flit counts in a fixed order, so it does not depend on the order of the transfers.
+// the energy of the mesh is booked against its config parameters, while the per flit energy of the tables is not
 EnergyReporter Network::getEnergyReporter() const {
-    return EnergyReporter{energy_counter_};
+    EnergyCounter energy_counter;
+    if (mesh_ != nullptr) {
+        energy_counter.addEventDynamicEnergyPJ(config_.mesh_config.link_energy_pJ,
+                                               static_cast<double>(flit_count_.link_flit_cnt));
+        energy_counter.addEventDynamicEnergyPJ(config_.mesh_config.router_energy_pJ,
+                                               static_cast<double>(flit_count_.router_flit_cnt));
+    } else {
+        for (int pair_index = 0; pair_index < flit_count_.pair_flit_cnt.size(); pair_index++) {
+            if (auto flit_cnt = flit_count_.pair_flit_cnt[pair_index]; flit_cnt > 0) {
+                energy_counter.addDynamicEnergyPJ(flit_cnt * energy_matrix_[pair_index]);
+            }
+        }
+    }
+    return EnergyReporter{energy_counter};
+}
+
+std::vector<NetworkLinkReport> Network::getLinkReports() const {
+    return mesh_ == nullptr ? std::vector<NetworkLinkReport>{} : mesh_->getLinkReports();
+}
+
+const NetworkFlitCount& Network::getFlitCount() const {
+    return flit_count_;
+}
+
+void Network::addFlitCount(const NetworkFlitCount& flit_count) {
+    for (int pair_index = 0; pair_index < flit_count.pair_flit_cnt.size(); pair_index++) {
+        flit_count_.pair_flit_cnt[pair_index] += flit_count.pair_flit_cnt[pair_index];
+    }
+    flit_count_.link_flit_cnt += flit_count.link_flit_cnt;
+    flit_count_.router_flit_cnt += flit_count.router_flit_cnt;
 }
 
 }  // namespace pimsim
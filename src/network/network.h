@@ -4,12 +4,17 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "base_component/energy_counter.h"
 #include "config/config.h"
+#include "mesh.h"
 #include "nlohmann/json.hpp"
+#include "payload.h"
 #include "systemc.h"
 #include "util/reporter.h"
 
@@ -17,31 +22,94 @@ namespace pimsim {
 
 class Switch;
 
+// The flits a network has carried, which its energy is computed from. The counts are integers, so the counts of the
+// partitions of a parallel simulation add up to the sequential ones and the energy is the same.
+struct NetworkFlitCount {
+    std::vector<long long> pair_flit_cnt{};  // by pair index, with the table model
+    long long link_flit_cnt{0};              // flits times the links between two routers, with the mesh model
+    long long router_flit_cnt{0};            // flits times the routers, with the mesh model
+
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(NetworkFlitCount, pair_flit_cnt, link_flit_cnt, router_flit_cnt)
+};
+
 class Network {
 public:
-    Network(std::string name, const NetworkConfig& config, const SimConfig& sim_config);
+    // the global memory switch is placed on the mesh along with the cores when the tables are generated
+    Network(std::string name, const NetworkConfig& config, const SimConfig& sim_config,
+            int global_memory_switch_id = -1);
 
+    // with the mesh model, the route is reserved from now on and the delay includes the time queued on its links
     sc_core::sc_time transferAndGetDelay(int src_id, int dst_id, int data_size_byte);
+    // the delay from now until a multicast from 'src_id' arrives at each switch from 'dst_id' to 'dst_id' + 'dst_cnt'
+    // - 1 except the source, see NetworkConfig. the result is kept until the next multicast
+    const std::vector<std::pair<int, sc_core::sc_time>>& multicastAndGetDelays(int src_id, int dst_id, int dst_cnt,
+                                                                               int data_size_byte);
+    // whether transfers wait for each other on shared links, so the switches need not serialize them
+    [[nodiscard]] bool hasLinkContention() const;
 
     Switch* getSwitch(int id);
     void registerSwitch(int id, Switch* switch_ptr);
 
+    // switches simulated by other partitions of a parallel simulation, payloads to them are collected in the outbox
+    void registerRemoteSwitch(int id);
+    [[nodiscard]] bool isRemoteSwitch(int id) const;
+    void sendToRemote(const RemoteNetworkPayload& payload);
+    std::vector<RemoteNetworkPayload> takeRemoteOutbox();
+
+    // whether the latency and the energy between the switches are given, so that payloads can go between them
+    [[nodiscard]] bool hasPair(int src_id, int dst_id) const;
+    // per flit without contention, throws if the latency between the switches is not given
+    [[nodiscard]] double getLatencyCycle(int src_id, int dst_id) const;
+
     void readLatencyEnergyFile(const std::string& file_path);
+    // the pairs in 'j' are set over the generated ones, if any
     void setLatencyEnergy(const nlohmann::json& j);
 
     EnergyReporter getEnergyReporter() const;
+    [[nodiscard]] std::vector<NetworkLinkReport> getLinkReports() const;
+
+    [[nodiscard]] const NetworkFlitCount& getFlitCount() const;
+    // adds the flits carried by another partition of a parallel simulation
+    void addFlitCount(const NetworkFlitCount& flit_count);
+
+private:
+    // the delay from 'start_time' on, which is now or later, a payload takes at least one flit
+    sc_core::sc_time transferFromAndGetDelay(int src_id, int dst_id, int data_size_byte,
+                                             const sc_core::sc_time& start_time);
+
+    // -1 if the switch is in neither table
+    [[nodiscard]] int getSwitchIndex(int id) const;
+    // throws if the latency or the energy between the switches is not given
+    [[nodiscard]] int getPairIndex(int src_id, int dst_id) const;
 
 private:
     const NetworkConfig& config_;
     const SimConfig& sim_config_;
     std::string name_;
+    const int global_memory_switch_id_;
 
     std::unordered_map<int, Switch*> switch_map_;
+    std::unordered_set<int> remote_switch_id_set_;
+    std::vector<RemoteNetworkPayload> remote_outbox_;
+
+    // the switch ids in the tables are mapped to dense indexes through a table indexed by id - 'min_switch_id_', and
+    // the latency and energy of each pair are kept in matrices by src index * switch count + dst index, NaN if not
+    // given
+    int min_switch_id_{0};
+    std::vector<int> switch_index_table_;
+    int switch_cnt_{0};
+    std::vector<double> latency_matrix_;  // cycle
+    std::vector<double> energy_matrix_;   // pJ
+
+    std::unique_ptr<Mesh> mesh_{nullptr};  // only with the mesh model
 
-    std::unordered_map<int, std::unordered_map<int, double>> latency_map_;  // cycle
-    std::unordered_map<int, std::unordered_map<int, double>> energy_map_;   // pJ
+    // the multicast tree, the source first and then the destinations by latency from the source
+    std::vector<int> multicast_node_list_;
+    std::vector<std::pair<double, int>> multicast_latency_list_;  // latency from the source and id of each destination
+    std::vector<sc_core::sc_time> multicast_ready_time_list_;  // when each node may send the next copy
+    std::vector<std::pair<int, sc_core::sc_time>> multicast_delay_list_;
 
-    EnergyCounter energy_counter_;
+    NetworkFlitCount flit_count_;
 };
 
 }  // namespace pimsim
\ No newline at end of file
@@ -4,8 +4,10 @@
 
 #pragma once
 #include <memory>
+#include <type_traits>
 
 #include "better-enums/enum.h"
+#include "core/payload/payload.h"
 #include "systemc.h"
 
 namespace pimsim {
@@ -14,41 +16,73 @@ BETTER_ENUM(DataTransferStatus, int,  // NOLINT(*-explicit-constructor)
             sender_ready, receiver_ready, send_data)
 
 BETTER_ENUM(NetworkTransferMode, int,  // NOLINT(*-explicit-constructor)
-            transport, only_send)
+            transport, only_send, barrier)
+
+struct DataTransferInfo {
+    int sender_id;
+    int receiver_id;
+
+    bool is_sender;
+    DataTransferStatus status;
+
+    int id_tag;
+    int data_size_byte;
+};
 
 struct NetworkPayload {
     int src_id;
     int dst_id;
+    int dst_cnt{1};  // a send mode payload multicast to the switches from 'dst_id' to 'dst_id' + 'dst_cnt' - 1
 
     sc_core::sc_event* finish_network_trans{nullptr};
 
-    // one payload contains request and its response(optional)
+    // transport mode, set by the destination once it has served the request in the background, see GlobalMemory
+    bool served{false};
+    sc_core::sc_event* finish_serve{nullptr};
+
+    // one payload contains a request and the size of its response(optional). the request is a global memory access
+    // in transport mode, or a data transfer in send mode
     int request_data_size_byte;
-    std::shared_ptr<void> request_payload;
+    std::shared_ptr<MemoryAccessPayload> memory_access{nullptr};
+    std::shared_ptr<DataTransferInfo> data_transfer{nullptr};
 
     int response_data_size_byte;
-    std::shared_ptr<void> response_payload;
+};
 
-    template <typename T>
-    std::shared_ptr<T> getRequestPayload() {
-        return std::static_pointer_cast<T>(request_payload);
-    }
+// A network payload crossing the partitions of a parallel simulation. It is written between processes as raw bytes,
+// so only plain fields are kept: send mode payloads carry a DataTransferInfo, transport mode payloads carry a global
+// memory access, whose response comes back as a payload with 'response' set. Barrier mode payloads tell every other
+// partition that core 'src_id' has arrived at a barrier.
+struct RemoteNetworkPayload {
+    int src_id{0};
+    int dst_id{0};
+    NetworkTransferMode mode{NetworkTransferMode::only_send};
+    bool response{false};
 
-    template <typename T>
-    std::shared_ptr<T> getResponsePayload() {
-        return std::static_pointer_cast<T>(response_payload);
-    }
-};
+    int request_data_size_byte{0};
+    int response_data_size_byte{0};
+    sc_core::sc_time::value_type arrival_time{0};  // in time resolution units, for a response the time it is served
 
-struct DataTransferInfo {
-    int sender_id;
-    int receiver_id;
+    // send mode
+    DataTransferInfo data_transfer{.sender_id = -1,
+                                   .receiver_id = -1,
+                                   .is_sender = false,
+                                   .status = DataTransferStatus::sender_ready,
+                                   .id_tag = -1,
+                                   .data_size_byte = 0};
 
-    bool is_sender;
-    DataTransferStatus status;
+    // transport mode
+    InstructionPayload ins{};
+    MemoryAccessType access_type{MemoryAccessType::read};
+    int address_byte{0};
+    int size_byte{0};
+    int transport_id{-1};  // the lane of the requester switch, sent back with the response
 
-    int id_tag;
-    int data_size_byte;
+    // barrier mode
+    int barrier_id{0};
+    int barrier_core_cnt{0};
 };
 
+static_assert(std::is_trivially_copyable_v<RemoteNetworkPayload>);
+
 }  // namespace pimsim
@@ -0,0 +1,127 @@
+//
+// Created by wyk on 2024/11/13.
+//
+
+#include "remote_switch.h"
+
+#include <stdexcept>
+
+#include "fmt/format.h"
+#include "switch.h"
+#include "util/log.h"
+
+namespace pimsim {
+
+RemoteSwitch::RemoteSwitch(const char* name, const SimConfig& sim_config, Clock* clk, int switch_id)
+    : BaseModule(name, sim_config, nullptr, clk), switch_id_(switch_id) {
+    SC_THREAD(processReceive);
+}
+
+void RemoteSwitch::processReceive() {
+    while (true) {
+        while (pending_queue_.empty()) {
+            wait(trigger_);
+        }
+
+        auto remote_payload = pending_queue_.front();
+        pending_queue_.pop();
+
+        auto arrival_time = sc_core::sc_time::from_value(remote_payload.arrival_time);
+        if (arrival_time > sc_core::sc_time_stamp()) {
+            wait(arrival_time - sc_core::sc_time_stamp());
+        }
+
+        LOG(fmt::format("remote mode: {}, src: {}, dst: {}, req size: {}, rsp size: {}",
+                        remote_payload.mode._to_string(), remote_payload.src_id, remote_payload.dst_id,
+                        remote_payload.request_data_size_byte, remote_payload.response_data_size_byte));
+        if (remote_payload.mode == +NetworkTransferMode::transport) {
+            startResponseLane(remote_payload);
+            continue;
+        }
+
+        auto payload =
+            payload_pool_.make(NetworkPayload{.src_id = remote_payload.src_id,
+                                              .dst_id = remote_payload.dst_id,
+                                              .request_data_size_byte = remote_payload.request_data_size_byte,
+                                              .response_data_size_byte = remote_payload.response_data_size_byte});
+        payload->data_transfer = payload_pool_.make(remote_payload.data_transfer);
+        network_->getSwitch(remote_payload.dst_id)->receiveHandler(payload);
+    }
+}
+
+void RemoteSwitch::processResponseLane(ResponseLane* lane) {
+    while (true) {
+        while (!lane->busy) {
+            wait(lane->start);
+        }
+        const auto& remote_payload = lane->remote_payload;
+
+        auto payload =
+            payload_pool_.make(NetworkPayload{.src_id = remote_payload.src_id,
+                                              .dst_id = remote_payload.dst_id,
+                                              .finish_serve = &lane->finish_serve,
+                                              .request_data_size_byte = remote_payload.request_data_size_byte,
+                                              .response_data_size_byte = remote_payload.response_data_size_byte});
+        payload->memory_access = payload_pool_.make(MemoryAccessPayload{.ins = remote_payload.ins,
+                                                                        .access_type = remote_payload.access_type,
+                                                                        .address_byte = remote_payload.address_byte,
+                                                                        .size_byte = remote_payload.size_byte,
+                                                                        .finish_access = lane->finish_access});
+        network_->getSwitch(remote_payload.dst_id)->receiveHandler(payload);
+        while (!payload->served) {
+            wait(lane->finish_serve);
+        }
+
+        // the requester adds the receive delay, so that the response shares its link with the others
+        network_->sendToRemote(RemoteNetworkPayload{.src_id = remote_payload.dst_id,
+                                                    .dst_id = remote_payload.src_id,
+                                                    .mode = NetworkTransferMode::transport,
+                                                    .response = true,
+                                                    .response_data_size_byte = remote_payload.response_data_size_byte,
+                                                    .arrival_time = sc_core::sc_time_stamp().value(),
+                                                    .transport_id = remote_payload.transport_id});
+
+        lane->busy = false;
+        idle_response_lanes_.push_back(lane);
+    }
+}
+
+// made the first time all of them are busy and reused afterward, see Switch::startTransportLane
+void RemoteSwitch::startResponseLane(const RemoteNetworkPayload& remote_payload) {
+    ResponseLane* lane;
+    if (idle_response_lanes_.empty()) {
+        lane = response_lanes_.emplace_back(std::make_unique<ResponseLane>()).get();
+        lane->id = static_cast<int>(response_lanes_.size()) - 1;
+        sc_core::sc_spawn([this, lane] { processResponseLane(lane); },
+                          fmt::format("response_lane_{}", lane->id).c_str());
+    } else {
+        lane = idle_response_lanes_.back();
+        idle_response_lanes_.pop_back();
+    }
+    lane->remote_payload = remote_payload;
+    lane->busy = true;
+    lane->start.notify();
+}
+
+void RemoteSwitch::receive(const RemoteNetworkPayload& payload) {
+    if (auto arrival_time = sc_core::sc_time::from_value(payload.arrival_time);
+        arrival_time < sc_core::sc_time_stamp()) {
+        throw std::runtime_error(fmt::format("RemoteSwitch {}: window violation, the payload arriving at {} is "
+                                             "received at {}",
+                                             switch_id_, arrival_time.to_string(),
+                                             sc_core::sc_time_stamp().to_string()));
+    }
+    pending_queue_.push(payload);
+    trigger_.notify(sc_core::SC_ZERO_TIME);
+}
+
+void RemoteSwitch::bindNetwork(Network* network) {
+    network_ = network;
+    network_->registerRemoteSwitch(switch_id_);
+}
+
+long long RemoteSwitch::getPayloadAllocationCount() const {
+    return payload_pool_.getAllocationCount();
+}
+
+}  // namespace pimsim
@@ -0,0 +1,63 @@
+//
+// Created by wyk on 2024/11/13.
+//
+
+#pragma once
+#include <memory>
+#include <queue>
+#include <vector>
+
+#include "base_component/base_module.h"
+#include "base_component/payload_pool.h"
+#include "network.h"
+#include "payload.h"
+#include "systemc.h"
+
+namespace pimsim {
+
+// Stands for a switch simulated by another partition of a parallel simulation. The payloads it sent to this
+// partition are handed to the local targets at their arrival time, and for transport mode the response is sent back
+// once the target has served the request, which goes on in a lane so that the later payloads are not held up.
+class RemoteSwitch : public BaseModule {
+    SC_HAS_PROCESS(RemoteSwitch);
+
+public:
+    RemoteSwitch(const char* name, const SimConfig& sim_config, Clock* clk, int switch_id);
+
+    [[noreturn]] void processReceive();
+
+    // called between two simulation windows, payloads of one switch come in the order they were sent
+    void receive(const RemoteNetworkPayload& payload);
+
+    void bindNetwork(Network* network);
+
+    [[nodiscard]] long long getPayloadAllocationCount() const;
+
+private:
+    // a transport mode request handed to its local target, waiting until it is served to send the response back
+    struct ResponseLane {
+        int id{0};
+        bool busy{false};
+        RemoteNetworkPayload remote_payload{};
+        sc_core::sc_event start;
+        sc_core::sc_event finish_access;
+        sc_core::sc_event finish_serve;
+    };
+
+    [[noreturn]] void processResponseLane(ResponseLane* lane);
+    void startResponseLane(const RemoteNetworkPayload& remote_payload);
+
+private:
+    const int switch_id_;
+    Network* network_{nullptr};
+
+    std::queue<RemoteNetworkPayload> pending_queue_;
+    sc_core::sc_event trigger_;
+
+    std::vector<std::unique_ptr<ResponseLane>> response_lanes_;
+    std::vector<ResponseLane*> idle_response_lanes_;
+
+    PayloadPool payload_pool_;
+};
+
+}  // namespace pimsim
@@ -4,6 +4,9 @@
 
 #include "switch.h"
 
+#include <algorithm>
+#include <stdexcept>
+
 #include "core/core.h"
 #include "fmt/format.h"
 #include "switch_socket.h"
@@ -11,8 +14,9 @@
 
 namespace pimsim {
 
-Switch::Switch(const char* name, const SimConfig& sim_config, Core* core, Clock* clk, int core_id)
-    : BaseModule(name, sim_config, core, clk), core_id_(core_id) {
+Switch::Switch(const char* name, const SimConfig& sim_config, Core* core, Clock* clk, int core_id,
+               int max_transport_cnt)
+    : BaseModule(name, sim_config, core, clk), max_transport_cnt_(max_transport_cnt), core_id_(core_id) {
     SC_THREAD(processTransport);
 }
 
@@ -21,6 +25,10 @@ void Switch::processTransport() {
         while (pending_queue_.empty()) {
             wait(trigger_);
         }
+        // with one transport at a time, a payload leaves only after the response of the transport before it
+        while (getBusyTransportLaneCount() >= max_transport_cnt_) {
+            wait(finish_transport_);
+        }
 
         auto payload = pending_queue_.front().first;
         auto mode = pending_queue_.front().second;
@@ -28,22 +36,109 @@ void Switch::processTransport() {
 
         LOG(fmt::format("mode: {}, src: {}, dst: {}, req size: {}, rsp size: {}", mode._to_string(), payload->src_id,
                         payload->dst_id, payload->request_data_size_byte, payload->response_data_size_byte));
+        if (payload->dst_cnt > 1) {
+            multicastAndWait(payload);
+            if (payload->finish_network_trans != nullptr) {
+                payload->finish_network_trans->notify(SC_ZERO_TIME);
+            }
+            continue;
+        }
+
         auto send_delay =
             network_->transferAndGetDelay(payload->src_id, payload->dst_id, payload->request_data_size_byte);
-        wait(send_delay);
+        if (network_->isRemoteSwitch(payload->dst_id)) {
+            // handed to the other partition now with its arrival time, which is at least one synchronization window
+            // ahead, so the receiver gets it before its simulation reaches that time
+            int transport_id = (mode == +NetworkTransferMode::transport) ? startTransportLane(payload) : -1;
+            sendToRemote(payload, payload->dst_id, mode, sc_core::sc_time_stamp() + send_delay, transport_id);
+            wait(send_delay);
+
+            if (mode == +NetworkTransferMode::transport) {
+                continue;
+            }
+        } else {
+            wait(send_delay);
 
-        auto target_switch = network_->getSwitch(payload->dst_id);
-        target_switch->receiveHandler(payload);
-        if (mode == +NetworkTransferMode::transport) {
+            if (mode == +NetworkTransferMode::transport) {
+                startTransportLane(payload);
+                continue;
+            }
+            network_->getSwitch(payload->dst_id)->receiveHandler(payload);
+        }
+
+        if (payload->finish_network_trans != nullptr) {
+            payload->finish_network_trans->notify(SC_ZERO_TIME);
+        }
+    }
+}
+
+void Switch::processTransportLane(TransportLane* lane) {
+    while (true) {
+        while (lane->payload == nullptr) {
+            wait(lane->start);
+        }
+        auto payload = std::move(lane->payload);
+
+        if (network_->isRemoteSwitch(payload->dst_id)) {
+            // the other partition serves the request, see receiveRemoteResponse
+            while (!lane->remote_responded) {
+                wait(lane->remote_response);
+            }
+            lane->remote_responded = false;
+            wait(lane->remote_response_time - sc_core::sc_time_stamp());
+        } else {
+            // the destination queues the request and serves it in the background
+            payload->served = false;
+            payload->finish_serve = &lane->finish_serve;
+            auto target_switch = network_->getSwitch(payload->dst_id);
+            target_switch->receiveHandler(payload);
+            while (!payload->served) {
+                wait(lane->finish_serve);
+            }
+
+            // the responses come back over the link of this switch one after another, unless the network already
+            // queues them on its links
             auto receive_delay =
                 network_->transferAndGetDelay(payload->dst_id, payload->src_id, payload->response_data_size_byte);
-            wait(receive_delay);
+            if (network_->hasLinkContention()) {
+                wait(receive_delay);
+            } else {
+                auto response_start_time = std::max(sc_core::sc_time_stamp(), response_release_time_);
+                response_release_time_ = response_start_time + receive_delay;
+                wait(response_release_time_ - sc_core::sc_time_stamp());
+            }
         }
 
         if (payload->finish_network_trans != nullptr) {
             payload->finish_network_trans->notify(SC_ZERO_TIME);
         }
+        idle_transport_lanes_.push_back(lane);
+        finish_transport_.notify();
+    }
+}
+
+// Lanes are made the first time all of them are busy and reused afterward, so there are as many of them as the most
+// transports in flight at once.
+int Switch::startTransportLane(const std::shared_ptr<NetworkPayload>& payload) {
+    if (idle_transport_lanes_.empty()) {
+        auto& lane = transport_lanes_.emplace_back(std::make_unique<TransportLane>());
+        lane->id = static_cast<int>(transport_lanes_.size()) - 1;
+        lane->payload = payload;
+        auto* lane_ptr = lane.get();
+        sc_core::sc_spawn([this, lane_ptr] { processTransportLane(lane_ptr); },
+                          fmt::format("transport_lane_{}", lane->id).c_str());
+        return lane->id;
     }
+
+    auto* lane = idle_transport_lanes_.back();
+    idle_transport_lanes_.pop_back();
+    lane->payload = payload;
+    lane->start.notify();
+    return lane->id;
+}
+
+int Switch::getBusyTransportLaneCount() const {
+    return static_cast<int>(transport_lanes_.size() - idle_transport_lanes_.size());
 }
 
 void Switch::transportHandler(const std::shared_ptr<NetworkPayload>& payload) {
@@ -65,6 +160,74 @@ void Switch::receiveHandler(const std::shared_ptr<NetworkPayload>& payload) {
     receive_handler_(payload);
 }
 
+// The other partition sends the response back with the time it served the request, which is less than one
+// synchronization window ago, so the response still arrives from now on. Like the local ones, it takes the link of this
+// switch after the responses that have started before it is received.
+void Switch::receiveRemoteResponse(const RemoteNetworkPayload& response) {
+    auto served_time = sc_core::sc_time::from_value(response.arrival_time);
+    auto receive_delay =
+        network_->transferAndGetDelay(response.src_id, response.dst_id, response.response_data_size_byte);
+    auto response_time = served_time + receive_delay;
+    if (!network_->hasLinkContention()) {
+        response_time = std::max(served_time, response_release_time_) + receive_delay;
+        response_release_time_ = response_time;
+    }
+    if (response_time < sc_core::sc_time_stamp()) {
+        throw std::runtime_error(fmt::format("Switch {}: window violation, the remote response arriving at {} is "
+                                             "received at {}",
+                                             core_id_, response_time.to_string(),
+                                             sc_core::sc_time_stamp().to_string()));
+    }
+
+    auto& lane = *transport_lanes_.at(response.transport_id);
+    lane.remote_response_time = response_time;
+    lane.remote_responded = true;
+    lane.remote_response.notify(SC_ZERO_TIME);
+}
+
+void Switch::sendToRemote(const std::shared_ptr<NetworkPayload>& payload, int dst_id, NetworkTransferMode mode,
+                          const sc_core::sc_time& arrival_time, int transport_id) {
+    RemoteNetworkPayload remote_payload{.src_id = payload->src_id,
+                                        .dst_id = dst_id,
+                                        .mode = mode,
+                                        .request_data_size_byte = payload->request_data_size_byte,
+                                        .response_data_size_byte = payload->response_data_size_byte,
+                                        .arrival_time = arrival_time.value()};
+    if (mode == +NetworkTransferMode::transport) {
+        const auto& memory_access = payload->memory_access;
+        remote_payload.ins = memory_access->ins;
+        remote_payload.access_type = memory_access->access_type;
+        remote_payload.address_byte = memory_access->address_byte;
+        remote_payload.size_byte = memory_access->size_byte;
+        remote_payload.transport_id = transport_id;
+    } else {
+        remote_payload.data_transfer = *payload->data_transfer;
+    }
+    network_->sendToRemote(remote_payload);
+}
+
+// Every path of the multicast tree to a switch of another partition crosses partitions, so its arrival is at least
+// one synchronization window ahead and the payload can be handed over now.
+void Switch::multicastAndWait(const std::shared_ptr<NetworkPayload>& payload) {
+    auto start_time = sc_core::sc_time_stamp();
+    multicast_delay_list_ = network_->multicastAndGetDelays(payload->src_id, payload->dst_id, payload->dst_cnt,
+                                                            payload->request_data_size_byte);
+    std::sort(multicast_delay_list_.begin(), multicast_delay_list_.end(),
+              [](const auto& delay1, const auto& delay2) { return delay1.second < delay2.second; });
+
+    for (const auto& [dst_id, delay] : multicast_delay_list_) {
+        if (network_->isRemoteSwitch(dst_id)) {
+            sendToRemote(payload, dst_id, NetworkTransferMode::only_send, start_time + delay);
+        }
+    }
+    for (const auto& [dst_id, delay] : multicast_delay_list_) {
+        wait(start_time + delay - sc_core::sc_time_stamp());
+        if (!network_->isRemoteSwitch(dst_id)) {
+            network_->getSwitch(dst_id)->receiveHandler(payload);
+        }
+    }
+}
+
 void Switch::bindNetwork(Network* network) {
     network_ = network;
     network_->registerSwitch(core_id_, this);
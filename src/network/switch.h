@@ -3,7 +3,10 @@
 //
 
 #pragma once
+#include <memory>
 #include <queue>
+#include <utility>
+#include <vector>
 
 #include "network.h"
 #include "payload.h"
@@ -18,7 +21,9 @@ class Switch : public BaseModule {
     SC_HAS_PROCESS(Switch);
 
 public:
-    Switch(const char* name, const SimConfig& sim_config, Core* core, Clock* clk, int core_id);
+    // at most 'max_transport_cnt' transports are in flight, the next payload waits while that many are
+    Switch(const char* name, const SimConfig& sim_config, Core* core, Clock* clk, int core_id,
+           int max_transport_cnt = 1);
 
     [[noreturn]] void processTransport();
 
@@ -31,14 +36,51 @@ public:
     void registerReceiveHandler(const std::function<void(const std::shared_ptr<NetworkPayload>&)>& reveive_handler);
     void receiveHandler(const std::shared_ptr<NetworkPayload>& payload);  // when recv data from network,call this
 
+    // the response of a transport mode payload sent to another partition of a parallel simulation
+    void receiveRemoteResponse(const RemoteNetworkPayload& response);
+
     void bindNetwork(Network* network);
 
+private:
+    // a transport whose request has left the switch, waiting for the destination and the response
+    struct TransportLane {
+        int id{0};
+        std::shared_ptr<NetworkPayload> payload{nullptr};
+        sc_core::sc_event start;
+        sc_core::sc_event finish_serve;
+
+        // destination in another partition
+        bool remote_responded{false};
+        sc_core::sc_time remote_response_time;
+        sc_core::sc_event remote_response;
+    };
+
+    [[noreturn]] void processTransportLane(TransportLane* lane);
+    // returns the id of the lane
+    int startTransportLane(const std::shared_ptr<NetworkPayload>& payload);
+    [[nodiscard]] int getBusyTransportLaneCount() const;
+
+    void sendToRemote(const std::shared_ptr<NetworkPayload>& payload, int dst_id, NetworkTransferMode mode,
+                      const sc_core::sc_time& arrival_time, int transport_id = -1);
+    // hands the payload to each destination at its arrival, and waits until the last one
+    void multicastAndWait(const std::shared_ptr<NetworkPayload>& payload);
+
 private:
     sc_core::sc_event trigger_;
 
     std::queue<std::pair<std::shared_ptr<NetworkPayload>, NetworkTransferMode>> pending_queue_;
     std::function<void(const std::shared_ptr<NetworkPayload>&)> receive_handler_;
 
+    // the requests leave the switch one at a time in 'processTransport', while the transports whose requests have
+    // left go on in lanes, so several loads of a core may be in flight, and only their responses share the link again
+    const int max_transport_cnt_;
+    std::vector<std::unique_ptr<TransportLane>> transport_lanes_;
+    std::vector<TransportLane*> idle_transport_lanes_;
+    sc_core::sc_event finish_transport_;
+    sc_core::sc_time response_release_time_{sc_core::SC_ZERO_TIME};
+
+    std::vector<std::pair<int, sc_core::sc_time>> multicast_delay_list_;
+
     int core_id_;
     Network* network_{nullptr};
 };
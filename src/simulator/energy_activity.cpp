@@ -0,0 +1,160 @@
+//
+// Created by wyk on 2024/11/13.
+//
+
+#include "energy_activity.h"
+
+#include <fstream>
+#include <iostream>
+
+#include "fmt/format.h"
+#include "layer_simulator.h"
+
+namespace pimsim {
+
+namespace {
+
+// "a.b[1].c" as in Config::getPowerParameterNames to the JSON pointer "/a/b/1/c"
+nlohmann::ordered_json::json_pointer getJsonPointer(const std::string& path) {
+    std::string pointer = "/";
+    for (char c : path) {
+        if (c == '.' || c == '[') {
+            pointer += '/';
+        } else if (c != ']') {
+            pointer += c;
+        }
+    }
+    return nlohmann::ordered_json::json_pointer{pointer};
+}
+
+// power and energy parameters do not affect timing
+void erasePowerParameters(nlohmann::ordered_json& j, const Config& config) {
+    for (const auto& [power, name] : config.getPowerParameterNames()) {
+        auto pointer = getJsonPointer(name);
+        if (j.contains(pointer)) {
+            j.at(pointer.parent_pointer()).erase(pointer.back());
+        }
+    }
+}
+
+// the global image file is given per run, see setGlobalImageFile
+void eraseGlobalImageFile(nlohmann::ordered_json& j, const Config& config) {
+    const auto& local_memory_list = config.chip_config.core_config.local_memory_unit_config.local_memory_list;
+    for (int i = 0; i < local_memory_list.size(); i++) {
+        if (local_memory_list[i].name == GLOBAL_MEMORY_NAME) {
+            auto pointer = getJsonPointer(fmt::format(
+                "chip_config.core_config.local_memory_unit_config.local_memory_list[{}].hardware_config.image_file", i));
+            if (j.contains(pointer)) {
+                j.at(pointer.parent_pointer()).erase(pointer.back());
+            }
+        }
+    }
+}
+
+const std::string* findGlobalImageFile(const Config& config) {
+    for (const auto& local_memory_config : config.chip_config.core_config.local_memory_unit_config.local_memory_list) {
+        if (local_memory_config.name == GLOBAL_MEMORY_NAME && local_memory_config.ram_config.has_image) {
+            return &local_memory_config.ram_config.image_file;
+        }
+    }
+    return nullptr;
+}
+
+std::map<std::string, double> getPowerParameterValues(const Config& config) {
+    std::map<std::string, double> values;
+    for (const auto& [power, name] : config.getPowerParameterNames()) {
+        values.emplace(name, *power);
+    }
+    return std::move(values);
+}
+
+}  // namespace
+
+bool writeEnergyActivityFile(const std::string& activity_file, const Config& config, const Reporter& reporter) {
+    std::ofstream ofs(activity_file);
+    if (!ofs.is_open()) {
+        std::cerr << fmt::format("Cannot open activity file '{}'", activity_file) << std::endl;
+        return false;
+    }
+
+    nlohmann::ordered_json activity_json;
+    activity_json["config"] = config;
+    activity_json["reporter"] = nlohmann::ordered_json::parse(nlohmann::json(reporter).dump());
+    ofs << activity_json;
+    ofs.close();
+    return true;
+}
+
+bool readEnergyActivityFile(const std::string& activity_file, EnergyActivity& activity) {
+    std::ifstream ifs(activity_file);
+    if (!ifs.is_open()) {
+        std::cerr << fmt::format("Cannot open activity file '{}'", activity_file) << std::endl;
+        return false;
+    }
+
+    auto activity_json = nlohmann::ordered_json::parse(ifs);
+    activity.config = activity_json.at("config").get<Config>();
+    activity.reporter = nlohmann::json::parse(activity_json.at("reporter").dump()).get<Reporter>();
+
+    const auto& energy_reporter = activity.reporter.getEnergyReporter();
+    if (energy_reporter.getStaticActivity().empty() && energy_reporter.getDynamicActivity().empty()) {
+        std::cerr << fmt::format("No energy activity was recorded in '{}'", activity_file) << std::endl;
+        return false;
+    }
+    // e.g. the per flit energy of the network tables, which come from a file rather than the config
+    if (energy_reporter.getUntrackedEnergyPJ() != 0.0) {
+        std::cerr << fmt::format("Warning: {:.3f}pJ of the energy in '{}' was not booked against a power parameter "
+                                 "and is kept as recorded",
+                                 energy_reporter.getUntrackedEnergyPJ(), activity_file)
+                  << std::endl;
+    }
+    return true;
+}
+
+bool readRecostConfigFile(const std::string& config_file, const EnergyActivity& activity, Config& config) {
+    std::ifstream ifs(config_file);
+    if (!ifs.is_open()) {
+        std::cerr << fmt::format("Cannot open config file '{}'", config_file) << std::endl;
+        return false;
+    }
+
+    config = nlohmann::ordered_json::parse(ifs).get<Config>();
+    if (const auto* global_image_file = findGlobalImageFile(activity.config); global_image_file != nullptr) {
+        setGlobalImageFile(config, *global_image_file);
+    }
+    return config.checkValid();
+}
+
+bool recostEnergy(const EnergyActivity& activity, const Config& config, Reporter& reporter) {
+    nlohmann::ordered_json recorded_timing_json = activity.config;
+    nlohmann::ordered_json timing_json = config;
+    erasePowerParameters(recorded_timing_json, activity.config);
+    erasePowerParameters(timing_json, config);
+    eraseGlobalImageFile(recorded_timing_json, activity.config);
+    eraseGlobalImageFile(timing_json, config);
+    if (recorded_timing_json != timing_json) {
+        std::cerr << "Config changes parameters other than power, which may change timing:" << std::endl;
+        for (const auto& op : nlohmann::ordered_json::diff(recorded_timing_json, timing_json)) {
+            std::cerr << fmt::format("  - {} {}", op.at("op").get<std::string>(), op.at("path").get<std::string>())
+                      << std::endl;
+        }
+        return false;
+    }
+
+    auto recorded_power = getPowerParameterValues(activity.config);
+    auto power = getPowerParameterValues(config);
+    const auto& energy_reporter = activity.reporter.getEnergyReporter();
+    for (const auto* activity_map : {&energy_reporter.getStaticActivity(), &energy_reporter.getDynamicActivity()}) {
+        for (const auto& [name, value] : *activity_map) {
+            if (recorded_power.count(name) == 0 || power.count(name) == 0) {
+                std::cerr << fmt::format("Unknown power parameter '{}' in the recorded activity", name) << std::endl;
+                return false;
+            }
+        }
+    }
+
+    reporter = activity.reporter.recost(recorded_power, power);
+    return true;
+}
+
+}  // namespace pimsim
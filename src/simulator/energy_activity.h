@@ -0,0 +1,33 @@
+//
+// Created by wyk on 2024/11/13.
+//
+
+#pragma once
+#include <string>
+
+#include "config/config.h"
+#include "util/reporter.h"
+
+namespace pimsim {
+
+// The config a workload was simulated with and its report with the energy activity recorded. Energy is only activity
+// times power, so the report of the same workload under other power parameters can be recomputed from it without
+// simulating again.
+struct EnergyActivity {
+    Config config;
+    Reporter reporter;
+};
+
+bool writeEnergyActivityFile(const std::string& activity_file, const Config& config, const Reporter& reporter);
+bool readEnergyActivityFile(const std::string& activity_file, EnergyActivity& activity);
+
+// reads a config to recost 'activity' with. the global image is given per run rather than in the config, so the config
+// gets the one of the recorded run as LayerSimulator would have given it, see setGlobalImageFile
+bool readRecostConfigFile(const std::string& config_file, const EnergyActivity& activity, Config& config);
+
+// recomputes the report of the recorded workload with the power parameters of 'config'. fails if 'config' changes
+// anything other than power parameters and the global image file, since that may change the timing and the activity
+// with it
+bool recostEnergy(const EnergyActivity& activity, const Config& config, Reporter& reporter);
+
+}  // namespace pimsim
@@ -0,0 +1,91 @@
+//
+// Created by wyk on 2024/11/13.
+//
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+#include "argparse/argparse.hpp"
+#include "energy_activity.h"
+#include "fmt/format.h"
+#include "systemc.h"
+
+#define RECOST_PASSED  0
+#define RECOST_FAILED  1
+#define INVALID_CONFIG 3
+
+struct RecostArguments {
+    std::string activity_file;
+    std::vector<std::string> config_file_list;
+    std::string output_dir;
+};
+
+RecostArguments parseRecostArguments(int argc, char* argv[]) {
+    argparse::ArgumentParser parser("EnergyRecost");
+    parser.add_argument("activity").help("energy activity file recorded by LayerSimulator or NetworkSimulator");
+    parser.add_argument("-o", "--output_dir").help("directory of the reports").default_value("");
+    parser.add_argument("configs").help("config files with the power parameters to recost with").remaining();
+
+    try {
+        parser.parse_args(argc, argv);
+    } catch (const std::runtime_error& err) {
+        std::cerr << err.what() << std::endl;
+        std::cerr << parser;
+        std::exit(EXIT_FAILURE);
+    }
+    if (!parser.is_used("configs")) {
+        std::cerr << "At least one config file is required" << std::endl;
+        std::cerr << parser;
+        std::exit(EXIT_FAILURE);
+    }
+
+    std::string output_dir = parser.is_used("--output_dir") ? parser.get("--output_dir") : ".";
+    return RecostArguments{.activity_file = parser.get("activity"),
+                           .config_file_list = parser.get<std::vector<std::string>>("configs"),
+                           .output_dir = output_dir};
+}
+
+std::string getFileStem(const std::string& file_path) {
+    auto name = file_path.substr(file_path.find_last_of("/\\") + 1);
+    return name.substr(0, name.find_last_of('.'));
+}
+
+int sc_main(int argc, char* argv[]) {
+    auto args = parseRecostArguments(argc, argv);
+
+    pimsim::EnergyActivity activity;
+    if (!pimsim::readEnergyActivityFile(args.activity_file, activity)) {
+        return RECOST_FAILED;
+    }
+
+    int result = RECOST_PASSED;
+    for (const auto& config_file : args.config_file_list) {
+        auto start = std::chrono::steady_clock::now();
+
+        pimsim::Config config;
+        pimsim::Reporter reporter;
+        if (!pimsim::readRecostConfigFile(config_file, activity, config) ||
+            !pimsim::recostEnergy(activity, config, reporter)) {
+            std::cerr << fmt::format("Cannot recost with config '{}'", config_file) << std::endl;
+            result = INVALID_CONFIG;
+            continue;
+        }
+
+        auto report_file = fmt::format("{}/{}.txt", args.output_dir, getFileStem(config_file));
+        std::ofstream ofs(report_file);
+        reporter.report(ofs);
+        ofs.close();
+
+        std::ofstream json_ofs(fmt::format("{}/{}.json", args.output_dir, getFileStem(config_file)));
+        json_ofs << nlohmann::json(reporter);
+        json_ofs.close();
+
+        auto end = std::chrono::steady_clock::now();
+        std::cout << fmt::format("{}: {:.4f} mW, {:.3f} ms -> {}", config_file, reporter.getAveragePowerMW(),
+                                 std::chrono::duration<double, std::milli>(end - start).count(), report_file)
+                  << std::endl;
+    }
+
+    return result;
+}
@@ -4,14 +4,21 @@
 
 #include "layer_simulator.h"
 
-#include "argparse/argparse.hpp"
+#include "base_component/energy_counter.h"
 #include "fmt/format.h"
 #include "isa/instruction.h"
 #include "util/util.h"
 
 namespace pimsim {
 
-const std::string GLOBAL_MEMORY_NAME = "global";
+void setGlobalImageFile(Config& config, const std::string& global_image_file) {
+    for (auto& local_memory_config : config.chip_config.core_config.local_memory_unit_config.local_memory_list) {
+        if (local_memory_config.name == GLOBAL_MEMORY_NAME) {
+            local_memory_config.ram_config.has_image = true;
+            local_memory_config.ram_config.image_file = global_image_file;
+        }
+    }
+}
 
 LayerSimulator::LayerSimulator(std::string config_file, std::string instruction_file, std::string global_image_file,
                                std::string expected_ins_stat_file, std::string expected_reg_file,
@@ -24,7 +31,20 @@ LayerSimulator::LayerSimulator(std::string config_file, std::string instruction_
     , actual_reg_file_(std::move(actual_reg_file))
     , check_(check) {}
 
-void LayerSimulator::run() {
+void LayerSimulator::setRecordActivity(bool record_activity) {
+    record_activity_ = record_activity;
+}
+
+void LayerSimulator::setLoopFastForward(bool loop_fast_forward) {
+    loop_fast_forward_ = loop_fast_forward;
+}
+
+void LayerSimulator::setFastForwardTarget(const FastForwardTarget& target) {
+    fast_forward_ = true;
+    fast_forward_target_ = target;
+}
+
+bool LayerSimulator::run() {
     std::cout << "Loading Instructions and Config" << std::endl;
     std::ifstream config_if(config_file_);
     std::ifstream instruction_if(instruction_file_);
@@ -32,15 +52,17 @@ void LayerSimulator::run() {
     nlohmann::ordered_json instruction_json = nlohmann::ordered_json::parse(instruction_if);
     config_ = config_json.get<Config>();
 
-    for (auto& local_memory_config : config_.chip_config.core_config.local_memory_unit_config.local_memory_list) {
-        if (local_memory_config.name == GLOBAL_MEMORY_NAME) {
-            local_memory_config.ram_config.has_image = true;
-            local_memory_config.ram_config.image_file = global_image_file_;
-        }
+    setGlobalImageFile(config_, global_image_file_);
+    if (loop_fast_forward_) {
+        config_.sim_config.loop_fast_forward = true;
     }
     if (!config_.checkValid()) {
         std::cout << "Invalid config" << std::endl;
-        return;
+        return false;
+    }
+
+    if (record_activity_) {
+        EnergyCounter::setPowerParameterNames(config_.getPowerParameterNames());
     }
 
     std::cout << "Load finish" << std::endl;
@@ -50,19 +72,23 @@ void LayerSimulator::run() {
     std::cout << "Read finish" << std::endl;
 
     std::cout << "Build Chip" << std::endl;
-    chip_ = std::make_shared<Chip>("Chip", config_, core_ins_list);
+    chip_ = std::make_shared<ParallelChip>("Chip", config_, core_ins_list);
+    if (!chip_->checkValid()) {
+        std::cout << "Invalid config" << std::endl;
+        return false;
+    }
+    if (fast_forward_) {
+        chip_->setFastForwardTarget(fast_forward_target_);
+    }
     std::cout << "Build finish" << std::endl;
 
     std::cout << "Start Simulation" << std::endl;
-    if (config_.sim_config.sim_mode == +SimMode::run_until_time) {
-        sc_start(config_.sim_config.sim_time_ms, sc_core::SC_MS);
-    } else {
-        sc_start();
-    }
+    chip_->run();
     std::cout << "Simulation Finish" << std::endl;
+    return true;
 }
 
-void LayerSimulator::report(std::ostream& os, const std::string& report_json_file) {
+Reporter LayerSimulator::report(std::ostream& os, const std::string& report_json_file) {
     os << "|*************** Simulation Report ***************|\n";
     os << "Basic Information:\n";
 
@@ -84,6 +110,12 @@ void LayerSimulator::report(std::ostream& os, const std::string& report_json_fil
         ofs << report_json;
         ofs.close();
     }
+
+    return std::move(reporter);
+}
+
+const Config& LayerSimulator::getConfig() const {
+    return config_;
 }
 
 // bool LayerSimulator::checkInsStat() const {
@@ -115,99 +147,3 @@ std::vector<std::vector<Instruction>> LayerSimulator::getCoreInstructionList(
 }
 
 }  // namespace pimsim
-
-struct PimArguments {
-    std::string config_file;
-    std::string instruction_file;
-    std::string global_image_file;
-    std::string expected_ins_stat_file;
-    std::string expected_reg_file;
-    std::string actual_reg_file;
-    bool check;
-
-    bool report_result;
-    std::string simulation_report_file;
-    std::string report_json_file;
-};
-
-PimArguments parsePimArguments(int argc, char* argv[]) {
-    argparse::ArgumentParser parser("ChipTest");
-    parser.add_argument("config").help("config file");
-    parser.add_argument("inst").help("instruction file");
-    parser.add_argument("global").help("global image file");
-    parser.add_argument("stat").help("expected ins stat file");
-    parser.add_argument("reg").help("expected reg file");
-    parser.add_argument("actual_reg").help("actual reg file");
-    parser.add_argument("-c", "--check")
-        .help("whether to check reg and ins stat")
-        .default_value(false)
-        .implicit_value(true);
-    parser.add_argument("-r", "--report")
-        .help("whether to report simulation result")
-        .default_value(false)
-        .implicit_value(true);
-    parser.add_argument("-s", "--sim_report").help("simulation report file").default_value("");
-    parser.add_argument("-j", "--report_json").help("report json file").default_value("");
-
-    try {
-        parser.parse_args(argc, argv);
-    } catch (const std::runtime_error& err) {
-        std::cerr << err.what() << std::endl;
-        std::cerr << parser;
-        std::exit(EXIT_FAILURE);
-    }
-
-    std::string simulation_report_file = parser.is_used("--sim_report") ? parser.get("--sim_report") : "";
-    std::string report_json_file = parser.is_used("--report_json") ? parser.get("--report_json") : "";
-    return PimArguments{.config_file = parser.get("config"),
-                        .instruction_file = parser.get("inst"),
-                        .global_image_file = parser.get("global"),
-                        .expected_ins_stat_file = parser.get("stat"),
-                        .expected_reg_file = parser.get("reg"),
-                        .actual_reg_file = parser.get("actual_reg"),
-                        .check = parser.get<bool>("--check"),
-                        .report_result = parser.get<bool>("--report"),
-                        .simulation_report_file = simulation_report_file,
-                        .report_json_file = report_json_file};
-}
-
-int sc_main(int argc, char* argv[]) {
-    sc_core::sc_report_handler::set_actions(sc_core::SC_WARNING, sc_core::SC_DO_NOTHING);
-
-    auto args = parsePimArguments(argc, argv);
-
-    pimsim::LayerSimulator layer_simulator{args.config_file,
-                                           args.instruction_file,
-                                           args.global_image_file,
-                                           args.expected_ins_stat_file,
-                                           args.expected_reg_file,
-                                           args.actual_reg_file,
-                                           args.check};
-    layer_simulator.run();
-
-    if (!args.simulation_report_file.empty()) {
-        std::ofstream os;
-        os.open(args.simulation_report_file);
-        layer_simulator.report(os, args.report_json_file);
-        os.close();
-    } else if (args.report_result) {
-        layer_simulator.report(std::cout, args.report_json_file);
-    } else {
-        std::stringstream ss;
-        layer_simulator.report(ss, args.report_json_file);
-    }
-
-    // if (!layer_simulator.checkInsStat()) {
-    //     std::cerr << "check ins stat failed" << std::endl;
-    //     return CHECK_INS_STAT_FAILED;
-    // }
-    //
-    // if (args.check) {
-    //     if (!layer_simulator.checkReg()) {
-    //         std::cerr << "check reg failed" << std::endl;
-    //         return CHECK_REG_FAILED;
-    //     }
-    // }
-
-    return TEST_PASSED;
-}
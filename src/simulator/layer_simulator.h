@@ -5,7 +5,7 @@
 #pragma once
 #include <string>
 
-#include "chip/chip.h"
+#include "chip/parallel_chip.h"
 #include "config/config.h"
 #include "core/core.h"
 
@@ -18,15 +18,31 @@
 
 namespace pimsim {
 
+const std::string GLOBAL_MEMORY_NAME = "global";
+
+// the image of the global memory is given per run rather than in the config, this points the config at it
+void setGlobalImageFile(Config& config, const std::string& global_image_file);
+
 class LayerSimulator {
 public:
     LayerSimulator(std::string config_file, std::string instruction_file, std::string global_image_file,
                    std::string expected_ins_stat_file, std::string expected_reg_file, std::string actual_reg_file,
                    bool check);
 
-    void run();
+    // records the energy activity during the simulation so that the report can be recosted, see energy_activity.h
+    void setRecordActivity(bool record_activity);
+
+    // enables loop fast-forwarding whatever the config says, see SimConfig::loop_fast_forward
+    void setLoopFastForward(bool loop_fast_forward);
+
+    // executes the cores functionally up to the target before the detailed simulation, see Core::fastForward
+    void setFastForwardTarget(const FastForwardTarget& target);
+
+    bool run();
+
+    Reporter report(std::ostream& os, const std::string& report_json_file);
 
-    void report(std::ostream& os, const std::string& report_json_file);
+    [[nodiscard]] const Config& getConfig() const;
 
     // [[nodiscard]] bool checkInsStat() const;
     // [[nodiscard]] bool checkReg() const;
@@ -35,7 +51,7 @@ private:
     [[nodiscard]] std::vector<std::vector<Instruction>> getCoreInstructionList(const nlohmann::ordered_json& instruction_json) const;
 
 private:
-    std::shared_ptr<Chip> chip_;
+    std::shared_ptr<ParallelChip> chip_;
 
     Config config_;
     std::string config_file_;
@@ -45,6 +61,10 @@ private:
     std::string expected_reg_file_;
     std::string actual_reg_file_;
     bool check_;
+    bool record_activity_{false};
+    bool loop_fast_forward_{false};
+    bool fast_forward_{false};
+    FastForwardTarget fast_forward_target_{};
 };
 
 }  // namespace pimsim
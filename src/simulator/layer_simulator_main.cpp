@@ -0,0 +1,143 @@
+//
+// Created by wyk on 2024/11/13.
+//
+
+#include "layer_simulator.h"
+
+#include "argparse/argparse.hpp"
+#include "energy_activity.h"
+
+struct PimArguments {
+    std::string config_file;
+    std::string instruction_file;
+    std::string global_image_file;
+    std::string expected_ins_stat_file;
+    std::string expected_reg_file;
+    std::string actual_reg_file;
+    bool check;
+
+    bool report_result;
+    std::string simulation_report_file;
+    std::string report_json_file;
+    std::string activity_file;
+    std::string fast_forward_to;
+};
+
+PimArguments parsePimArguments(int argc, char* argv[]) {
+    argparse::ArgumentParser parser("ChipTest");
+    parser.add_argument("config").help("config file");
+    parser.add_argument("inst").help("instruction file");
+    parser.add_argument("global").help("global image file");
+    parser.add_argument("stat").help("expected ins stat file");
+    parser.add_argument("reg").help("expected reg file");
+    parser.add_argument("actual_reg").help("actual reg file");
+    parser.add_argument("-c", "--check")
+        .help("whether to check reg and ins stat")
+        .default_value(false)
+        .implicit_value(true);
+    parser.add_argument("-r", "--report")
+        .help("whether to report simulation result")
+        .default_value(false)
+        .implicit_value(true);
+    parser.add_argument("-s", "--sim_report").help("simulation report file").default_value("");
+    parser.add_argument("-j", "--report_json").help("report json file").default_value("");
+    parser.add_argument("-a", "--activity").help("energy activity file to record, see EnergyRecost").default_value("");
+    parser.add_argument("-f", "--fast-forward-to")
+        .help("execute functionally until 'pc:<pc>' or <ins_count> instructions per core, then simulate in detail")
+        .default_value("");
+
+    try {
+        parser.parse_args(argc, argv);
+    } catch (const std::runtime_error& err) {
+        std::cerr << err.what() << std::endl;
+        std::cerr << parser;
+        std::exit(EXIT_FAILURE);
+    }
+
+    std::string simulation_report_file = parser.is_used("--sim_report") ? parser.get("--sim_report") : "";
+    std::string report_json_file = parser.is_used("--report_json") ? parser.get("--report_json") : "";
+    std::string activity_file = parser.is_used("--activity") ? parser.get("--activity") : "";
+    std::string fast_forward_to = parser.is_used("--fast-forward-to") ? parser.get("--fast-forward-to") : "";
+    return PimArguments{.config_file = parser.get("config"),
+                        .instruction_file = parser.get("inst"),
+                        .global_image_file = parser.get("global"),
+                        .expected_ins_stat_file = parser.get("stat"),
+                        .expected_reg_file = parser.get("reg"),
+                        .actual_reg_file = parser.get("actual_reg"),
+                        .check = parser.get<bool>("--check"),
+                        .report_result = parser.get<bool>("--report"),
+                        .simulation_report_file = simulation_report_file,
+                        .report_json_file = report_json_file,
+                        .activity_file = activity_file,
+                        .fast_forward_to = fast_forward_to};
+}
+
+bool parseFastForwardTarget(const std::string& arg, pimsim::FastForwardTarget& target) {
+    const std::string pc_prefix = "pc:";
+    target.to_pc = (arg.rfind(pc_prefix, 0) == 0);
+    auto value = target.to_pc ? arg.substr(pc_prefix.size()) : arg;
+    try {
+        std::size_t pos;
+        target.value = std::stoll(value, &pos);
+        return pos == value.size() && target.value >= 0;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+int sc_main(int argc, char* argv[]) {
+    sc_core::sc_report_handler::set_actions(sc_core::SC_WARNING, sc_core::SC_DO_NOTHING);
+
+    auto args = parsePimArguments(argc, argv);
+
+    pimsim::LayerSimulator layer_simulator{args.config_file,
+                                           args.instruction_file,
+                                           args.global_image_file,
+                                           args.expected_ins_stat_file,
+                                           args.expected_reg_file,
+                                           args.actual_reg_file,
+                                           args.check};
+    layer_simulator.setRecordActivity(!args.activity_file.empty());
+    if (!args.fast_forward_to.empty()) {
+        pimsim::FastForwardTarget target;
+        if (!parseFastForwardTarget(args.fast_forward_to, target)) {
+            std::cerr << "Invalid fast-forward target: " << args.fast_forward_to << std::endl;
+            return INVALID_USAGE;
+        }
+        layer_simulator.setFastForwardTarget(target);
+    }
+    if (!layer_simulator.run()) {
+        return INVALID_CONFIG;
+    }
+
+    pimsim::Reporter reporter;
+    if (!args.simulation_report_file.empty()) {
+        std::ofstream os;
+        os.open(args.simulation_report_file);
+        reporter = layer_simulator.report(os, args.report_json_file);
+        os.close();
+    } else if (args.report_result) {
+        reporter = layer_simulator.report(std::cout, args.report_json_file);
+    } else {
+        std::stringstream ss;
+        reporter = layer_simulator.report(ss, args.report_json_file);
+    }
+
+    if (!args.activity_file.empty()) {
+        pimsim::writeEnergyActivityFile(args.activity_file, layer_simulator.getConfig(), reporter);
+    }
+
+    // if (!layer_simulator.checkInsStat()) {
+    //     std::cerr << "check ins stat failed" << std::endl;
+    //     return CHECK_INS_STAT_FAILED;
+    // }
+    //
+    // if (args.check) {
+    //     if (!layer_simulator.checkReg()) {
+    //         std::cerr << "check reg failed" << std::endl;
+    //         return CHECK_REG_FAILED;
+    //     }
+    // }
+
+    return TEST_PASSED;
+}
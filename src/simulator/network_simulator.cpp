@@ -8,45 +8,236 @@
 #define WEXITSTATUS(status) (((status) & 0xff00) >> 8)
 #define WIFEXITED(status)   (((status) & 0x7f) == 0)
 #elif defined(__linux__)
+#include <fcntl.h>
+#include <poll.h>
 #include <sys/wait.h>
+#include <unistd.h>
 #endif
 
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <sstream>
+#include <thread>
+
+#include "energy_activity.h"
+#include "layer_simulator.h"
+
 namespace pimsim {
 
+namespace {
+
+struct LayerTask {
+    std::string config_file;
+    std::string code_file;
+    std::string global_image_file;
+    std::string expected_ins_stat_file;
+    std::string expected_reg_file;
+    std::string actual_reg_file;
+    std::string log_file;
+    bool record_activity{false};
+    bool loop_fast_forward{false};
+};
+
+struct LayerWorker {
+    int pid{-1};
+    int read_fd{-1};
+    std::string output;
+
+    bool finished{false};
+    int status{0};
+};
+
+// Simulates one layer in a forked worker. SystemC keeps its kernel in globals, so every layer needs a process of its
+// own. The result code and the report json are written back to 'write_fd' separated by a line break. Workers run at
+// the same time, so each one logs to a file of its own.
+[[noreturn]] void runLayerWorker(const LayerTask& task, int write_fd) {
+    if (int log_fd = open(task.log_file.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644); log_fd >= 0) {
+        dup2(log_fd, STDOUT_FILENO);
+        dup2(log_fd, STDERR_FILENO);
+        close(log_fd);
+    }
+
+    int result = TEST_PASSED;
+    std::string report_json_str;
+    try {
+        LayerSimulator layer_simulator{task.config_file,
+                                       task.code_file,
+                                       task.global_image_file,
+                                       task.expected_ins_stat_file,
+                                       task.expected_reg_file,
+                                       task.actual_reg_file,
+                                       false};
+        layer_simulator.setRecordActivity(task.record_activity);
+        layer_simulator.setLoopFastForward(task.loop_fast_forward);
+        if (layer_simulator.run()) {
+            std::stringstream ss;
+            nlohmann::json report_json = layer_simulator.report(ss, "");
+            report_json_str = report_json.dump();
+        } else {
+            result = INVALID_CONFIG;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        result = TEST_FAILED;
+    }
+
+    auto output = fmt::format("{}\n{}", result, report_json_str);
+    const char* data = output.data();
+    std::size_t size = output.size();
+    while (size > 0) {
+        auto written = write(write_fd, data, size);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            break;
+        }
+        data += written;
+        size -= written;
+    }
+
+    std::cout.flush();
+    std::cerr.flush();
+    _exit(EXIT_SUCCESS);
+}
+
+LayerWorker startLayerWorker(const LayerTask& task) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return {};
+    }
+
+    std::cout.flush();
+    int pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        runLayerWorker(task, fds[1]);
+    }
+
+    close(fds[1]);
+    if (pid < 0) {
+        close(fds[0]);
+        return {};
+    }
+    return {.pid = pid, .read_fd = fds[0]};
+}
+
+// reads whatever the running workers have written, and reaps the workers that closed their pipe
+void pollLayerWorkers(std::vector<LayerWorker>& worker_list, std::vector<int>& running_list) {
+    std::vector<pollfd> poll_fds;
+    for (int layer : running_list) {
+        poll_fds.push_back({.fd = worker_list[layer].read_fd, .events = POLLIN});
+    }
+    if (poll(poll_fds.data(), poll_fds.size(), -1) < 0) {
+        return;
+    }
+
+    char buffer[4096];
+    for (int i = 0; i < poll_fds.size(); i++) {
+        if (poll_fds[i].revents == 0) {
+            continue;
+        }
+        auto& worker = worker_list[running_list[i]];
+        auto read_size = read(worker.read_fd, buffer, sizeof(buffer));
+        if (read_size > 0) {
+            worker.output.append(buffer, read_size);
+        } else if (read_size == 0 || errno != EINTR) {
+            close(worker.read_fd);
+            waitpid(worker.pid, &worker.status, 0);
+            worker.finished = true;
+        }
+    }
+
+    running_list.erase(std::remove_if(running_list.begin(), running_list.end(),
+                                      [&worker_list](int layer) { return worker_list[layer].finished; }),
+                       running_list.end());
+}
+
+}  // namespace
+
 Reporter test_network(const std::string& data_root_dir, const std::string& report_root_dir, const std::string& network,
                       const TestCaseConfig& test_case_config, const std::vector<LayerConfig>& layer_config,
-                      bool& all_tests_passed, double OP_count) {
+                      bool& all_tests_passed, double OP_count, int parallel_layer_cnt, bool record_activity,
+                      bool loop_fast_forward) {
     auto data_dir = fmt::format("{}/{}/{}", data_root_dir, network, test_case_config.test_case_name);
     auto report_dir = fmt::format("{}/{}", report_root_dir, TEMP_REPORT_DIR_NAME);
+    // a rerun with loop fast-forwarding writes the outputs of its layers to files of its own
+    auto output_name = loop_fast_forward ? "fast_forward_" + test_case_config.test_case_name
+                                         : test_case_config.test_case_name;
 
     std::size_t execute_times = layer_config.size();
-    Reporter total_reporter;
+    std::vector<LayerTask> task_list;
     for (std::size_t i = 0; i < execute_times; i++) {
-        std::cout << fmt::format("    execute file{}: {}, ", i, layer_config[i].sub_dir_name);
-
-        auto code_file = fmt::format("{}/{}/{}", data_dir, layer_config[i].sub_dir_name, CODE_FILE_NAME);
-        auto global_image_file =
-            fmt::format("{}/{}/{}", data_dir, layer_config[i].sub_dir_name, GLOBAL_IMAGE_FILE_NAME);
-        auto report_json_file = fmt::format("{}/report{}.json", report_dir, i);
-        auto expected_ins_stat_file =
-            fmt::format("{}/{}/{}", data_dir, layer_config[i].sub_dir_name, EXPECTED_INS_STAT_FILE_NAME);
-        auto expected_reg_file =
-            fmt::format("{}/{}/{}", data_dir, layer_config[i].sub_dir_name, EXPECTED_REG_FILE_NAME);
-        auto actual_reg_file = fmt::format("{}/{}", report_dir, ACTUAL_REG_FILE_NAME);
-
-        // execute and generate json file
-        auto cmd = fmt::format("./LayerSimulator {} {} {} {} {} {} -j {} >> ./log.txt 2>&1",
-                               test_case_config.config_file_path, code_file, global_image_file, expected_ins_stat_file,
-                               expected_reg_file, actual_reg_file, report_json_file);
-        int status = system(cmd.c_str());
-        if (status == -1) {
-            all_tests_passed = false;
-            std::cout << "Fork Error!" << std::endl;
-        } else if (!WIFEXITED(status)) {
-            all_tests_passed = false;
-            std::cout << "Abnormal Exit!" << std::endl;
-        } else {
-            if (int result = WEXITSTATUS(status); result == TEST_PASSED) {
+        const auto& sub_dir_name = layer_config[i].sub_dir_name;
+        task_list.push_back(
+            {.config_file = test_case_config.config_file_path,
+             .code_file = fmt::format("{}/{}/{}", data_dir, sub_dir_name, CODE_FILE_NAME),
+             .global_image_file = fmt::format("{}/{}/{}", data_dir, sub_dir_name, GLOBAL_IMAGE_FILE_NAME),
+             .expected_ins_stat_file = fmt::format("{}/{}/{}", data_dir, sub_dir_name, EXPECTED_INS_STAT_FILE_NAME),
+             .expected_reg_file = fmt::format("{}/{}/{}", data_dir, sub_dir_name, EXPECTED_REG_FILE_NAME),
+             .actual_reg_file = fmt::format("{}/{}_layer{}_{}", report_dir, output_name, i, ACTUAL_REG_FILE_NAME),
+             .log_file = fmt::format("{}/{}_layer{}_{}", report_dir, output_name, i, LAYER_LOG_FILE_NAME),
+             .record_activity = record_activity,
+             .loop_fast_forward = loop_fast_forward});
+    }
+
+    // keep at most 'worker_cnt' layers running, and report them in layer order as they finish
+    std::size_t worker_cnt = parallel_layer_cnt > 0 ? parallel_layer_cnt : std::thread::hardware_concurrency();
+    worker_cnt = std::max<std::size_t>(worker_cnt, 1);
+    std::vector<LayerWorker> worker_list(execute_times);
+    std::vector<int> running_list;
+    std::size_t next_layer = 0;
+    std::size_t next_report_layer = 0;
+
+    Reporter total_reporter;
+    while (next_report_layer < execute_times) {
+        while (next_layer < execute_times && running_list.size() < worker_cnt) {
+            worker_list[next_layer] = startLayerWorker(task_list[next_layer]);
+            if (worker_list[next_layer].pid < 0) {
+                worker_list[next_layer].finished = true;
+            } else {
+                running_list.push_back(static_cast<int>(next_layer));
+            }
+            next_layer++;
+        }
+
+        if (!running_list.empty()) {
+            pollLayerWorkers(worker_list, running_list);
+        }
+
+        for (; next_report_layer < next_layer && worker_list[next_report_layer].finished; next_report_layer++) {
+            const auto& worker = worker_list[next_report_layer];
+            std::cout << fmt::format("    execute file{}: {}, ", next_report_layer,
+                                     layer_config[next_report_layer].sub_dir_name);
+
+            auto line_break = worker.output.find('\n');
+            if (worker.pid < 0) {
+                all_tests_passed = false;
+                std::cout << "Fork Error!" << std::endl;
+                continue;
+            } else if (!WIFEXITED(worker.status) || line_break == std::string::npos) {
+                all_tests_passed = false;
+                std::cout << "Abnormal Exit!" << std::endl;
+                continue;
+            }
+
+            // a worker that died while writing leaves a truncated output
+            int result;
+            Reporter reporter;
+            bool has_reporter = line_break + 1 < worker.output.size();
+            try {
+                result = std::stoi(worker.output.substr(0, line_break));
+                if (has_reporter) {
+                    reporter = nlohmann::json::parse(worker.output.substr(line_break + 1)).get<Reporter>();
+                }
+            } catch (const std::exception&) {
+                all_tests_passed = false;
+                std::cout << "Abnormal Exit!" << std::endl;
+                continue;
+            }
+
+            if (result == TEST_PASSED) {
                 std::cout << "Passed" << std::endl;
             } else {
                 all_tests_passed = false;
@@ -62,18 +253,12 @@ Reporter test_network(const std::string& data_root_dir, const std::string& repor
                     std::cout << "Check reg failed" << std::endl;
                 }
             }
-        }
-
-        // read json file, get reporter and add reporter
-        std::ifstream ifs(report_json_file);
-        auto report_json = nlohmann::json::parse(ifs);
-        ifs.close();
 
-        auto reporter = report_json.get<Reporter>();
-        total_reporter += reporter;
-
-        // delete json file
-        remove(report_json_file.c_str());
+            // merge the reporter of the layer
+            if (has_reporter) {
+                total_reporter += reporter;
+            }
+        }
     }
 
     total_reporter.setOPCount(OP_count);
@@ -83,6 +268,14 @@ Reporter test_network(const std::string& data_root_dir, const std::string& repor
     total_reporter.report(ofs);
     ofs.close();
 
+    if (record_activity) {
+        std::ifstream config_ifs(test_case_config.config_file_path);
+        auto config = nlohmann::ordered_json::parse(config_ifs).get<Config>();
+        auto activity_file_path = fmt::format("{}/{}/{}_activity.json", report_root_dir, network,
+                                              test_case_config.test_case_name);
+        writeEnergyActivityFile(activity_file_path, config, total_reporter);
+    }
+
     return std::move(total_reporter);
 }
 
@@ -93,15 +286,36 @@ void test_wrap(const std::string& test_config_file, bool& all_tests_passed) {
 
     auto test_config = test_config_json.get<TestConfig>();
     std::map<std::string, Reporter> reporters;
+    std::map<std::string, Reporter> fast_forward_reporters;
+    std::map<std::string, std::pair<double, double>> simulation_seconds;  // without and with fast-forwarding
 
     if (test_config.generate_report) {
         for (int i = 0; i < test_config.test_case_config.size(); i++) {
             if (const auto& test_case = test_config.test_case_config[i]; test_case.test) {
                 std::cout << fmt::format("Testing case {}: {}", i, test_case.test_case_name) << std::endl;
+                auto start = std::chrono::steady_clock::now();
                 auto reporter =
                     test_network(test_config.data_root_dir, test_config.report_root_dir, test_config.network, test_case,
-                                 test_config.layer_config, all_tests_passed, test_config.OP_count);
+                                 test_config.layer_config, all_tests_passed, test_config.OP_count,
+                                 test_config.parallel_layer_cnt, test_config.record_activity, false);
+                auto end = std::chrono::steady_clock::now();
                 reporters.emplace(test_case.test_case_name, std::move(reporter));
+
+                if (test_config.compare_loop_fast_forward) {
+                    std::cout << fmt::format("Testing case {} with loop fast-forward", i) << std::endl;
+                    auto fast_forward_test_case = test_case;
+                    fast_forward_test_case.report_file_name = "fast_forward_" + test_case.report_file_name;
+                    auto fast_forward_reporter = test_network(
+                        test_config.data_root_dir, test_config.report_root_dir, test_config.network,
+                        fast_forward_test_case, test_config.layer_config, all_tests_passed, test_config.OP_count,
+                        test_config.parallel_layer_cnt, false, true);
+                    auto fast_forward_end = std::chrono::steady_clock::now();
+                    fast_forward_reporters.emplace(test_case.test_case_name, std::move(fast_forward_reporter));
+                    simulation_seconds.emplace(
+                        test_case.test_case_name,
+                        std::make_pair(std::chrono::duration<double>(end - start).count(),
+                                       std::chrono::duration<double>(fast_forward_end - end).count()));
+                }
                 std::cout << fmt::format("Finish test case {}\n", i) << std::endl;
             }
         }
@@ -140,6 +354,16 @@ void test_wrap(const std::string& test_config_file, bool& all_tests_passed) {
         }
     }
 
+    for (auto& [name, fast_forward_reporter] : fast_forward_reporters) {
+        auto [seconds, fast_forward_seconds] = simulation_seconds[name];
+        network_report_ofs << fmt::format("{} compare with {} fast forward:\n", name, name);
+        network_report_ofs << fmt::format("  - {:<20}{:.2f} s / {:.2f} s\n", "simulation time:", seconds,
+                                          fast_forward_seconds);
+        auto compare_r = reporters[name].compare(fast_forward_reporter);
+        compare_r.report(network_report_ofs, false);
+        network_report_ofs << "\n";
+    }
+
     network_report_ofs.close();
 }
 
@@ -28,6 +28,7 @@ const std::string GLOBAL_IMAGE_FILE_NAME = "global_image";
 const std::string EXPECTED_INS_STAT_FILE_NAME = "stats.json";
 const std::string EXPECTED_REG_FILE_NAME = "regs.json";
 const std::string ACTUAL_REG_FILE_NAME = "regs.txt";
+const std::string LAYER_LOG_FILE_NAME = "log.txt";
 
 struct LayerConfig {
     std::string sub_dir_name{};
@@ -65,9 +66,19 @@ struct TestConfig {
     bool compare = false;
     std::vector<CompareConfig> compare_config;
 
+    // layers simulated at the same time, 0 for the number of host cores
+    int parallel_layer_cnt = 0;
+
+    // writes an energy activity file per test case, from which EnergyRecost computes reports for other power configs
+    bool record_activity = false;
+
+    // runs every test case again with loop fast-forwarding and reports the difference, to check its accuracy
+    bool compare_loop_fast_forward = false;
+
     NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(TestConfig, data_root_dir, report_root_dir, network, OP_count,
                                                 generate_report, test_case_config, layer_config, compare,
-                                                compare_config);
+                                                compare_config, parallel_layer_cnt, record_activity,
+                                                compare_loop_fast_forward);
 };
 
 struct CompareResult {
@@ -3,6 +3,8 @@
 //
 #include "reporter.h"
 
+#include <algorithm>
+
 #include "base_component/energy_counter.h"
 #include "fmt/core.h"
 
@@ -85,13 +87,40 @@ EnergyReporter::EnergyReporter(const EnergyCounter& energy_counter)
     : total_energy_(energy_counter.getTotalEnergyPJ())
     , static_energy_(energy_counter.getStaticEnergyPJ())
     , dynamic_energy_(energy_counter.getDynamicEnergyPJ())
-    , activity_time_(energy_counter.getActivityTime()) {}
+    , activity_time_(energy_counter.getActivityTime())
+    , dynamic_activity_(energy_counter.getDynamicActivity())
+    , untracked_energy_(energy_counter.getUntrackedEnergyPJ()) {
+    for (const auto& [name, unit_cnt] : energy_counter.getStaticActivity()) {
+        static_activity_.emplace(name, unit_cnt * EnergyCounter::getRunningTimeNS());
+    }
+}
+
+namespace {
+
+void addActivity(std::map<std::string, double>& activity, const std::map<std::string, double>& another) {
+    for (const auto& [name, value] : another) {
+        activity[name] += value;
+    }
+}
+
+double getActivityEnergyPJ(const std::map<std::string, double>& activity, const std::map<std::string, double>& power) {
+    double energy = 0.0;
+    for (const auto& [name, value] : activity) {
+        energy += power.at(name) * value;
+    }
+    return energy;
+}
+
+}  // namespace
 
 void EnergyReporter::addSubModule(std::string name, EnergyReporter sub_module) {
     total_energy_ += sub_module.total_energy_;
     static_energy_ += sub_module.static_energy_;
     dynamic_energy_ += sub_module.dynamic_energy_;
     activity_time_ += sub_module.activity_time_;
+    addActivity(static_activity_, sub_module.static_activity_);
+    addActivity(dynamic_activity_, sub_module.dynamic_activity_);
+    untracked_energy_ += sub_module.untracked_energy_;
     if (auto sub_module_found = sub_modules_.find(name); sub_module_found != sub_modules_.end()) {
         sub_module_found->second.accumulate(sub_module, true);
     } else {
@@ -146,6 +175,9 @@ void EnergyReporter::accumulate(const EnergyReporter& another, bool same_simulat
     } else {
         activity_time_ += another.activity_time_;
     }
+    addActivity(static_activity_, another.static_activity_);
+    addActivity(dynamic_activity_, another.dynamic_activity_);
+    untracked_energy_ += another.untracked_energy_;
 
     for (auto& [name, sub_module] : another.sub_modules_) {
         if (auto sub_module_found = sub_modules_.find(name); sub_module_found != sub_modules_.end()) {
@@ -156,6 +188,50 @@ void EnergyReporter::accumulate(const EnergyReporter& another, bool same_simulat
     }
 }
 
+EnergyReporter EnergyReporter::recost(const std::map<std::string, double>& old_power,
+                                     const std::map<std::string, double>& new_power) const {
+    EnergyReporter r = *this;
+    r.static_energy_ += getActivityEnergyPJ(static_activity_, new_power) -
+                        getActivityEnergyPJ(static_activity_, old_power);
+    r.dynamic_energy_ += getActivityEnergyPJ(dynamic_activity_, new_power) -
+                         getActivityEnergyPJ(dynamic_activity_, old_power);
+    r.total_energy_ = r.static_energy_ + r.dynamic_energy_;
+    for (auto& [name, sub_module] : r.sub_modules_) {
+        sub_module = sub_module.recost(old_power, new_power);
+    }
+    return std::move(r);
+}
+
+const std::map<std::string, double>& EnergyReporter::getStaticActivity() const {
+    return static_activity_;
+}
+
+const std::map<std::string, double>& EnergyReporter::getDynamicActivity() const {
+    return dynamic_activity_;
+}
+
+double EnergyReporter::getUntrackedEnergyPJ() const {
+    return untracked_energy_;
+}
+
+void EnergyReporter::addDynamicDifference(const EnergyReporter& from, const EnergyReporter& to, double times) {
+    double dynamic_energy = (to.dynamic_energy_ - from.dynamic_energy_) * times;
+    dynamic_energy_ += dynamic_energy;
+    total_energy_ += dynamic_energy;
+    activity_time_ += (to.activity_time_ - from.activity_time_) * times;
+    for (const auto& [name, value] : to.dynamic_activity_) {
+        auto found = from.dynamic_activity_.find(name);
+        dynamic_activity_[name] += (value - (found == from.dynamic_activity_.end() ? 0.0 : found->second)) * times;
+    }
+
+    const EnergyReporter empty_module{};
+    for (const auto& [name, to_sub_module] : to.sub_modules_) {
+        auto found = from.sub_modules_.find(name);
+        sub_modules_[name].addDynamicDifference(found == from.sub_modules_.end() ? empty_module : found->second,
+                                                to_sub_module, times);
+    }
+}
+
 Reporter::Reporter(double latency_ms, std::string module_name, const EnergyReporter& energy_reporter, int OP_count)
     : latency_(latency_ms)
     , total_energy_(energy_reporter.getTotalEnergyPJ())
@@ -175,6 +251,7 @@ void Reporter::report(std::ostream& os, bool detail) {
     os << fmt::format("  - {:<20}{:.4f}\n", "TOPS:", TOPS_);
     os << fmt::format("  - {:<20}{:.4f}\n", "TOPS/W:", TOPS_per_W_);
     os << fmt::format("  - {:<20}{}\n", "OP_count:", OP_count_);
+    os << fmt::format("  - {:<20}{}\n", "payload allocs:", payload_allocation_cnt_);
 
     if (detail) {
         auto energy_report_items = energy_reporter_.getEnergyReportItem(module_name_, total_energy_, latency_ * 1e6, 0);
@@ -199,6 +276,55 @@ void Reporter::report(std::ostream& os, bool detail) {
             os << fmt::format("    {:<{}}", dynamic_energy, dynamic_width);
             os << fmt::format("    {:<{}}\n", activity_time, activity_width);
         }
+
+        if (!memory_bank_reports_.empty()) {
+            os << "Memory bank report:\n";
+            double total_latency = latency_ * 1e6;
+            auto print_utilization = [&](const char* title, const std::vector<double>& busy_time_list) {
+                os << fmt::format("      - {:<20}", title);
+                for (double busy_time : busy_time_list) {
+                    os << fmt::format("{:.2f}% ", total_latency == 0.0 ? 0.0 : busy_time / total_latency * 100);
+                }
+                os << "\n";
+            };
+            for (const auto& memory : memory_bank_reports_) {
+                os << fmt::format("    {}\n", memory.name);
+                os << fmt::format("      - {:<20}{}\n", "bank conflicts:", memory.bank_conflict_cnt);
+                os << fmt::format("      - {:<20}{:.4f} ns\n", "bank stall time:", memory.bank_stall_time);
+                print_utilization("bank utilization:", memory.bank_busy_time);
+                if (memory.row_access_cnt > 0) {
+                    os << fmt::format("      - {:<20}{:.2f}%\n", "row hit rate:",
+                                      100.0 * memory.row_hit_cnt / memory.row_access_cnt);
+                }
+                if (!memory.channel_busy_time.empty()) {
+                    print_utilization("channel utilization:", memory.channel_busy_time);
+                }
+            }
+        }
+
+        if (!network_link_reports_.empty()) {
+            os << "Network link report:\n";
+            double total_latency = latency_ * 1e6;
+            for (const auto& link : network_link_reports_) {
+                os << fmt::format("    {:<32}{:.2f}% busy, {} flits, {:.4f} ns stall\n", link.name,
+                                  total_latency == 0.0 ? 0.0 : link.busy_time / total_latency * 100, link.flit_cnt,
+                                  link.stall_time);
+            }
+        }
+
+        if (!memory_queue_reports_.empty()) {
+            os << "Memory queue report:\n";
+            double total_latency = latency_ * 1e6;
+            for (const auto& memory : memory_queue_reports_) {
+                os << fmt::format("    {}\n", memory.name);
+                os << fmt::format("      - {:<20}{}\n", "requests:", memory.request_cnt);
+                os << fmt::format("      - {:<20}{}\n", "max queue depth:", memory.max_queue_depth);
+                os << fmt::format("      - {:<20}{:.4f}\n", "avg queue depth:",
+                                  total_latency == 0.0 ? 0.0 : memory.queue_depth_time / total_latency);
+                os << fmt::format("      - {:<20}{:.4f} ns\n", "avg wait time:",
+                                  memory.request_cnt == 0 ? 0.0 : memory.wait_time / memory.request_cnt);
+            }
+        }
     }
 }
 
@@ -222,6 +348,51 @@ Reporter& Reporter::operator+=(const Reporter& another) {
     latency_ += another.latency_;
     total_energy_ += another.total_energy_;
     OP_count_ += another.OP_count_;
+    payload_allocation_cnt_ += another.payload_allocation_cnt_;
+    for (const auto& another_memory : another.memory_bank_reports_) {
+        auto found = std::find_if(memory_bank_reports_.begin(), memory_bank_reports_.end(),
+                                  [&](const MemoryBankReport& memory) { return memory.name == another_memory.name; });
+        if (found == memory_bank_reports_.end()) {
+            memory_bank_reports_.push_back(another_memory);
+            continue;
+        }
+        found->bank_conflict_cnt += another_memory.bank_conflict_cnt;
+        found->bank_stall_time += another_memory.bank_stall_time;
+        found->bank_busy_time.resize(std::max(found->bank_busy_time.size(), another_memory.bank_busy_time.size()));
+        for (int i = 0; i < another_memory.bank_busy_time.size(); i++) {
+            found->bank_busy_time[i] += another_memory.bank_busy_time[i];
+        }
+        found->row_hit_cnt += another_memory.row_hit_cnt;
+        found->row_access_cnt += another_memory.row_access_cnt;
+        found->channel_busy_time.resize(
+            std::max(found->channel_busy_time.size(), another_memory.channel_busy_time.size()));
+        for (int i = 0; i < another_memory.channel_busy_time.size(); i++) {
+            found->channel_busy_time[i] += another_memory.channel_busy_time[i];
+        }
+    }
+    for (const auto& another_link : another.network_link_reports_) {
+        auto found = std::find_if(network_link_reports_.begin(), network_link_reports_.end(),
+                                  [&](const NetworkLinkReport& link) { return link.name == another_link.name; });
+        if (found == network_link_reports_.end()) {
+            network_link_reports_.push_back(another_link);
+            continue;
+        }
+        found->flit_cnt += another_link.flit_cnt;
+        found->busy_time += another_link.busy_time;
+        found->stall_time += another_link.stall_time;
+    }
+    for (const auto& another_memory : another.memory_queue_reports_) {
+        auto found = std::find_if(memory_queue_reports_.begin(), memory_queue_reports_.end(),
+                                  [&](const MemoryQueueReport& memory) { return memory.name == another_memory.name; });
+        if (found == memory_queue_reports_.end()) {
+            memory_queue_reports_.push_back(another_memory);
+            continue;
+        }
+        found->request_cnt += another_memory.request_cnt;
+        found->max_queue_depth = std::max(found->max_queue_depth, another_memory.max_queue_depth);
+        found->queue_depth_time += another_memory.queue_depth_time;
+        found->wait_time += another_memory.wait_time;
+    }
 
     average_power_ = (latency_ == 0.0 ? 0.0 : (total_energy_ / (latency_ * 1e6)));
     TOPS_ = (latency_ == 0.0 ? 0.0 : (1.0 * OP_count_ / (latency_ / 1e3) / TERA));
@@ -232,6 +403,20 @@ Reporter& Reporter::operator+=(const Reporter& another) {
     return *this;
 }
 
+Reporter Reporter::recost(const std::map<std::string, double>& old_power,
+                          const std::map<std::string, double>& new_power) const {
+    Reporter r = *this;
+    r.energy_reporter_ = energy_reporter_.recost(old_power, new_power);
+    r.total_energy_ = r.energy_reporter_.getTotalEnergyPJ();
+    r.average_power_ = (latency_ == 0.0 ? 0.0 : (r.total_energy_ / (latency_ * 1e6)));
+    r.TOPS_per_W_ = (r.average_power_ == 0.0 ? 0.0 : (TOPS_ / (r.average_power_ / 1e3)));
+    return std::move(r);
+}
+
+const EnergyReporter& Reporter::getEnergyReporter() const {
+    return energy_reporter_;
+}
+
 EnergyReporterCompare EnergyReporter::compare(const EnergyReporter& r2) const {
     EnergyReporterCompare c;
 
@@ -287,6 +472,26 @@ void Reporter::setOPCount(double OP_count) {
     this->TOPS_per_W_ = (average_power_ == 0.0 ? 0.0 : (TOPS_ / (average_power_ / 1e3)));
 }
 
+void Reporter::setPayloadAllocationCount(long long payload_allocation_cnt) {
+    payload_allocation_cnt_ = payload_allocation_cnt;
+}
+
+long long Reporter::getPayloadAllocationCount() const {
+    return payload_allocation_cnt_;
+}
+
+void Reporter::setMemoryBankReports(std::vector<MemoryBankReport> memory_bank_reports) {
+    memory_bank_reports_ = std::move(memory_bank_reports);
+}
+
+void Reporter::setNetworkLinkReports(std::vector<NetworkLinkReport> network_link_reports) {
+    network_link_reports_ = std::move(network_link_reports);
+}
+
+void Reporter::setMemoryQueueReports(std::vector<MemoryQueueReport> memory_queue_reports) {
+    memory_queue_reports_ = std::move(memory_queue_reports);
+}
+
 #undef MAX
 
 }  // namespace pimsim
@@ -64,6 +64,18 @@ public:
 
     [[nodiscard]] EnergyReporterCompare compare(const EnergyReporter& r2) const;
 
+    // recomputes the energy with the power parameters changed from 'old_power' to 'new_power', by parameter name.
+    // activity time and the energy not booked against a power parameter are kept
+    [[nodiscard]] EnergyReporter recost(const std::map<std::string, double>& old_power,
+                                        const std::map<std::string, double>& new_power) const;
+    [[nodiscard]] const std::map<std::string, double>& getStaticActivity() const;
+    [[nodiscard]] const std::map<std::string, double>& getDynamicActivity() const;
+    [[nodiscard]] double getUntrackedEnergyPJ() const;
+
+    // adds 'times' times the dynamic energy and activity that 'to' has more than 'from', for simulation skipped by
+    // fast-forwarding. static energy is left out since it follows the running time
+    void addDynamicDifference(const EnergyReporter& from, const EnergyReporter& to, double times);
+
 private:
     double total_energy_{0.0};    // pJ
     double static_energy_{0.0};   // pJ
@@ -72,8 +84,53 @@ private:
 
     std::map<std::string, EnergyReporter> sub_modules_;
 
+    // recorded activity of this module and its sub modules by power parameter name, so that the energy of a
+    // parameter is its power (mW) times its activity (ns). static activity is unit count * running time.
+    std::map<std::string, double> static_activity_;
+    std::map<std::string, double> dynamic_activity_;
+    double untracked_energy_{0.0};  // pJ
+
     NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(EnergyReporter, total_energy_, static_energy_, dynamic_energy_,
-                                                activity_time_, sub_modules_)
+                                                activity_time_, sub_modules_, static_activity_, dynamic_activity_,
+                                                untracked_energy_)
+};
+
+// bank statistics of a banked memory, see Memory
+struct MemoryBankReport {
+    std::string name;
+    int bank_conflict_cnt{0};            // accesses that waited for a bank held by another access
+    double bank_stall_time{0.0};         // ns, summed over the accesses
+    std::vector<double> bank_busy_time;  // ns, by bank
+
+    // dram only, see DRAM
+    int row_hit_cnt{0};
+    int row_access_cnt{0};
+    std::vector<double> channel_busy_time;  // ns, by channel
+
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(MemoryBankReport, name, bank_conflict_cnt, bank_stall_time,
+                                                bank_busy_time, row_hit_cnt, row_access_cnt, channel_busy_time)
+};
+
+// traffic of a network link, see Mesh
+struct NetworkLinkReport {
+    std::string name;
+    long long flit_cnt{0};
+    double busy_time{0.0};   // ns
+    double stall_time{0.0};  // ns, waited by the messages for the link, summed over the messages
+
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(NetworkLinkReport, name, flit_cnt, busy_time, stall_time)
+};
+
+// the requests waiting in the input queue of a memory for a service engine, see GlobalMemory
+struct MemoryQueueReport {
+    std::string name;
+    long long request_cnt{0};
+    int max_queue_depth{0};
+    double queue_depth_time{0.0};  // ns, the queue depth integrated over time
+    double wait_time{0.0};         // ns, summed over the requests
+
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(MemoryQueueReport, name, request_cnt, max_queue_depth, queue_depth_time,
+                                                wait_time)
 };
 
 class Reporter {
@@ -96,6 +153,19 @@ public:
 
     void setOPCount(double OP_count);
 
+    // heap allocations of the payload pools, see PayloadPool
+    void setPayloadAllocationCount(long long payload_allocation_cnt);
+    [[nodiscard]] long long getPayloadAllocationCount() const;
+
+    void setMemoryBankReports(std::vector<MemoryBankReport> memory_bank_reports);
+    void setNetworkLinkReports(std::vector<NetworkLinkReport> network_link_reports);
+    void setMemoryQueueReports(std::vector<MemoryQueueReport> memory_queue_reports);
+
+    // the same report with the power parameters changed, see EnergyReporter::recost
+    [[nodiscard]] Reporter recost(const std::map<std::string, double>& old_power,
+                                  const std::map<std::string, double>& new_power) const;
+    [[nodiscard]] const EnergyReporter& getEnergyReporter() const;
+
 private:
     double latency_{0.0};        // ms
     double average_power_{0.0};  // mW
@@ -103,12 +173,17 @@ private:
     double TOPS_{0.0};
     double TOPS_per_W_{0.0};
     int OP_count_{0};
+    long long payload_allocation_cnt_{0};
 
     std::string module_name_;
     EnergyReporter energy_reporter_;
+    std::vector<MemoryBankReport> memory_bank_reports_;
+    std::vector<NetworkLinkReport> network_link_reports_;
+    std::vector<MemoryQueueReport> memory_queue_reports_;
 
     NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(Reporter, latency_, average_power_, total_energy_, TOPS_, TOPS_per_W_,
-                                                OP_count_, module_name_, energy_reporter_)
+                                                OP_count_, payload_allocation_cnt_, module_name_, energy_reporter_,
+                                                memory_bank_reports_, network_link_reports_, memory_queue_reports_)
 };
 
 }  // namespace pimsim
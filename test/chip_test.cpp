@@ -2,11 +2,16 @@
 // Created by wyk on 2024/11/11.
 //
 
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <sstream>
 #include <vector>
 
 #include "base/test_macro.h"
 #include "base/test_payload.h"
-#include "chip/chip.h"
+#include "chip/parallel_chip.h"
 #include "config/config.h"
 #include "fmt/format.h"
 #include "isa/instruction.h"
@@ -18,9 +23,76 @@ namespace pimsim {
 struct ChipTestInfo {
     std::vector<std::vector<Instruction>> code;
     TestExpectedInfo expected;
+    // for a parallel config, the chip is simulated in one partition as well and the results must be the same
+    bool compare_sequential{false};
+    // the cores are fast-forwarded to the target, the expected result is of the rest of the run, and the final core
+    // states must be the same as those of a detailed run from the start
+    bool fast_forward{false};
+    FastForwardTarget fast_forward_target{};
 };
 
-DEFINE_TYPE_FROM_TO_JSON_FUNCTION_WITH_DEFAULT(ChipTestInfo, code, expected);
+DEFINE_TYPE_FROM_TO_JSON_FUNCTION_WITH_DEFAULT(ChipTestInfo, code, expected, compare_sequential, fast_forward,
+                                               fast_forward_target);
+
+// a SystemC kernel runs only once in a process, so the detailed run goes in a forked process, before this one starts
+// its own simulation, and sends the core states back through a pipe
+bool runDetailedAndGetCoreStates(const Config& config, const std::vector<std::vector<Instruction>>& code,
+                                 std::vector<CoreState>& core_states) {
+    int state_pipe[2];
+    if (pipe(state_pipe) != 0) {
+        return false;
+    }
+    std::cout.flush();
+    int pid = fork();
+    if (pid < 0) {
+        close(state_pipe[0]);
+        close(state_pipe[1]);
+        return false;
+    }
+    if (pid == 0) {
+        close(state_pipe[0]);
+        int exit_code = EXIT_SUCCESS;
+        try {
+            ParallelChip chip{"Chip", config, code};
+            chip.run();
+            auto state_str = nlohmann::ordered_json(chip.getCoreStates()).dump();
+            for (std::size_t written = 0; written < state_str.size();) {
+                auto cnt = write(state_pipe[1], state_str.data() + written, state_str.size() - written);
+                if (cnt < 0) {
+                    exit_code = EXIT_FAILURE;
+                    break;
+                }
+                written += cnt;
+            }
+        } catch (const std::exception& e) {
+            std::cerr << fmt::format("Detailed run failed, {}", e.what()) << std::endl;
+            exit_code = EXIT_FAILURE;
+        }
+        close(state_pipe[1]);
+        std::cout.flush();
+        _exit(exit_code);
+    }
+
+    close(state_pipe[1]);
+    std::string state_str;
+    char buffer[4096];
+    for (ssize_t cnt; (cnt = read(state_pipe[0], buffer, sizeof(buffer))) != 0;) {
+        if (cnt < 0 && errno != EINTR) {
+            break;
+        }
+        if (cnt > 0) {
+            state_str.append(buffer, cnt);
+        }
+    }
+    close(state_pipe[0]);
+
+    int status;
+    if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+        return false;
+    }
+    core_states = nlohmann::ordered_json::parse(state_str).get<std::vector<CoreState>>();
+    return true;
+}
 
 }  // namespace pimsim
 
@@ -56,15 +128,60 @@ int sc_main(int argc, char* argv[]) {
     ins_ifs.close();
     auto test_info = ins_j.get<ChipTestInfo>();
 
-    Chip chip{"Chip", config, test_info.code};
-    sc_start();
+    ParallelChip chip{"Chip", config, test_info.code};
+    if (!chip.checkValid()) {
+        std::cout << "Config not valid" << std::endl;
+        return INVALID_CONFIG;
+    }
+
+    std::vector<CoreState> detailed_core_states;
+    if (test_info.fast_forward) {
+        if (!runDetailedAndGetCoreStates(config, test_info.code, detailed_core_states)) {
+            std::cout << "Detailed run failed" << std::endl;
+            return TEST_FAILED;
+        }
+        chip.setFastForwardTarget(test_info.fast_forward_target);
+    }
+    chip.run();
+
+    bool same_core_states = !test_info.fast_forward || chip.getCoreStates() == detailed_core_states;
+    if (!same_core_states) {
+        std::cout << "Core states of the fast-forwarded run differ from the detailed run" << std::endl;
+    }
 
     std::ofstream ofs;
     ofs.open(report_file);
     auto reporter = chip.report(ofs);
     ofs.close();
 
-    if (DoubleEqual(reporter.getLatencyNs(), test_info.expected.time_ns) &&
+    // the partitions run in forked processes, so the kernel of this process is still free for the sequential run
+    bool same_as_sequential = true;
+    if (test_info.compare_sequential && config.sim_config.parallel_partition_cnt > 1) {
+        auto sequential_config = config;
+        sequential_config.sim_config.parallel_partition_cnt = 1;
+        ParallelChip sequential_chip{"Chip", sequential_config, test_info.code};
+        if (test_info.fast_forward) {
+            sequential_chip.setFastForwardTarget(test_info.fast_forward_target);
+        }
+        sequential_chip.run();
+        if (test_info.fast_forward && sequential_chip.getCoreStates() != detailed_core_states) {
+            std::cout << "Core states of the fast-forwarded sequential run differ from the detailed run" << std::endl;
+            same_core_states = false;
+        }
+
+        std::ostringstream sequential_os;
+        auto sequential_reporter = sequential_chip.report(sequential_os);
+        same_as_sequential = reporter.getLatencyNs() == sequential_reporter.getLatencyNs() &&
+                             reporter.getDynamicEnergyPJ() == sequential_reporter.getDynamicEnergyPJ();
+        if (!same_as_sequential) {
+            std::cout << fmt::format("Parallel result {}ns {}pJ differs from sequential result {}ns {}pJ",
+                                     reporter.getLatencyNs(), reporter.getDynamicEnergyPJ(),
+                                     sequential_reporter.getLatencyNs(), sequential_reporter.getDynamicEnergyPJ())
+                      << std::endl;
+        }
+    }
+
+    if (same_core_states && same_as_sequential && DoubleEqual(reporter.getLatencyNs(), test_info.expected.time_ns) &&
         DoubleEqual(reporter.getDynamicEnergyPJ(), test_info.expected.energy_pj)) {
         std::cout << "Test Pass" << std::endl;
         return TEST_PASSED;
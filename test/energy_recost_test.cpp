@@ -0,0 +1,153 @@
+//
+// Created by wyk on 2024/11/14.
+//
+
+#include <fstream>
+#include <vector>
+
+#include "base/test_macro.h"
+#include "base/test_payload.h"
+#include "base_component/energy_counter.h"
+#include "chip/parallel_chip.h"
+#include "config/config.h"
+#include "fmt/format.h"
+#include "isa/instruction.h"
+#include "simulator/energy_activity.h"
+#include "systemc.h"
+#include "util/util.h"
+
+namespace pimsim {
+
+struct EnergyRecostTestInfo {
+    std::vector<std::vector<Instruction>> code;
+    TestExpectedInfo expected;
+};
+
+DEFINE_TYPE_FROM_TO_JSON_FUNCTION_WITH_DEFAULT(EnergyRecostTestInfo, code, expected);
+
+// "a.b[1].c" as in Config::getPowerParameterNames to the JSON pointer "/a/b/1/c"
+nlohmann::ordered_json::json_pointer getJsonPointer(const std::string& path) {
+    std::string pointer = "/";
+    for (char c : path) {
+        if (c == '.' || c == '[') {
+            pointer += '/';
+        } else if (c != ']') {
+            pointer += c;
+        }
+    }
+    return nlohmann::ordered_json::json_pointer{pointer};
+}
+
+bool recostWithConfig(const std::string& config_file, const nlohmann::ordered_json& config_j,
+                      const EnergyActivity& activity, Reporter& reporter) {
+    std::ofstream ofs(config_file);
+    ofs << config_j.dump(2);
+    ofs.close();
+
+    Config config;
+    return readRecostConfigFile(config_file, activity, config) && recostEnergy(activity, config, reporter);
+}
+
+}  // namespace pimsim
+
+using namespace pimsim;
+
+// Simulates a chip test case with the energy activity recorded, then recosts it with the same config, with a config
+// whose power parameters are all doubled and with a config whose timing is changed, which must be rejected.
+int sc_main(int argc, char* argv[]) {
+    sc_core::sc_report_handler::set_actions(sc_core::SC_WARNING, sc_core::SC_DO_NOTHING);
+
+    std::string exec_file_name{argv[0]};
+    if (argc != 4) {
+        std::cout << fmt::format("Usage: {} [config_file] [instruction_file] [report_file]", exec_file_name)
+                  << std::endl;
+        return INVALID_USAGE;
+    }
+
+    auto* config_file = argv[1];
+    auto* instruction_file = argv[2];
+    std::string report_file{argv[3]};
+
+    std::ifstream config_ifs;
+    config_ifs.open(config_file);
+    nlohmann::ordered_json config_j = nlohmann::ordered_json::parse(config_ifs);
+    config_ifs.close();
+    auto config = config_j.get<Config>();
+    if (!config.checkValid()) {
+        std::cout << "Config not valid" << std::endl;
+        return INVALID_CONFIG;
+    }
+    EnergyCounter::setPowerParameterNames(config.getPowerParameterNames());
+
+    std::ifstream ins_ifs;
+    ins_ifs.open(instruction_file);
+    nlohmann::ordered_json ins_j = nlohmann::ordered_json::parse(ins_ifs);
+    ins_ifs.close();
+    auto test_info = ins_j.get<EnergyRecostTestInfo>();
+
+    ParallelChip chip{"Chip", config, test_info.code};
+    if (!chip.checkValid()) {
+        std::cout << "Config not valid" << std::endl;
+        return INVALID_CONFIG;
+    }
+    chip.run();
+
+    std::ofstream ofs;
+    ofs.open(report_file);
+    auto reporter = chip.report(ofs);
+    ofs.close();
+
+    auto activity_file = report_file + ".activity.json";
+    EnergyActivity activity;
+    if (!writeEnergyActivityFile(activity_file, config, reporter) || !readEnergyActivityFile(activity_file, activity)) {
+        std::cout << "Test Failed" << std::endl;
+        return TEST_FAILED;
+    }
+
+    Reporter same_reporter;
+    bool same_passed = recostWithConfig(report_file + ".same.json", config_j, activity, same_reporter) &&
+                       DoubleEqual(same_reporter.getTotalEnergyPJ(), reporter.getTotalEnergyPJ()) &&
+                       DoubleEqual(same_reporter.getDynamicEnergyPJ(), test_info.expected.energy_pj);
+    if (!same_passed) {
+        std::cout << "Recosting with the recorded config does not reproduce the recorded energy" << std::endl;
+    }
+
+    // the energy not booked against a power parameter is kept as recorded
+    auto power_config_j = config_j;
+    for (const auto& [power, name] : config.getPowerParameterNames()) {
+        auto pointer = getJsonPointer(name);
+        if (power_config_j.contains(pointer)) {
+            power_config_j[pointer] = 2 * (*power);
+        }
+    }
+    Reporter power_reporter;
+    auto untracked_energy = reporter.getEnergyReporter().getUntrackedEnergyPJ();
+    bool power_passed =
+        recostWithConfig(report_file + ".power.json", power_config_j, activity, power_reporter) &&
+        DoubleEqual(power_reporter.getTotalEnergyPJ(), 2 * reporter.getTotalEnergyPJ() - untracked_energy) &&
+        DoubleEqual(power_reporter.getLatencyNs(), reporter.getLatencyNs());
+    if (!power_passed) {
+        std::cout << fmt::format("Recosting with doubled power gives {}pJ, expected {}pJ",
+                                 power_reporter.getTotalEnergyPJ(),
+                                 2 * reporter.getTotalEnergyPJ() - untracked_energy)
+                  << std::endl;
+    }
+
+    auto timing_config_j = config_j;
+    auto latency_pointer = getJsonPointer("chip_config.global_memory_config.hardware_config.read_latency_cycle");
+    timing_config_j[latency_pointer] = timing_config_j[latency_pointer].get<int>() + 1;
+    Reporter timing_reporter;
+    bool timing_passed = !recostWithConfig(report_file + ".timing.json", timing_config_j, activity, timing_reporter);
+    if (!timing_passed) {
+        std::cout << "Recosting with a changed read latency is not rejected" << std::endl;
+    }
+
+    if (same_passed && power_passed && timing_passed &&
+        DoubleEqual(reporter.getLatencyNs(), test_info.expected.time_ns)) {
+        std::cout << "Test Pass" << std::endl;
+        return TEST_PASSED;
+    } else {
+        std::cout << "Test Failed" << std::endl;
+        return TEST_FAILED;
+    }
+}
@@ -41,9 +41,8 @@ public:
         int src_memory_id = local_memory_unit_.getLocalMemoryIdByAddress(ins_payload.src_address_byte);
         int dst_memory_id = local_memory_unit_.getLocalMemoryIdByAddress(ins_payload.dst_address_byte);
 
-        conflict_payload.read_memory_id.insert(src_memory_id);
-        conflict_payload.write_memory_id.insert(dst_memory_id);
-        conflict_payload.used_memory_id.insert({src_memory_id, dst_memory_id});
+        conflict_payload.addReadMemoryId(src_memory_id);
+        conflict_payload.addWriteMemoryId(dst_memory_id);
 
         return std::move(conflict_payload);
     }
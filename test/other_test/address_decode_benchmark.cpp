@@ -0,0 +1,82 @@
+//
+// Created by wyk on 2024/11/13.
+//
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "config/config.h"
+#include "core/local_memory_unit/address_decoder.h"
+#include "fmt/format.h"
+
+namespace pimsim {
+
+// the former linear scan of LocalMemoryUnit, kept here as the baseline of the benchmark
+int scanLocalMemoryIdByAddress(const std::vector<AddressSpaceConfig>& address_spaces, int address_byte) {
+    for (int i = 0; i < address_spaces.size(); i++) {
+        if (address_spaces[i].offset_byte <= address_byte && address_byte < address_spaces[i].end()) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+template <class Lookup>
+double benchmarkLookupNS(const std::vector<int>& addresses, int rounds, Lookup lookup) {
+    long long id_sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; round++) {
+        for (int address : addresses) {
+            id_sum += lookup(address);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    // keep the loop from being optimized away
+    if (id_sum == -1) {
+        std::cout << id_sum << std::endl;
+    }
+    return std::chrono::duration<double, std::nano>(end - start).count() / rounds / addresses.size();
+}
+
+}  // namespace pimsim
+
+using namespace pimsim;
+
+int sc_main(int argc, char* argv[]) {
+    const int rounds = argc > 1 ? std::stoi(argv[1]) : 1000;
+    const int local_memory_cnt = argc > 2 ? std::stoi(argv[2]) : 8;
+    const int lookup_cnt = 4096;
+
+    // back to back local memories of 64KB each
+    std::vector<AddressSpaceConfig> address_spaces;
+    for (int i = 0; i < local_memory_cnt; i++) {
+        address_spaces.push_back({.offset_byte = i * 65536, .size_byte = 65536});
+    }
+    AddressDecoder address_decoder{address_spaces};
+
+    std::mt19937 random_engine{0};
+    std::uniform_int_distribution<int> address_distribution{0, local_memory_cnt * 65536 - 1};
+    std::vector<int> addresses(lookup_cnt);
+    for (auto& address : addresses) {
+        address = address_distribution(random_engine);
+        if (address_decoder.getIndex(address) != scanLocalMemoryIdByAddress(address_spaces, address)) {
+            std::cerr << fmt::format("address {} decoded differently", address) << std::endl;
+            return 1;
+        }
+    }
+
+    double scan_ns = benchmarkLookupNS(
+        addresses, rounds, [&](int address) { return scanLocalMemoryIdByAddress(address_spaces, address); });
+    double decoder_ns =
+        benchmarkLookupNS(addresses, rounds, [&](int address) { return address_decoder.getIndex(address); });
+
+    std::cout << fmt::format("address decode with {} local memories, {} rounds of {} lookups\n", local_memory_cnt,
+                             rounds, lookup_cnt);
+    std::cout << fmt::format("  - {:<20}{:.2f} ns\n", "linear scan:", scan_ns);
+    std::cout << fmt::format("  - {:<20}{:.2f} ns\n", "decode table:", decoder_ns);
+    std::cout << fmt::format("  - {:<20}{:.2f}x\n", "speedup:", decoder_ns == 0.0 ? 0.0 : scan_ns / decoder_ns);
+    return 0;
+}
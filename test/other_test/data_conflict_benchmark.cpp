@@ -0,0 +1,112 @@
+//
+// Created by wyk on 2024/11/13.
+//
+
+#include <chrono>
+#include <iostream>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "core/payload/payload.h"
+#include "fmt/format.h"
+#include "util/util.h"
+
+namespace pimsim {
+
+// the former set based data conflict payload, kept here as the baseline of the benchmark
+struct SetDataConflictPayload {
+    ExecuteUnitType unit_type{ExecuteUnitType::none};
+    std::unordered_set<int> read_memory_id;
+    std::unordered_set<int> write_memory_id;
+    std::unordered_set<int> used_memory_id;
+    bool use_pim_unit{false};
+
+    void addReadMemoryId(int memory_id) {
+        read_memory_id.insert(memory_id);
+        used_memory_id.insert(memory_id);
+    }
+
+    void addWriteMemoryId(int memory_id) {
+        write_memory_id.insert(memory_id);
+        used_memory_id.insert(memory_id);
+    }
+
+    static bool checkDataConflict(const SetDataConflictPayload& ins, const SetDataConflictPayload& unit) {
+        bool has_unit_conflict = ins.unit_type == unit.unit_type;
+        bool memory_conflict = has_unit_conflict ? SetsIntersection(unit.write_memory_id, ins.read_memory_id)
+                                                 : SetsIntersection(unit.used_memory_id, ins.used_memory_id);
+        return memory_conflict || (!has_unit_conflict && ins.use_pim_unit && unit.use_pim_unit);
+    }
+
+    SetDataConflictPayload& operator+=(const SetDataConflictPayload& other) {
+        read_memory_id.insert(other.read_memory_id.begin(), other.read_memory_id.end());
+        write_memory_id.insert(other.write_memory_id.begin(), other.write_memory_id.end());
+        used_memory_id.insert(other.used_memory_id.begin(), other.used_memory_id.end());
+        use_pim_unit = (use_pim_unit || other.use_pim_unit);
+        unit_type = other.unit_type;
+        return *this;
+    }
+};
+
+// Runs what StallHandler::processUnitDataConflict does on every trigger: merge the conflict infos of all
+// instructions in flight in the unit, then check the decoded instruction against them.
+template <class Payload>
+double benchmarkStallCheckNS(const std::unordered_map<int, Payload>& unit_ins_map, const Payload& cur_ins,
+                             int rounds) {
+    int conflict_cnt = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; round++) {
+        Payload unit_info{};
+        for (const auto& [ins_id, ins_info] : unit_ins_map) {
+            unit_info += ins_info;
+        }
+        conflict_cnt += Payload::checkDataConflict(cur_ins, unit_info) ? 1 : 0;
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    // keep the loop from being optimized away
+    if (conflict_cnt < 0) {
+        std::cout << conflict_cnt << std::endl;
+    }
+    return std::chrono::duration<double, std::nano>(end - start).count() / rounds;
+}
+
+}  // namespace pimsim
+
+using namespace pimsim;
+
+int sc_main(int argc, char* argv[]) {
+    const int rounds = argc > 1 ? std::stoi(argv[1]) : 1000000;
+    const int in_flight_ins_cnt = 4;
+    const int local_memory_cnt = 8;
+
+    std::unordered_map<int, DataConflictPayload> mask_unit_ins_map;
+    std::unordered_map<int, SetDataConflictPayload> set_unit_ins_map;
+    for (int ins_id = 0; ins_id < in_flight_ins_cnt; ins_id++) {
+        DataConflictPayload mask_payload{.ins_id = ins_id, .unit_type = ExecuteUnitType::simd};
+        SetDataConflictPayload set_payload{.unit_type = ExecuteUnitType::simd};
+        for (int memory_id : {ins_id % local_memory_cnt, (ins_id + 1) % local_memory_cnt}) {
+            mask_payload.addReadMemoryId(memory_id);
+            set_payload.addReadMemoryId(memory_id);
+        }
+        mask_payload.addWriteMemoryId((ins_id + 2) % local_memory_cnt);
+        set_payload.addWriteMemoryId((ins_id + 2) % local_memory_cnt);
+        mask_unit_ins_map.emplace(ins_id, mask_payload);
+        set_unit_ins_map.emplace(ins_id, set_payload);
+    }
+
+    DataConflictPayload mask_cur_ins{.ins_id = in_flight_ins_cnt, .unit_type = ExecuteUnitType::simd};
+    SetDataConflictPayload set_cur_ins{.unit_type = ExecuteUnitType::simd};
+    mask_cur_ins.addReadMemoryId(local_memory_cnt - 1);
+    set_cur_ins.addReadMemoryId(local_memory_cnt - 1);
+
+    double set_ns = benchmarkStallCheckNS(set_unit_ins_map, set_cur_ins, rounds);
+    double mask_ns = benchmarkStallCheckNS(mask_unit_ins_map, mask_cur_ins, rounds);
+
+    std::cout << fmt::format("stall check with {} instructions in flight, {} rounds\n", in_flight_ins_cnt, rounds);
+    std::cout << fmt::format("  - {:<20}{:.2f} ns\n", "unordered_set:", set_ns);
+    std::cout << fmt::format("  - {:<20}{:.2f} ns\n", "bit mask:", mask_ns);
+    std::cout << fmt::format("  - {:<20}{:.2f}x\n", "speedup:", mask_ns == 0.0 ? 0.0 : set_ns / mask_ns);
+    return 0;
+}
@@ -0,0 +1,192 @@
+//
+// Created by wyk on 2024/11/13.
+//
+
+#include <algorithm>
+
+#include "../base/test_macro.h"
+#include "base_component/base_module.h"
+#include "config/config.h"
+#include "fmt/format.h"
+#include "memory/memory.h"
+#include "util/macro_scope.h"
+#include "util/util.h"
+
+namespace pimsim {
+
+struct MemoryTestAccess {
+    double time_ns{0.0};  // when the access comes to the memory
+    bool write{false};
+    int address_byte{0};  // inside the memory
+    int size_byte{0};
+
+    int memory_id{0};
+    std::vector<uint8_t> data{};  // written, or expected to be read if not empty
+};
+
+struct MemoryExpectedInfo {
+    double time_ns{0.0};
+    double energy_pj{0.0};
+
+    int bank_conflict_cnt{0};
+    double bank_stall_time{0.0};  // ns
+    int row_hit_cnt{0};
+    int row_access_cnt{0};
+};
+
+struct MemoryTestInfo {
+    std::vector<MemoryTestAccess> code{};
+    int memory_cnt{1};  // memories built from the same config, so they map the same image file
+    MemoryExpectedInfo expected{};
+};
+
+// drives the global memory of the config with accesses at given times
+class MemoryTestModule : public BaseModule {
+public:
+    SC_HAS_PROCESS(MemoryTestModule);
+
+    MemoryTestModule(const char* name, const Config& config, std::vector<MemoryTestAccess> codes, int memory_cnt)
+        : BaseModule(name, config.sim_config, nullptr, nullptr), access_list_(std::move(codes)) {
+        const auto& memory_config = config.chip_config.global_memory_config;
+        for (int memory_id = 0; memory_id < memory_cnt; memory_id++) {
+            auto memory_name = memory_id == 0 ? std::string{"memory"} : fmt::format("memory_{}", memory_id);
+            if (memory_config.type == +GlobalMemoryType::dram) {
+                memory_list_.push_back(std::make_shared<Memory>(memory_name.c_str(), memory_config.dram_config,
+                                                                memory_config.addressing, config.sim_config, nullptr,
+                                                                nullptr));
+            } else {
+                memory_list_.push_back(std::make_shared<Memory>(memory_name.c_str(), memory_config.hardware_config,
+                                                                memory_config.addressing, config.sim_config, nullptr,
+                                                                nullptr));
+            }
+        }
+
+        for (int i = 0; i < access_list_.size(); i++) {
+            sc_core::sc_spawn([this, i] { issue(i); }, fmt::format("access_{}", i).c_str());
+        }
+    }
+
+    EnergyReporter getEnergyReporter() override {
+        EnergyReporter reporter;
+        for (auto& memory : memory_list_) {
+            reporter.addSubModule(memory->getName(), memory->getEnergyReporter());
+        }
+        return std::move(reporter);
+    }
+
+    Reporter getReporter() {
+        EnergyCounter::setRunningTimeNS(running_time_);
+        Reporter reporter{running_time_.to_seconds() * 1e3, "MemoryTestModule", getEnergyReporter(), 0};
+        reporter.setMemoryBankReports({getBankReport()});
+        return std::move(reporter);
+    }
+
+    // of the first memory
+    [[nodiscard]] MemoryBankReport getBankReport() const {
+        return memory_list_.front()->getBankReport();
+    }
+
+    [[nodiscard]] bool isDataMatched() const {
+        return data_matched_;
+    }
+
+private:
+    void issue(int index) {
+        const auto& access = access_list_[index];
+        wait(access.time_ns, SC_NS);
+
+        sc_core::sc_event finish_access;
+        auto payload = std::make_shared<MemoryAccessPayload>(
+            MemoryAccessPayload{.ins = {.pc = index + 1},
+                                .access_type = access.write ? MemoryAccessType::write : MemoryAccessType::read,
+                                .address_byte = access.address_byte,
+                                .size_byte = access.size_byte,
+                                .finish_access = finish_access});
+        if (access.write) {
+            payload->data = {access.data.data(), static_cast<int>(access.data.size())};
+        }
+        memory_list_[access.memory_id]->access(payload);
+        wait(finish_access);
+
+        if (!access.write && !access.data.empty() &&
+            (payload->data.size_byte != static_cast<int>(access.data.size()) ||
+             !std::equal(access.data.begin(), access.data.end(), payload->data.data))) {
+            std::cout << fmt::format("Access {} reads data different from the expected", index + 1) << std::endl;
+            data_matched_ = false;
+        }
+
+        running_time_ = std::max(running_time_, sc_core::sc_time_stamp());
+    }
+
+private:
+    std::vector<MemoryTestAccess> access_list_;
+
+    std::vector<std::shared_ptr<Memory>> memory_list_;
+
+    sc_core::sc_time running_time_;
+    bool data_matched_{true};
+};
+
+DEFINE_TYPE_FROM_TO_JSON_FUNCTION_WITH_DEFAULT(MemoryTestAccess, time_ns, write, address_byte, size_byte, memory_id,
+                                               data)
+
+DEFINE_TYPE_FROM_TO_JSON_FUNCTION_WITH_DEFAULT(MemoryExpectedInfo, time_ns, energy_pj, bank_conflict_cnt,
+                                               bank_stall_time, row_hit_cnt, row_access_cnt)
+
+DEFINE_TYPE_FROM_TO_JSON_FUNCTION_WITH_DEFAULT(MemoryTestInfo, code, memory_cnt, expected)
+
+}  // namespace pimsim
+
+using namespace pimsim;
+
+int sc_main(int argc, char* argv[]) {
+    sc_core::sc_report_handler::set_actions(sc_core::SC_WARNING, sc_core::SC_DO_NOTHING);
+
+    if (argc != 4) {
+        std::cout << "Usage: ./MemoryTest [config_file] [instruction_file] [report_file]" << std::endl;
+        return INVALID_USAGE;
+    }
+
+    auto* config_file = argv[1];
+    auto* instruction_file = argv[2];
+    auto* report_file = argv[3];
+
+    std::ifstream config_ifs;
+    config_ifs.open(config_file);
+    nlohmann::ordered_json config_j = nlohmann::ordered_json::parse(config_ifs);
+    config_ifs.close();
+    auto config = config_j.get<Config>();
+    if (!config.checkValid()) {
+        std::cout << "Config not valid" << std::endl;
+        return INVALID_CONFIG;
+    }
+
+    std::ifstream ins_ifs;
+    ins_ifs.open(instruction_file);
+    nlohmann::ordered_json ins_j = nlohmann::ordered_json::parse(ins_ifs);
+    ins_ifs.close();
+    auto test_info = ins_j.get<MemoryTestInfo>();
+
+    MemoryTestModule test_module{"MemoryTestModule", config, std::move(test_info.code), test_info.memory_cnt};
+    sc_start();
+
+    std::ofstream ofs;
+    ofs.open(report_file);
+    auto reporter = test_module.getReporter();
+    reporter.report(ofs);
+    ofs.close();
+
+    const auto bank_report = test_module.getBankReport();
+    const auto& expected = test_info.expected;
+    if (test_module.isDataMatched() && DoubleEqual(reporter.getLatencyNs(), expected.time_ns) &&
+        DoubleEqual(reporter.getDynamicEnergyPJ(), expected.energy_pj) &&
+        bank_report.bank_conflict_cnt == expected.bank_conflict_cnt &&
+        DoubleEqual(bank_report.bank_stall_time, expected.bank_stall_time) &&
+        bank_report.row_hit_cnt == expected.row_hit_cnt && bank_report.row_access_cnt == expected.row_access_cnt) {
+        std::cout << "Test Pass" << std::endl;
+        return TEST_PASSED;
+    } else {
+        std::cout << "Test Failed" << std::endl;
+        return TEST_FAILED;
+    }
+}
@@ -0,0 +1,115 @@
+//
+// Created by wyk on 2024/11/13.
+//
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "config/config.h"
+#include "fmt/format.h"
+#include "network/network.h"
+#include "nlohmann/json.hpp"
+
+namespace pimsim {
+
+// the former nested maps of Network, kept here as the baseline of the benchmark
+using NestedTable = std::unordered_map<int, std::unordered_map<int, double>>;
+
+template <class Transfer>
+double benchmarkMessageNS(const std::vector<std::pair<int, int>>& messages, int rounds, Transfer transfer) {
+    double delay_sum = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; round++) {
+        for (const auto& [src_id, dst_id] : messages) {
+            delay_sum += transfer(src_id, dst_id);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    // keep the loop from being optimized away
+    if (delay_sum == -1.0) {
+        std::cout << delay_sum << std::endl;
+    }
+    return std::chrono::duration<double, std::nano>(end - start).count() / rounds / messages.size();
+}
+
+}  // namespace pimsim
+
+using namespace pimsim;
+
+int sc_main(int argc, char* argv[]) {
+    const int rounds = argc > 1 ? std::stoi(argv[1]) : 1000;
+    const int core_cnt = argc > 2 ? std::stoi(argv[2]) : 64;
+    const int message_cnt = 4096;
+    const int data_size_byte = 64;
+
+    // the cores and the global memory at switch -1, one hop per cycle on a line of switches
+    nlohmann::json j;
+    NestedTable latency_table, energy_table;
+    for (int src_id = -1; src_id < core_cnt; src_id++) {
+        for (int dst_id = -1; dst_id < core_cnt; dst_id++) {
+            double hop_cnt = std::abs(src_id - dst_id);
+            j["latency"][std::to_string(src_id)][std::to_string(dst_id)] = hop_cnt;
+            j["energy"][std::to_string(src_id)][std::to_string(dst_id)] = hop_cnt * 0.5;
+            latency_table[src_id][dst_id] = hop_cnt;
+            energy_table[src_id][dst_id] = hop_cnt * 0.5;
+        }
+    }
+    auto config_path = std::filesystem::temp_directory_path() /
+                       fmt::format("network_benchmark_config_{}.json", std::random_device{}());
+    NetworkConfig network_config{.network_config_file_path = config_path.string()};
+    {
+        std::ofstream ofs(network_config.network_config_file_path);
+        ofs << j;
+    }
+    SimConfig sim_config{};
+    auto read_start = std::chrono::steady_clock::now();
+    Network network{"Network", network_config, sim_config};
+    auto read_end = std::chrono::steady_clock::now();
+    std::filesystem::remove(config_path);
+
+    // tables for as many switches generated at startup from a line of routers, only to time the generation. their
+    // latencies follow the mesh, '(hop_cnt + 1) * router_pipeline_cycle + hop_cnt * link_latency_cycle + 1' with the
+    // global memory on router 0, not the hop counts of the tables above
+    NetworkConfig generated_network_config{.generate_table = true,
+                                           .mesh_config = {.x_cnt = core_cnt, .y_cnt = 1, .link_latency_cycle = 0}};
+    auto generate_start = std::chrono::steady_clock::now();
+    Network generated_network{"GeneratedNetwork", generated_network_config, sim_config};
+    auto generate_end = std::chrono::steady_clock::now();
+
+    std::mt19937 random_engine{0};
+    std::uniform_int_distribution<int> id_distribution{-1, core_cnt - 1};
+    std::vector<std::pair<int, int>> messages(message_cnt);
+    for (auto& [src_id, dst_id] : messages) {
+        src_id = id_distribution(random_engine);
+        dst_id = id_distribution(random_engine);
+    }
+
+    const int flit_cnt = (data_size_byte + network_config.bus_width_byte - 1) / network_config.bus_width_byte;
+    double energy_pj = 0.0;
+    double nested_ns = benchmarkMessageNS(messages, rounds, [&](int src_id, int dst_id) {
+        energy_pj += flit_cnt * energy_table[src_id][dst_id];
+        return flit_cnt * latency_table[src_id][dst_id] * sim_config.period_ns;
+    });
+    double matrix_ns = benchmarkMessageNS(messages, rounds, [&](int src_id, int dst_id) {
+        return network.transferAndGetDelay(src_id, dst_id, data_size_byte).to_seconds();
+    });
+
+    std::cout << fmt::format("network transfer between {} switches, {} rounds of {} messages\n", core_cnt + 1, rounds,
+                             message_cnt);
+    std::cout << fmt::format("  - {:<20}{:.2f} ns/message\n", "nested maps:", nested_ns);
+    std::cout << fmt::format("  - {:<20}{:.2f} ns/message\n", "dense matrices:", matrix_ns);
+    std::cout << fmt::format("  - {:<20}{:.2f}x\n", "speedup:", matrix_ns == 0.0 ? 0.0 : nested_ns / matrix_ns);
+    std::cout << fmt::format("  - {:<20}{:.2f} ms\n", "read tables:",
+                             std::chrono::duration<double, std::milli>(read_end - read_start).count());
+    std::cout << fmt::format("  - {:<20}{:.2f} ms\n", "generate tables:",
+                             std::chrono::duration<double, std::milli>(generate_end - generate_start).count());
+    return energy_pj < 0.0 ? 1 : 0;
+}
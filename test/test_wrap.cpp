@@ -23,11 +23,13 @@ namespace pimsim {
 struct UnitTestCaseConfig {
     std::string comments{};
     std::string config_file;
+    // a JSON merge patch applied to the config file, so that a case can change a few fields of a shared config
+    nlohmann::json config_override{};
     std::string instruction_file;
     std::string report_file;
 
-    NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(UnitTestCaseConfig, comments, config_file, instruction_file,
-                                                report_file)
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(UnitTestCaseConfig, comments, config_file, config_override,
+                                                instruction_file, report_file)
 };
 
 struct UnitTestConfig {
@@ -44,6 +46,27 @@ struct TestConfig {
     NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(TestConfig, root_dir, unit_test_list)
 };
 
+// the config file of a test case, with its override applied and written next to the report file if it has one
+std::string getTestCaseConfigFile(const std::string& root_dir, const UnitTestCaseConfig& test_case_config) {
+    auto config_file = fmt::format("{}/{}", root_dir, test_case_config.config_file);
+    if (test_case_config.config_override.is_null()) {
+        return config_file;
+    }
+
+    std::ifstream ifs;
+    ifs.open(config_file);
+    auto config_j = nlohmann::json::parse(ifs);
+    ifs.close();
+    config_j.merge_patch(test_case_config.config_override);
+
+    auto override_config_file = fmt::format("{}/{}.config.json", root_dir, test_case_config.report_file);
+    std::ofstream ofs;
+    ofs.open(override_config_file);
+    ofs << config_j.dump(2);
+    ofs.close();
+    return override_config_file;
+}
+
 void unit_test(const std::string& root_dir, const UnitTestConfig& unit_test_config, bool& all_tests_passed) {
     std::cout << fmt::format("\tStart {}", unit_test_config.name) << std::endl;
 
@@ -51,7 +74,7 @@ void unit_test(const std::string& root_dir, const UnitTestConfig& unit_test_conf
         const auto& test_case_config = unit_test_config.test_cases[i];
         std::cout << fmt::format("\t\tStart test case {}: {}\n\t\t\t", i + 1, test_case_config.comments);
 
-        auto config_file = fmt::format("{}/{}", root_dir, test_case_config.config_file);
+        auto config_file = getTestCaseConfigFile(root_dir, test_case_config);
         auto instruction_file = fmt::format("{}/{}", root_dir, test_case_config.instruction_file);
         auto report_file = fmt::format("{}/{}", root_dir, test_case_config.report_file);
 